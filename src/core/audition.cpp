@@ -0,0 +1,459 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
+#include <list>
+#include <deque>
+#include <algorithm>
+#include <sndfile.h>
+#include "utils/log.h"
+#include "core/const.h"
+#include "core/types.h"
+#include "core/audioBuffer.h"
+#include "core/ringBuffer.h"
+#include "audition.h"
+
+
+namespace giada {
+namespace m {
+namespace audition
+{
+namespace
+{
+/* Head
+The first G_AUDITION_HEAD_MS of an audio file, already decoded. Samples are 
+interleaved, with at most two channels. */
+
+struct Head
+{
+	int                channels;
+	int                rate;
+	Frame              frames;
+	bool               complete; // The whole file fits in the head
+	std::vector<float> data;
+};
+
+
+/* Voice
+An audition in progress. The streamer thread feeds the ring buffer with what
+comes after the head; the audio thread reads the head first, then the ring. */
+
+struct Voice
+{
+	Voice() : ring(G_AUDITION_RING_SIZE * G_MAX_IO_CHANS), ready(false), 
+		eof(false), stop(false)
+	{
+	}
+
+	~Voice()
+	{
+		stop.store(true);
+		if (streamer.joinable())
+			streamer.join();
+	}
+
+	std::shared_ptr<const Head> head;
+	RingBuffer<float>           ring;
+	std::thread                 streamer;
+
+	/* channels, step
+	Written once before 'ready' is set. 'step' is the file to engine sample rate 
+	ratio. */
+
+	int    channels = 0;
+	double step     = 1.0;
+
+	std::atomic<bool> ready;
+	std::atomic<bool> eof;
+	std::atomic<bool> stop;
+
+	/* Audio thread state. Playback is interpolated between frames 'prev' and 
+	'next', at position 'phase'. */
+
+	Frame  headPos  = 0;
+	double phase    = 2.0; // Two frames must be pulled before the first output
+	float  prev[G_MAX_IO_CHANS] = { 0.0f };
+	float  next[G_MAX_IO_CHANS] = { 0.0f };
+	bool   ended    = false;
+};
+
+
+int samplerate_ = 0;
+
+/* voice_
+The voice played by the audio thread. Old voices are retired and deleted by the
+UI thread only when the audio thread has surely stopped using them, i.e. when
+epoch_ (incremented at each render) has moved forward. */
+
+std::atomic<Voice*>   voice_(nullptr);
+std::atomic<uint64_t> epoch_(0);
+std::vector<std::pair<std::unique_ptr<Voice>, uint64_t>> retired_;
+
+/* Prefetch cache and queue, shared between the UI and the prefetch worker. */
+
+std::list<std::pair<std::string, std::shared_ptr<const Head>>> cache_;
+std::deque<std::string>  pending_;
+std::mutex               mutex_;
+std::condition_variable  cond_;
+std::thread              prefetcher_;
+bool                     quit_ = false;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* downmix_
+Copies 'frames' frames from 'in' (with 'inChans' channels) to 'out', keeping
+only the first 'outChans' channels. */
+
+void downmix_(const float* in, int inChans, float* out, int outChans, Frame frames)
+{
+	for (Frame i = 0; i < frames; i++)
+		for (int k = 0; k < outChans; k++)
+			out[i * outChans + k] = in[i * inChans + k];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::shared_ptr<const Head> readHead_(const std::string& path)
+{
+	SF_INFO  info = {};
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+	if (file == nullptr)
+		return nullptr;
+
+	Frame maxFrames = static_cast<Frame>(G_AUDITION_HEAD_MS) * info.samplerate / 1000;
+	Frame frames    = static_cast<Frame>(std::min<sf_count_t>(info.frames, maxFrames));
+
+	std::vector<float> in(frames * info.channels);
+	frames = static_cast<Frame>(sf_readf_float(file, in.data(), frames));
+	sf_close(file);
+
+	if (frames <= 0 || info.channels <= 0)
+		return nullptr;
+
+	auto head = std::make_shared<Head>();
+	head->channels = std::min(info.channels, G_MAX_IO_CHANS);
+	head->rate     = info.samplerate;
+	head->frames   = frames;
+	head->complete = frames >= info.frames;
+	head->data.resize(frames * head->channels);
+	downmix_(in.data(), info.channels, head->data.data(), head->channels, frames);
+
+	return head;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::shared_ptr<const Head> getHead_(const std::string& path)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+		if (it->first != path)
+			continue;
+		cache_.splice(cache_.begin(), cache_, it); // Most recently used first
+		return cache_.front().second;
+	}
+	return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void prefetch_()
+{
+	while (true) {
+		std::string path;
+		{
+			std::unique_lock<std::mutex> lock(mutex_);
+			cond_.wait(lock, []{ return quit_ || !pending_.empty(); });
+			if (quit_)
+				return;
+			path = pending_.front();
+			pending_.pop_front();
+		}
+
+		std::shared_ptr<const Head> head = readHead_(path);
+		if (head == nullptr)
+			continue;
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		cache_.emplace_front(path, head);
+		if (cache_.size() > G_AUDITION_HEAD_CACHE_SIZE)
+			cache_.pop_back();
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* stream_
+Streamer thread body: decodes the file from frame 'start' into the voice's ring
+buffer, sleeping while the ring is full. */
+
+void stream_(Voice* v, std::string path, Frame start)
+{
+	SF_INFO  info = {};
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &info);
+
+	if (file == nullptr || info.channels <= 0) {
+		u::log::print("[audition::stream_] unable to read %s\n", path.c_str());
+		if (file != nullptr)
+			sf_close(file);
+		v->eof.store(true);
+		v->ready.store(true);
+		return;
+	}
+
+	if (!v->ready.load()) {
+		v->channels = std::min(info.channels, G_MAX_IO_CHANS);
+		v->step     = info.samplerate / static_cast<double>(samplerate_);
+		v->ready.store(true);
+	}
+
+	if (start > 0 && sf_seek(file, start, SEEK_SET) < 0) {
+		sf_close(file);
+		v->eof.store(true);
+		return;
+	}
+
+	std::vector<float> in (G_AUDITION_CHUNK_SIZE * info.channels);
+	std::vector<float> out(G_AUDITION_CHUNK_SIZE * v->channels);
+
+	while (!v->stop.load()) {
+		if (v->ring.countWritable() < out.size()) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			continue;
+		}
+		sf_count_t frames = sf_readf_float(file, in.data(), G_AUDITION_CHUNK_SIZE);
+		if (frames <= 0)
+			break;
+		downmix_(in.data(), info.channels, out.data(), v->channels, frames);
+		v->ring.write(out.data(), frames * v->channels);
+	}
+
+	sf_close(file);
+	v->eof.store(true);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* pull_
+Reads the next frame of the voice into 'frame'. Returns false if no frame is 
+available yet, or the voice is over. Audio thread only. */
+
+bool pull_(Voice& v, float* frame)
+{
+	if (v.head != nullptr && v.headPos < v.head->frames) {
+		const float* src = v.head->data.data() + v.headPos * v.channels;
+		std::copy(src, src + v.channels, frame);
+		v.headPos++;
+		return true;
+	}
+
+	/* Read 'eof' before checking the ring: the streamer sets it after its last
+	write, so an empty ring here means the file is really over. */
+
+	bool eof = v.eof.load();
+	if (v.ring.read(frame, v.channels) == static_cast<size_t>(v.channels))
+		return true;
+	if (eof)
+		v.ended = true;
+	return false;  // Over, or underrun: plays silence until the ring refills
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void render_(Voice& v, AudioBuffer& out, float volume)
+{
+	for (int j = 0; j < out.countFrames(); j++) {
+		while (v.phase >= 1.0) {
+			float frame[G_MAX_IO_CHANS];
+			if (!pull_(v, frame))
+				return;
+			std::copy(v.next, v.next + G_MAX_IO_CHANS, v.prev);
+			std::copy(frame, frame + v.channels, v.next);
+			v.phase -= 1.0;
+		}
+		for (int k = 0; k < out.countChannels(); k++) {
+			int   c = std::min(k, v.channels - 1); // Mono files go to all channels
+			float s = v.prev[c] + (v.next[c] - v.prev[c]) * static_cast<float>(v.phase);
+			out[j][k] += s * volume;
+		}
+		v.phase += v.step;
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void retire_(Voice* v)
+{
+	if (v == nullptr)
+		return;
+	v->stop.store(true);
+	retired_.emplace_back(std::unique_ptr<Voice>(v), epoch_.load());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* collect_
+Deletes retired voices the audio thread can't be using anymore: any render 
+started after a voice has been retired sees the new one. */
+
+void collect_()
+{
+	uint64_t epoch = epoch_.load();
+	retired_.erase(std::remove_if(retired_.begin(), retired_.end(), 
+		[epoch](const auto& r) { return epoch > r.second; }), retired_.end());
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init(int samplerate)
+{
+	samplerate_ = samplerate;
+	quit_       = false;
+	prefetcher_ = std::thread(prefetch_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_ = true;
+		pending_.clear();
+	}
+	cond_.notify_one();
+	if (prefetcher_.joinable())
+		prefetcher_.join();
+
+	/* The audio device is closed here: nobody is rendering anymore. */
+
+	delete voice_.exchange(nullptr);
+	retired_.clear();
+	cache_.clear();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void play(const std::string& path)
+{
+	if (samplerate_ == 0)
+		return;
+
+	std::unique_ptr<Voice> v = std::make_unique<Voice>();
+	v->head = getHead_(path);
+
+	if (v->head != nullptr) {
+		v->channels = v->head->channels;
+		v->step     = v->head->rate / static_cast<double>(samplerate_);
+		v->ready.store(true);
+	}
+
+	if (v->head != nullptr && v->head->complete)
+		v->eof.store(true);
+	else
+		v->streamer = std::thread(stream_, v.get(), path, v->head != nullptr ? v->head->frames : 0);
+
+	retire_(voice_.exchange(v.release()));
+	collect_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void stop()
+{
+	retire_(voice_.exchange(nullptr));
+	collect_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void prefetch(const std::vector<std::string>& paths)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		pending_.clear();
+		for (const std::string& path : paths) {
+			bool cached = std::any_of(cache_.begin(), cache_.end(), 
+				[&path](const auto& c) { return c.first == path; });
+			if (!cached)
+				pending_.push_back(path);
+		}
+	}
+	cond_.notify_one();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void render(AudioBuffer& out, float volume)
+{
+	Voice* v = voice_.load();
+	if (v != nullptr && v->ready.load() && !v->ended)
+		render_(*v, out, volume);
+	epoch_.fetch_add(1);
+}
+}}} // giada::m::audition::
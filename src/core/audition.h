@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_AUDITION_H
+#define G_AUDITION_H
+
+
+#include <string>
+#include <vector>
+
+
+namespace giada {
+namespace m 
+{
+class AudioBuffer;
+namespace audition
+{
+/* init
+Starts the prefetch worker. Audio files are auditioned at 'samplerate'. */
+
+void init(int samplerate);
+
+/* close
+Stops any audition and frees all resources. Call it when the audio device is
+closed. */
+
+void close();
+
+/* play
+Auditions the audio file 'path' on the preview channel, replacing the current
+one. Never blocks: the first part of the file comes from the prefetch cache, if
+any, the rest is streamed from disk by a background thread. */
+
+void play(const std::string& path);
+
+/* stop
+Stops the current audition, if any. */
+
+void stop();
+
+/* prefetch
+Decodes in background the first few hundred milliseconds of the audio files in
+'paths', e.g. the ones around the selection in the browser. Replaces the 
+previous prefetch requests still pending. */
+
+void prefetch(const std::vector<std::string>& paths);
+
+/* render
+Mixes the current audition into buffer 'out'. Audio thread only. */
+
+void render(AudioBuffer& out, float volume);
+}}} // giada::m::audition::
+
+
+#endif
@@ -0,0 +1,262 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include "utils/log.h"
+#include "core/model/model.h"
+#include "core/channels/channel.h"
+#include "core/channels/sampleChannel.h"
+#include "core/plugin.h"
+#include "core/const.h"
+#include "core/automation.h"
+
+
+namespace giada {
+namespace m {
+namespace automation
+{
+namespace
+{
+/* Slot
+A bound parameter. The target is set once by bind(), before the slot becomes
+visible to the other threads. */
+
+struct Slot
+{
+	Param param;
+	ID    id;
+	int   index;
+
+	std::atomic<float> target;   // Last value written by the MIDI thread
+	std::atomic<bool>  pending;
+	std::atomic<float> value;    // Last value applied by the audio thread
+	std::atomic<bool>  changed;
+
+	float current;               // Audio thread only
+	bool  active;                // Audio thread only
+};
+
+std::array<Slot, G_MAX_AUTOMATION_SLOTS> slots_;
+std::atomic<int> count_(0);
+
+/* keys_
+Maps each target to its slot. Used by bind() only. */
+
+std::map<std::tuple<Param, ID, int>, int> keys_;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* read_
+Reads the current value of the parameter bound to slot 's'. Returns false if 
+the target is gone. Channels and plug-ins must be locked. */
+
+bool read_(const Slot& s, float& v)
+{
+	switch (s.param) {
+		case Param::VOLUME: {
+			const Channel* ch = model::find(model::channels, s.id);
+			if (ch == nullptr)
+				return false;
+			v = ch->volume;
+			return true;
+		}
+		case Param::PITCH: {
+			const Channel* ch = model::find(model::channels, s.id);
+			if (ch == nullptr || ch->type != ChannelType::SAMPLE)
+				return false;
+			v = static_cast<const SampleChannel*>(ch)->getPitch();
+			return true;
+		}
+		case Param::PLUGIN: {
+#ifdef WITH_VST
+			const Plugin* p = model::find(model::plugins, s.id);
+			if (p == nullptr || s.index >= p->getNumParameters())
+				return false;
+			v = p->getParameter(s.index);
+			return true;
+#else
+			return false;
+#endif
+		}
+	}
+	return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* apply_
+Same as read_(), the other way around. */
+
+bool apply_(const Slot& s, float v)
+{
+	switch (s.param) {
+		case Param::VOLUME: {
+			Channel* ch = model::find(model::channels, s.id);
+			if (ch == nullptr)
+				return false;
+			ch->volume = v;
+			return true;
+		}
+		case Param::PITCH: {
+			Channel* ch = model::find(model::channels, s.id);
+			if (ch == nullptr || ch->type != ChannelType::SAMPLE)
+				return false;
+			static_cast<SampleChannel*>(ch)->setPitch(v);
+			return true;
+		}
+		case Param::PLUGIN: {
+#ifdef WITH_VST
+			const Plugin* p = model::find(model::plugins, s.id);
+			if (p == nullptr || s.index >= p->getNumParameters())
+				return false;
+			p->setParameter(s.index, v);
+			return true;
+#else
+			return false;
+#endif
+		}
+	}
+	return false;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+int bind(Param p, ID id, int index)
+{
+	const auto key = std::make_tuple(p, id, index);
+	const auto it  = keys_.find(key);
+	if (it != keys_.end())
+		return it->second;
+
+	const int slot = count_.load();
+	if (slot >= G_MAX_AUTOMATION_SLOTS) {
+		u::log::print("[automation::bind] no free slots left!\n");
+		return -1;
+	}
+
+	Slot& s = slots_[slot];
+	s.param = p;
+	s.id    = id;
+	s.index = index;
+	s.pending.store(false);
+	s.changed.store(false);
+	s.active = false;
+
+	keys_[key] = slot;
+
+	/* Publish the slot only now that it's ready. */
+
+	count_.store(slot + 1);
+	return slot;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void write(int slot, float value)
+{
+	slots_[slot].target.store(value);
+	slots_[slot].pending.store(true);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void process(int sampleRate, Frame frames)
+{
+	const int count = count_.load();
+	if (count == 0)
+		return;
+
+	/* One-pole smoothing, evaluated once per block. */
+
+	const float coeff = 1.0f - std::exp(-frames / (sampleRate * G_AUTOMATION_SMOOTHING_MS / 1000.0f));
+
+	model::ChannelsLock cl(model::channels);
+#ifdef WITH_VST
+	model::PluginsLock  pl(model::plugins);
+#endif
+
+	for (int i = 0; i < count; i++) {
+		Slot& s = slots_[i];
+
+		/* A new value has been written: start from the actual value of the 
+		parameter, which might have been changed elsewhere in the meantime. */
+
+		if (s.pending.exchange(false) && !s.active) {
+			if (!read_(s, s.current))
+				continue;
+			s.active = true;
+		}
+		if (!s.active)
+			continue;
+
+		const float target = s.target.load();
+		s.current += (target - s.current) * coeff;
+		if (std::fabs(target - s.current) < G_AUTOMATION_EPSILON) {
+			s.current = target;
+			s.active  = false;
+		}
+
+		if (!apply_(s, s.current)) {
+			s.active = false;
+			continue;
+		}
+		s.value.store(s.current);
+		s.changed.store(true);
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void fetch(std::function<void(Param p, ID id, int index, float value)> f)
+{
+	const int count = count_.load();
+	for (int i = 0; i < count; i++) {
+		Slot& s = slots_[i];
+		if (s.changed.exchange(false))
+			f(s.param, s.id, s.index, s.value.load());
+	}
+}
+}}} // giada::m::automation::
@@ -0,0 +1,71 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_AUTOMATION_H
+#define G_AUTOMATION_H
+
+
+#include <functional>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m {
+namespace automation
+{
+enum class Param { VOLUME, PITCH, PLUGIN };
+
+/* bind
+Returns the slot for parameter 'p' of channel or plug-in 'id' ('index' is the 
+plug-in parameter index), creating it if needed. Returns -1 if there are no 
+free slots left. Slots are never released: binding the same target twice 
+yields the same slot. Call it from one thread at a time. */
+
+int bind(Param p, ID id, int index=0);
+
+/* write
+Stores a new value for slot 'slot'. Never blocks nor allocates. MIDI thread 
+only. */
+
+void write(int slot, float value);
+
+/* process
+Moves each parameter written so far towards its new value, smoothing the 
+change over G_AUTOMATION_SMOOTHING_MS, and applies it to the model. Call it 
+once per block. Audio thread only. */
+
+void process(int sampleRate, Frame frames);
+
+/* fetch
+Calls 'f' once for each parameter changed by process() since the last call, 
+with its latest value. UI thread only. */
+
+void fetch(std::function<void(Param p, ID id, int index, float value)> f);
+}}} // giada::m::automation::
+
+
+#endif
@@ -26,6 +26,7 @@
 
 
 #include <cassert>
+#include <cmath>
 #include "utils/log.h"
 #include "core/channels/channelManager.h"
 #include "core/const.h"
@@ -60,6 +61,8 @@ Channel::Channel(ChannelType type, ChannelStatus playStatus, int bufferSize,
   pan            (0.5f),
   volume         (G_DEFAULT_VOL),
   armed          (false),
+  outBus         (0),
+  inBus          (0),
   key            (0),
   mute           (false),
   solo           (false),
@@ -67,6 +70,9 @@ Channel::Channel(ChannelType type, ChannelStatus playStatus, int bufferSize,
   volume_d       (0.0f),
   hasActions     (false),
   readActions    (false),
+  peak           (0.0f),
+  rms            (0.0f),
+  stackPeak      (0.0f),
   midiIn         (true),
   midiInKeyPress (0x0),
   midiInKeyRel   (0x0),
@@ -85,7 +91,7 @@ Channel::Channel(ChannelType type, ChannelStatus playStatus, int bufferSize,
 
 #ifdef WITH_VST
 
-	midiBuffer.ensureSize(bufferSize);
+	midiBuffer.ensureSize(G_PLUGIN_MIDI_BUFFER_SIZE);
 
 #endif
 }
@@ -105,6 +111,8 @@ Channel::Channel(const Channel& o)
   pan            (o.pan),
   volume         (o.volume),
   armed          (o.armed),
+  outBus         (o.outBus),
+  inBus          (o.inBus),
   name           (o.name),
   key            (o.key),
   mute           (o.mute),
@@ -113,6 +121,9 @@ Channel::Channel(const Channel& o)
   volume_d       (o.volume_d),
   hasActions     (o.hasActions),
   readActions    (o.readActions),
+  peak           (o.peak),
+  rms            (o.rms),
+  stackPeak      (o.stackPeak),
   midiIn         (o.midiIn),
   midiInKeyPress (o.midiInKeyPress),
   midiInKeyRel   (o.midiInKeyRel),
@@ -127,10 +138,17 @@ Channel::Channel(const Channel& o)
   midiOutLmute   (o.midiOutLmute),
   midiOutLsolo   (o.midiOutLsolo)
 #ifdef WITH_VST
- ,pluginIds      (o.pluginIds)
+ ,pluginIds      (o.pluginIds),
+  delayLine      (o.delayLine)
 #endif
 {
 	buffer.alloc(o.buffer.countFrames(), G_MAX_IO_CHANS);
+
+#ifdef WITH_VST
+
+	midiBuffer.ensureSize(G_PLUGIN_MIDI_BUFFER_SIZE);
+
+#endif
 }
 
 
@@ -148,6 +166,8 @@ Channel::Channel(const patch::Channel& p, int bufferSize)
   pan            (p.pan),
   volume         (p.volume),
   armed          (p.armed),
+  outBus         (p.outBus),
+  inBus          (p.inBus),
   name           (p.name),
   key            (p.key),
   mute           (p.mute),
@@ -156,6 +176,9 @@ Channel::Channel(const patch::Channel& p, int bufferSize)
   volume_d       (0.0),
   hasActions     (p.hasActions),
   readActions    (p.readActions),
+  peak           (0.0f),
+  rms            (0.0f),
+  stackPeak      (0.0f),
   midiIn         (p.midiIn),
   midiInKeyPress (p.midiInKeyPress),
   midiInKeyRel   (p.midiInKeyRel),
@@ -174,6 +197,12 @@ Channel::Channel(const patch::Channel& p, int bufferSize)
 #endif
 {
     buffer.alloc(bufferSize, G_MAX_IO_CHANS);
+
+#ifdef WITH_VST
+
+	midiBuffer.ensureSize(G_PLUGIN_MIDI_BUFFER_SIZE);
+
+#endif
 }
 
 
@@ -301,6 +330,20 @@ void Channel::calcVolumeEnvelope()
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+
+void Channel::setLevels(float peak, float sum, int count, float stackPeak)
+{
+	this->peak      = peak;
+	this->rms       = count > 0 ? std::sqrt(sum / count) : 0.0f;
+	this->stackPeak = stackPeak;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool Channel::isPreview() const
 {
 	return previewMode != PreviewMode::NONE;
@@ -31,6 +31,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include "core/types.h"
 #include "core/patch.h"
 #include "core/mixer.h"
@@ -43,6 +44,7 @@
 #include "core/plugin.h"
 #include "core/pluginHost.h"
 #include "core/queue.h"
+#include "core/delayLine.h"
 #endif
 
 
@@ -179,6 +181,12 @@ public:
 
 	void calcVolumeEnvelope();
 
+	/* setLevels
+	Stores the levels computed by the audio thread while mixing. 'sum' is the
+	sum of squares of the 'count' samples sent to the output. */
+
+	void setLevels(float peak, float sum, int count, float stackPeak);
+
 	/* buffer
 	Working buffer for internal processing. */
 	
@@ -201,6 +209,15 @@ public:
 	float pan;
 	float volume;   // global volume
 	bool armed;
+
+	/* outBus, inBus
+	Stereo buses the channel plays to and records from. Bus 0 is the main mix,
+	i.e. the first pair of the audio device. Buses not opened by the device fall
+	back to the main mix (output) or to no input at all (input). */
+
+	int outBus;
+	int inBus;
+
 	std::string name;
 	int  key;
 	bool mute;
@@ -217,6 +234,15 @@ public:
 	bool hasActions;  // If has some actions recorded
 	bool readActions; // If should read recorded actions
 
+	/* peak, rms, stackPeak
+	Output levels of the last block, computed by the audio thread while mixing
+	the channel into the main output: post-fader peak and RMS, plus the peak at 
+	the end of the plug-in stack (pre-fader). */
+
+	float peak;
+	float rms;
+	float stackPeak;
+
 	bool     midiIn;               // enable midi input
 	uint32_t midiInKeyPress;
 	uint32_t midiInKeyRel;
@@ -249,7 +275,8 @@ public:
 	/* MidiBuffer 
 	Contains MIDI events. When ready, events are sent to each plugin in the 
 	channel. This is available for any kind of channel, but it makes sense only 
-	for MIDI channels. */
+	for MIDI channels. Preallocated on construction, so that adding events in 
+	the audio thread doesn't allocate. */
 	
 	juce::MidiBuffer midiBuffer;
 
@@ -260,6 +287,14 @@ public:
 
 	Queue<MidiEvent, 32> midiQueue;
 
+	/* delayLine
+	Plug-in delay compensation: delays the channel output so that it lines up 
+	with the slowest plug-in stack in the mixer. Shared between copies, so that 
+	its state survives channel swaps in the model. Set by 
+	pluginHost::updateDelayCompensation(); nullptr means no delay. */
+
+	std::shared_ptr<DelayLine> delayLine;
+
 #endif
 
 protected:
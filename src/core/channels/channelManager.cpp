@@ -163,6 +163,8 @@ const patch::Channel serializeChannel(const Channel& c)
 		pc.pan             = c.pan;
 		pc.hasActions      = c.hasActions;
 		pc.armed           = c.armed;
+		pc.outBus          = c.outBus;
+		pc.inBus           = c.inBus;
 		pc.midiIn          = c.midiIn;
 		pc.midiInKeyPress  = c.midiInKeyRel;
 		pc.midiInKeyRel    = c.midiInKeyPress;
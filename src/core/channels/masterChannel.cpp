@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include "core/audition.h"
 #include "masterChannel.h"
 
 
@@ -73,6 +74,13 @@ void MasterChannel::load(const patch::Channel& p)
 void MasterChannel::render(AudioBuffer& out, const AudioBuffer& in, 
 	AudioBuffer& inToOut, bool audible, bool running)
 {
+	/* The preview channel plays sample auditions from the browser. */
+
+	if (id == mixer::PREVIEW_CHANNEL_ID) {
+		audition::render(out, volume);
+		return;
+	}
+
 #ifdef WITH_VST
 	if (pluginIds.size() == 0)
 		return;
@@ -26,6 +26,8 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 #include "core/channels/midiChannel.h"
 #include "core/model/model.h"
 #include "core/pluginHost.h"
@@ -106,17 +108,48 @@ void process(MidiChannel* ch, AudioBuffer& out, const AudioBuffer& in, bool audi
 		ch->midiBuffer.addEvent(message, e.getDelta());
 	}
 	pluginHost::processStack(ch->buffer, ch->pluginIds, &ch->midiBuffer);
+
+	/* The delay line must run even when the channel is not audible, so that it
+	keeps flowing. Volume is applied before the delay, as in Sample Channels. */
+
+	float stackPeak = 0.0f;
+
+	if (ch->delayLine != nullptr) {
+		for (int i=0; i<ch->buffer.countFrames(); i++)
+			for (int j=0; j<ch->buffer.countChannels(); j++) {
+				stackPeak = std::max(stackPeak, std::fabs(ch->buffer[i][j]));
+				ch->buffer[i][j] *= ch->volume;
+			}
+		ch->delayLine->process(ch->buffer);
+	}
 	
 	/* Process the plugin stack first, then quit if the channel is muted/soloed. 
 	This way there's no risk of cutting midi event pairs such as note-on and 
 	note-off while triggering a mute/solo. */
 
-	if (!audible)
+	if (!audible) {
+		ch->setLevels(0.0f, 0.0f, 0, 0.0f);
 		return;
+	}
+
+	/* Levels are computed in the same pass that mixes the channel into the
+	output. */
+
+	float peak = 0.0f;
+	float sum  = 0.0f;
 
 	for (int i=0; i<out.countFrames(); i++)
-		for (int j=0; j<out.countChannels(); j++)
-			out[i][j] += ch->buffer[i][j] * ch->volume;	
+		for (int j=0; j<out.countChannels(); j++) {
+			float v = ch->buffer[i][j];
+			if (ch->delayLine == nullptr) {
+				stackPeak = std::max(stackPeak, std::fabs(v));
+				v *= ch->volume;
+			}
+			out[i][j] += v;
+			peak = std::max(peak, std::fabs(v));
+			sum += v * v;
+		}
+	ch->setLevels(peak, sum, out.countSamples(), stackPeak);
 
 #endif
 }
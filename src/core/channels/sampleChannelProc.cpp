@@ -26,6 +26,8 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <algorithm>
 #include "utils/math.h"
 #include "core/model/model.h"
 #include "core/channels/sampleChannel.h"
@@ -182,8 +184,23 @@ void onLastFrame_(SampleChannel* ch, bool running)
 
 
 void processIO_(SampleChannel* ch, m::AudioBuffer& out, const m::AudioBuffer& in, 
-	bool running)
+	bool audible, bool running)
 {
+#ifdef WITH_VST
+	/* The delay line must run even when the channel is not audible, so that it
+	keeps flowing: the whole chain is processed and the output just dropped. */
+
+	if (!audible && ch->delayLine == nullptr) {
+		ch->setLevels(0.0f, 0.0f, 0, 0.0f);
+		return;
+	}
+#else
+	if (!audible) {
+		ch->setLevels(0.0f, 0.0f, 0, 0.0f);
+		return;
+	}
+#endif
+
 	assert(out.countSamples() == ch->buffer.countSamples());
 	if (in.isAllocd())
 		assert(in.countSamples() == ch->buffer.countSamples());
@@ -204,13 +221,59 @@ void processIO_(SampleChannel* ch, m::AudioBuffer& out, const m::AudioBuffer& in
 	pluginHost::processStack(ch->buffer, ch->pluginIds);
 #endif
 
+	/* Levels are computed in the same pass that mixes the channel into the
+	output: 'stackPeak' reads the channel buffer as it comes out of the plug-in 
+	stack, 'peak' and 'sum' the signal actually sent to the output. */
+
+	float peak      = 0.0f;
+	float stackPeak = 0.0f;
+	float sum       = 0.0f;
+
+#ifdef WITH_VST
+	/* With plug-in delay compensation the volume envelope must be delayed as 
+	well, so apply it to the channel buffer first and then mix the delayed 
+	result. MIDI channels follow the same order. */
+
+	if (ch->delayLine != nullptr) {
+		for (int i=0; i<ch->buffer.countFrames(); i++) {
+			if (running)
+				ch->calcVolumeEnvelope();
+			for (int j=0; j<ch->buffer.countChannels(); j++) {
+				stackPeak = std::max(stackPeak, std::fabs(ch->buffer[i][j]));
+				ch->buffer[i][j] *= ch->mute ? 0.0f : ch->volume * ch->volume_i * ch->calcPanning(j);
+			}
+		}
+		ch->delayLine->process(ch->buffer);
+		if (!audible) {
+			ch->setLevels(0.0f, 0.0f, 0, 0.0f);
+			return;
+		}
+		for (int i=0; i<out.countFrames(); i++)
+			for (int j=0; j<out.countChannels(); j++) {
+				float v = ch->buffer[i][j];
+				out[i][j] += v;
+				peak = std::max(peak, std::fabs(v));
+				sum += v * v;
+			}
+		ch->setLevels(peak, sum, out.countSamples(), stackPeak);
+		return;
+	}
+#endif
+
 	for (int i=0; i<out.countFrames(); i++) {
 		if (running)
 			ch->calcVolumeEnvelope();
-		if (!ch->mute)
-			for (int j=0; j<out.countChannels(); j++)
-				out[i][j] += ch->buffer[i][j] * ch->volume * ch->volume_i * ch->calcPanning(j);	
+		for (int j=0; j<out.countChannels(); j++) {
+			stackPeak = std::max(stackPeak, std::fabs(ch->buffer[i][j]));
+			if (ch->mute)
+				continue;
+			float v = ch->buffer[i][j] * ch->volume * ch->volume_i * ch->calcPanning(j);
+			out[i][j] += v;
+			peak = std::max(peak, std::fabs(v));
+			sum += v * v;
+		}
 	}
+	ch->setLevels(peak, sum, out.countSamples(), stackPeak);
 }
 
 
@@ -497,8 +560,7 @@ void render(SampleChannel* ch, AudioBuffer& out, const AudioBuffer& in,
 {
 	fillBuffer_(ch, running);
 
-	if (audible)
-		processIO_(ch, out, in, running);
+	processIO_(ch, out, in, audible, running);
 
 	if (ch->isPreview())
 		processPreview_(ch, out);
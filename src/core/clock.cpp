@@ -26,14 +26,13 @@
 
 
 #include <atomic>
+#include <algorithm>
 #include <cassert>
-#include "glue/main.h"
+#include <cmath>
 #include "utils/math.h"
 #include "core/model/model.h"
 #include "core/conf.h"
 #include "core/const.h"
-#include "core/kernelAudio.h"
-#include "core/mixerHandler.h"
 #include "core/kernelMidi.h"
 #include "clock.h"
 
@@ -48,7 +47,47 @@ std::atomic<int> currentFrameWait_(0);
 std::atomic<int> currentFrame_(0);
 std::atomic<int> currentBeat_(0);
 
-int quanto_ = 1;             // Quantizer step
+/* muted_
+Frames still to play with recorded actions muted after a backward nudge(): 
+their actions have been played already. */
+
+std::atomic<int> muted_(0);
+
+/* skippedA_, skippedB_
+Frames jumped over by the last forward nudge(), still to be collected with 
+getSkipped(). Empty if skippedA_ >= skippedB_. */
+
+std::atomic<int> skippedA_(0);
+std::atomic<int> skippedB_(0);
+
+/* triggered_
+The input signal has started the clock while still in WAITING status, i.e. 
+before the main thread has switched it to RUNNING. */
+
+std::atomic<bool> triggered_(false);
+
+/* Block
+Clock parameters for the block being processed, taken by beginBlock() with a 
+single lock. Per-frame queries read them from here. Audio thread only. */
+
+struct Block
+{
+	bool     waiting          = false;
+	int      framesInLoop     = 0;
+	uint32_t framesInLoopFrac = 0;
+	int      beats            = G_DEFAULT_BEATS;
+	int      bars             = G_DEFAULT_BARS;
+	int      quantize         = G_DEFAULT_QUANTIZE;
+} block_;
+
+/* loopFrac_, loopExtra_
+Fractional loop position, in 1/2^32 of frame, carried over from one loop to the
+next. When it overflows the loop being played lasts one frame more, so that 
+loops are framesInLoop + framesInLoopFrac long on average and the clock keeps 
+the exact tempo over time. */
+
+std::atomic<uint32_t> loopFrac_(0);
+std::atomic<int>      loopExtra_(0);
 
 int midiTCrate_    = 0;      // Send MTC data every midiTCrate_ frames
 int midiTCframes_  = 0;
@@ -57,25 +96,62 @@ int midiTCminutes_ = 0;
 int midiTChours_   = 0;
 
 
-#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
-kernelAudio::JackState jackStatePrev_;
-#endif
-
-
 /* -------------------------------------------------------------------------- */
 
 /* recomputeFrames_
-Updates bpm, frames, beats and so on. Private version. */
+Updates bpm, frames, beats and so on. Private version. The loop length is split
+into whole frames and a 32-bit fraction, which the clock carries from loop to 
+loop (see loopFrac_). Beats, bars, quanti and MIDI clock ticks are exact 
+subdivisions of the loop being played (see u::math::gridFrame), so they never 
+drift from it. framesInBar and framesInBeat are nominal lengths, for display. */
 
 void recomputeFrames_(model::Clock& c)
 {
-	c.framesInLoop = (conf::conf.samplerate * (60.0f / c.bpm)) * c.beats;
-	c.framesInBar  = c.framesInLoop / (float) c.bars;
-	c.framesInBeat = c.framesInLoop / (float) c.beats;
-	c.framesInSeq  = c.framesInBeat * G_MAX_BEATS;
+	double length = (conf::conf.samplerate * 60.0) / c.bpm * c.beats;
+
+	c.framesInLoop     = static_cast<int>(length);
+	c.framesInLoopFrac = static_cast<uint32_t>((length - c.framesInLoop) * 4294967296.0);
+	c.framesInBar      = c.framesInLoop / c.bars;
+	c.framesInBeat     = c.framesInLoop / c.beats;
+	c.framesInSeq      = u::math::gridFrame(G_MAX_BEATS, c.framesInLoop, c.beats);
+}
+
 
-	if (c.quantize != 0)
-		quanto_ = c.framesInBeat / c.quantize;
+/* -------------------------------------------------------------------------- */
+
+/* isWaiting_
+Whether the clock is actually on hold, waiting for a trigger. */
+
+bool isWaiting_(const model::Clock& c)
+{
+	return c.status == ClockStatus::WAITING && !triggered_.load();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* loopLength_
+Length in frames of the loop being played, i.e. framesInLoop plus the extra 
+frame due to the fractional carry, if any. Audio thread only. */
+
+int loopLength_()
+{
+	return block_.framesInLoop + loopExtra_.load();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* nextLoop_
+Carries the fractional loop length over to the loop about to start. Audio thread
+only. */
+
+void nextLoop_()
+{
+	uint32_t prev = loopFrac_.load();
+	uint32_t next = prev + block_.framesInLoopFrac;  // Wraps around on overflow
+	loopFrac_.store(next);
+	loopExtra_.store(next < prev ? 1 : 0);
 }
 }; // {anonymous}
 
@@ -116,7 +192,16 @@ bool isRunning()
 {
 	model::ClockLock lock(model::clock);
 
-	return model::clock.get()->status == ClockStatus::RUNNING;
+	ClockStatus status = model::clock.get()->status;
+	return status == ClockStatus::RUNNING || 
+	      (status == ClockStatus::WAITING && triggered_.load());
+}
+
+
+bool isWaiting()
+{
+	model::ClockLock lock(model::clock);
+	return isWaiting_(*model::clock.get());
 }
 
 
@@ -131,33 +216,34 @@ bool isActive()
 
 bool quantoHasPassed()
 {
-	return currentFrame_.load() % quanto_ == 0;
+	if (block_.quantize == 0)
+		return true;
+	return u::math::isOnGrid(currentFrame_.load(), loopLength_(), 
+		block_.beats * block_.quantize);
 }
 
 
-bool isOnBar()
+int getBlockQuantize()
 {
-	model::ClockLock lock(model::clock);
+	return block_.quantize;
+}
 
-	const model::Clock* c = model::clock.get();
-	
+
+bool isOnBar()
+{
 	int currentFrame = currentFrame_.load();
 
-	if (c->status == ClockStatus::WAITING || currentFrame == 0)
+	if (block_.waiting || currentFrame == 0)
 		return false;
-	return currentFrame % c->framesInBar == 0;
+	return u::math::isOnGrid(currentFrame, loopLength_(), block_.bars);
 }
 
 
 bool isOnBeat()
 {
-	model::ClockLock lock(model::clock);
-	
-	const model::Clock* c = model::clock.get();
-	
-	if (c->status == ClockStatus::WAITING)
-		return currentFrameWait_.load() % c->framesInBeat == 0;
-	return currentFrame_.load() % c->framesInBeat == 0;
+	if (block_.waiting)
+		return u::math::isOnGrid(currentFrameWait_.load(), block_.framesInLoop, block_.beats);
+	return u::math::isOnGrid(currentFrame_.load(), loopLength_(), block_.beats);
 }
 
 
@@ -172,15 +258,6 @@ bool isOnFirstBeat()
 
 void setBpm(float b)
 {	
-#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
-	
-	/* Can't change bpm from within Giada when using JACK. */
-
-	if (m::kernelAudio::getAPI() == G_SYS_API_JACK)
-		return;
-
-#endif
-
 	b = u::math::bound(b, G_MIN_BPM, G_MAX_BPM);
 
 	model::onSwap(model::clock, [&](model::Clock& c)
@@ -221,6 +298,7 @@ void setStatus(ClockStatus s)
 	{
 		c.status = s;
 	});
+	triggered_.store(false);
 	
 	if (s == ClockStatus::RUNNING) {
 		if (conf::conf.midiSync == MIDI_SYNC_CLOCK_M) {
@@ -239,41 +317,146 @@ void setStatus(ClockStatus s)
 /* -------------------------------------------------------------------------- */
 
 
-void incrCurrentFrame() 
+void beginBlock()
 {
 	model::ClockLock lock(model::clock);
-	
+
 	const model::Clock* c = model::clock.get();
 
-	if (c->status == ClockStatus::WAITING) {
+	block_.waiting          = isWaiting_(*c);
+	block_.framesInLoop     = c->framesInLoop;
+	block_.framesInLoopFrac = c->framesInLoopFrac;
+	block_.beats            = c->beats;
+	block_.bars             = c->bars;
+	block_.quantize         = c->quantize;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void incrCurrentFrame() 
+{
+	if (block_.waiting) {
 		int f = currentFrameWait_.load() + 1;
-		if (f >= c->framesInLoop)
+		if (f >= block_.framesInLoop)
 				f = 0;
 		currentFrameWait_.store(f);
 		return;
 	}
 
 	int f = currentFrame_.load() + 1;
-	int b = currentBeat_.load();
-
-	if (f >= c->framesInLoop) {
+	if (f >= loopLength_()) {
 		f = 0;
-		b = 0;
+		nextLoop_();
 	}
-	else
-	if (f % c->framesInBeat == 0) // If is on beat
-		b++;
+
+	if (muted_.load() > 0)
+		muted_.store(muted_.load() - 1);
 	
 	currentFrame_.store(f);
-	currentBeat_.store(b);
+	currentBeat_.store(u::math::gridIndex(f, loopLength_(), block_.beats));
+}
+
+
+void setCurrentFrame(int f)
+{
+	model::ClockLock lock(model::clock);
+
+	const model::Clock* c = model::clock.get();
+
+	/* While waiting the clock counts on its own frame: move that one too. */
+
+	if (isWaiting_(*c))
+		currentFrameWait_.store(f);
+	currentFrame_.store(f);
+	currentBeat_.store(u::math::gridIndex(f, c->framesInLoop, c->beats));
+
+	/* A new position for real: nothing to replay nor to chase. */
+
+	muted_.store(0);
+	skippedA_.store(0);
+	skippedB_.store(0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void nudge(int delta)
+{
+	model::ClockLock lock(model::clock);
+
+	const model::Clock* c       = model::clock.get();
+	const int           current = currentFrame_.load();
+	int                 f;
+
+	if (c->framesInLoop <= 0 || delta == 0)
+		return;
+
+	if (delta < 0) {
+
+		/* Never go back across the first frame: loops and queued channels 
+		would start again. Stop right after it, the next nudges recover the 
+		rest. */
+
+		f = std::max(current + delta, std::min(current, 1));
+		muted_.store(muted_.load() + current - f);
+	}
+	else {
+		f = current + delta >= c->framesInLoop ? 0 : current + delta;
+
+		/* Frames still muted from a previous nudge() don't need a chase. */
+
+		const int end     = f == 0 ? c->framesInLoop : f;
+		const int covered = std::min(muted_.load(), end - current);
+		muted_.store(muted_.load() - covered);
+		skippedA_.store(current + covered);
+		skippedB_.store(end);
+	}
+
+	currentFrame_.store(f);
+	currentBeat_.store(u::math::gridIndex(f, c->framesInLoop, c->beats));
 }
 
 
+bool areActionsMuted()
+{
+	return muted_.load() > 0;
+}
+
+
+bool getSkipped(int& a, int& b)
+{
+	a = skippedA_.load();
+	b = skippedB_.load();
+	skippedA_.store(0);
+	skippedB_.store(0);
+	return a < b;
+}
+
+
+void trigger(int f)
+{
+	setCurrentFrame(f);
+	triggered_.store(true);
+	block_.waiting = false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void rewind()
 {
 	currentFrame_.store(0);
 	currentBeat_.store(0);
 	currentFrameWait_.store(0);
+	loopFrac_.store(0);
+	loopExtra_.store(0);
+	muted_.store(0);
+	skippedA_.store(0);
+	skippedB_.store(0);
 	
 	sendMIDIrewind();
 }
@@ -284,21 +467,17 @@ void rewind()
 
 void sendMIDIsync()
 {
-	model::ClockLock lock(model::clock);
-	
-	const model::Clock* c = model::clock.get();
-	
 	/* Sending MIDI sync while waiting is meaningless. */
 
-	if (c->status == ClockStatus::WAITING)
+	if (block_.waiting)
 		return;
 
 	int currentFrame = currentFrame_.load();
 
-	/* TODO - only Master (_M) is implemented so far. */
+	/* Slave modes (_S) are handled by midiSync. */
 
 	if (conf::conf.midiSync == MIDI_SYNC_CLOCK_M) {
-		if (currentFrame % (c->framesInBeat / 24) == 0)
+		if (u::math::isOnGrid(currentFrame, loopLength_(), block_.beats * G_MIDI_CLOCK_PPQN))
 			kernelMidi::send(MIDI_CLOCK, -1, -1);
 		return;
 	}
@@ -386,36 +565,6 @@ void sendMIDIrewind()
 /* -------------------------------------------------------------------------- */
 
 
-#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
-
-void recvJackSync()
-{
-	/* TODO - these things should be processed by a higher level, 
-	above clock:: ----> clockManager */
-
-	kernelAudio::JackState jackState = kernelAudio::jackTransportQuery();
-
-	if (jackState.running != jackStatePrev_.running) {
-		if (jackState.running) {
-			if (!isRunning())
-				mh::startSequencer();
-		}
-		else {
-			if (isRunning())
-				mh::stopSequencer();
-		}
-	}
-	if (jackState.bpm != jackStatePrev_.bpm)
-		if (jackState.bpm > 1.0f)  // 0 bpm if Jack does not send that info
-			c::main::setBpm(jackState.bpm);
-
-	if (jackState.frame == 0 && jackState.frame != jackStatePrev_.frame)
-		mh::rewindSequencer();
-
-	jackStatePrev_ = jackState;
-}
-
-#endif
 
 
 /* -------------------------------------------------------------------------- */
@@ -436,7 +585,6 @@ bool canQuantize()
 
 int         getCurrentFrame() { return currentFrame_.load(); }
 int         getCurrentBeat()  { return currentBeat_.load(); }
-int         getQuanto()       { return quanto_; }
 ClockStatus getStatus()       { model::ClockLock lock(model::clock); return model::clock.get()->status; }
 int         getFramesInLoop() { model::ClockLock lock(model::clock); return model::clock.get()->framesInLoop; }
 int         getFramesInBar()  { model::ClockLock lock(model::clock); return model::clock.get()->framesInBar; }
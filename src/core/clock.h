@@ -53,10 +53,6 @@ Rewinds timecode to beat 0 and also send a MTC full frame to cue the slave. */
 
 void sendMIDIrewind();
 
-#if defined(__linux__) || defined(__FreeBSD__)
-void recvJackSync();
-#endif
-
 float getBpm();
 int getBeats();
 int getBars();
@@ -67,14 +63,63 @@ int getFramesInBeat();
 int getFramesInLoop();
 int getFramesInSeq();
 int getQuantize();
-int getQuanto();
 ClockStatus getStatus();
 
+/* beginBlock
+Takes the clock parameters for the block about to be processed. The per-frame
+functions used by the sequencer (incrCurrentFrame, sendMIDIsync, isOnBeat, 
+isOnBar, quantoHasPassed) read them without locking the model: call it once 
+before the frame loop. Audio thread only. */
+
+void beginBlock();
+
+/* getBlockQuantize
+Same as getQuantize(), as taken by beginBlock() for the current block. Doesn't 
+lock: safe to call on every frame. Audio thread only. */
+
+int getBlockQuantize();
+
 /* incrCurrentFrame
-Increases current frame of a single step (+1). */
+Increases current frame of a single step (+1). The loop lasts framesInLoop 
+frames, one more when the fractional part of its length carried over from the
+previous loops adds up to a whole frame. Audio thread only. */
 
 void incrCurrentFrame();
 
+/* setCurrentFrame
+Moves the clock to frame 'f' of the loop, e.g. when an external master 
+relocates. Audio thread only. */
+
+void setCurrentFrame(int f);
+
+/* nudge
+Moves the clock by 'delta' frames to stay in phase with an external master, 
+without playing recorded actions twice or losing them. Going backwards mutes 
+actions until the clock is back where it was (see areActionsMuted); going 
+forward leaves the frames jumped over to getSkipped(). Nudges never cross the 
+first frame backwards, and land on it when crossing the end of the loop. Audio
+thread only. */
+
+void nudge(int delta);
+
+/* areActionsMuted
+True while the clock replays frames after a backward nudge(). Audio thread 
+only. */
+
+bool areActionsMuted();
+
+/* getSkipped
+Returns the range of frames [a, b) jumped over by the last forward nudge(), if
+any, and forgets it. Audio thread only. */
+
+bool getSkipped(int& a, int& b);
+
+/* trigger
+Starts a WAITING clock right away from frame 'f', as if it was RUNNING, until
+the main thread sets the status for real. Audio thread only. */
+
+void trigger(int f);
+
 /* quantoHasPassed
 Tells whether a quanto unit has passed yet. */
 
@@ -90,10 +135,17 @@ void setBeats(int beats, int bars);
 void setQuantize(int q);
 
 /* isRunning
-When clock is actually moving forward, i.e. ClockStatus == RUNNING. */
+When clock is actually moving forward, i.e. ClockStatus == RUNNING or it has
+been triggered while WAITING. */
 
 bool isRunning();
 
+/* isWaiting
+Clock is on hold, waiting for a trigger, i.e. ClockStatus == WAITING and the
+input signal has not started it yet. */
+
+bool isWaiting();
+
 /* isActive
 Clock is enabled, but might be in wait mode, i.e. ClockStatus == RUNNING or
 ClockStatus == WAITING. */
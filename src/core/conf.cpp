@@ -136,10 +136,13 @@ bool read()
 	conf.soundDeviceIn         =  j.value(CONF_KEY_SOUND_DEVICE_IN, conf.soundDeviceIn);
 	conf.channelsOut           =  j.value(CONF_KEY_CHANNELS_OUT, conf.channelsOut);
 	conf.channelsIn            =  j.value(CONF_KEY_CHANNELS_IN, conf.channelsIn);
+	conf.busesOut              =  j.value(CONF_KEY_BUSES_OUT, conf.busesOut);
+	conf.busesIn               =  j.value(CONF_KEY_BUSES_IN, conf.busesIn);
 	conf.samplerate            =  j.value(CONF_KEY_SAMPLERATE, conf.samplerate);
 	conf.buffersize            =  j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput           =  j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality           =  j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.jackTimebaseMaster    =  j.value(CONF_KEY_JACK_TIMEBASE_MASTER, conf.jackTimebaseMaster);
 	conf.midiSystem            =  j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut           =  j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn            =  j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -154,6 +157,7 @@ bool read()
 	conf.pluginPath            =  j.value(CONF_KEY_PLUGINS_PATH, conf.pluginPath);
 	conf.patchPath             =  j.value(CONF_KEY_PATCHES_PATH, conf.patchPath);
 	conf.samplePath            =  j.value(CONF_KEY_SAMPLES_PATH, conf.samplePath);
+	conf.sampleLibraryPath     =  j.value(CONF_KEY_SAMPLE_LIBRARY_PATH, conf.sampleLibraryPath);
 	conf.mainWindowX           =  j.value(CONF_KEY_MAIN_WINDOW_X, conf.mainWindowX);
 	conf.mainWindowY           =  j.value(CONF_KEY_MAIN_WINDOW_Y, conf.mainWindowY);
 	conf.mainWindowW           =  j.value(CONF_KEY_MAIN_WINDOW_W, conf.mainWindowW);
@@ -191,6 +195,7 @@ bool read()
 	conf.midiInputH            =  j.value(CONF_KEY_MIDI_INPUT_H, conf.midiInputH);
 	conf.recTriggerMode        =  j.value(CONF_KEY_REC_TRIGGER_MODE, conf.recTriggerMode);
 	conf.recTriggerLevel       =  j.value(CONF_KEY_REC_TRIGGER_LEVEL, conf.recTriggerLevel);
+	conf.recTriggerPreRoll     =  j.value(CONF_KEY_REC_TRIGGER_PRE_ROLL, conf.recTriggerPreRoll);
 	conf.midiInEnabled         =  j.value(CONF_KEY_MIDI_IN, conf.midiInEnabled);
 	conf.midiInFilter          =  j.value(CONF_KEY_MIDI_IN_FILTER, conf.midiInFilter);
 	conf.midiInRewind          =  j.value(CONF_KEY_MIDI_IN_REWIND, conf.midiInRewind);
@@ -231,10 +236,13 @@ bool write()
 	j[CONF_KEY_SOUND_DEVICE_IN]           = conf.soundDeviceIn;
 	j[CONF_KEY_CHANNELS_OUT]              = conf.channelsOut;
 	j[CONF_KEY_CHANNELS_IN]               = conf.channelsIn;
+	j[CONF_KEY_BUSES_OUT]                 = conf.busesOut;
+	j[CONF_KEY_BUSES_IN]                  = conf.busesIn;
 	j[CONF_KEY_SAMPLERATE]                = conf.samplerate;
 	j[CONF_KEY_BUFFER_SIZE]               = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]              = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]          = conf.rsmpQuality;
+	j[CONF_KEY_JACK_TIMEBASE_MASTER]      = conf.jackTimebaseMaster;
 	j[CONF_KEY_MIDI_SYSTEM]               = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]             = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]              = conf.midiPortIn;
@@ -260,6 +268,7 @@ bool write()
 	j[CONF_KEY_PLUGINS_PATH]              = conf.pluginPath;
 	j[CONF_KEY_PATCHES_PATH]              = conf.patchPath;
 	j[CONF_KEY_SAMPLES_PATH]              = conf.samplePath;
+	j[CONF_KEY_SAMPLE_LIBRARY_PATH]       = conf.sampleLibraryPath;
 	j[CONF_KEY_MAIN_WINDOW_X]             = conf.mainWindowX;
 	j[CONF_KEY_MAIN_WINDOW_Y]             = conf.mainWindowY;
 	j[CONF_KEY_MAIN_WINDOW_W]             = conf.mainWindowW;
@@ -297,6 +306,7 @@ bool write()
 	j[CONF_KEY_MIDI_INPUT_H]              = conf.midiInputH;
 	j[CONF_KEY_REC_TRIGGER_MODE]          = static_cast<int>(conf.recTriggerMode);
 	j[CONF_KEY_REC_TRIGGER_LEVEL]         = conf.recTriggerLevel;
+	j[CONF_KEY_REC_TRIGGER_PRE_ROLL]      = conf.recTriggerPreRoll;
 #ifdef WITH_VST
 	j[CONF_KEY_PLUGIN_CHOOSER_X]          = conf.pluginChooserX;
 	j[CONF_KEY_PLUGIN_CHOOSER_Y]          = conf.pluginChooserY;
@@ -41,16 +41,19 @@ namespace conf
 {
 struct Conf
 {
-	int  logMode        = LOG_MODE_MUTE;
-	int  soundSystem    = G_DEFAULT_SOUNDSYS;
-	int  soundDeviceOut = G_DEFAULT_SOUNDDEV_OUT;
-	int  soundDeviceIn  = G_DEFAULT_SOUNDDEV_IN;
-	int  channelsOut    = 0;
-	int  channelsIn     = 0;
-	int  samplerate     = G_DEFAULT_SAMPLERATE;
-	int  buffersize     = G_DEFAULT_BUFSIZE;
-	bool limitOutput    = false;
-	int  rsmpQuality    = 0;
+	int  logMode            = LOG_MODE_MUTE;
+	int  soundSystem        = G_DEFAULT_SOUNDSYS;
+	int  soundDeviceOut     = G_DEFAULT_SOUNDDEV_OUT;
+	int  soundDeviceIn      = G_DEFAULT_SOUNDDEV_IN;
+	int  channelsOut        = 0;
+	int  channelsIn         = 0;
+	int  busesOut           = 1;
+	int  busesIn            = 1;
+	int  samplerate         = G_DEFAULT_SAMPLERATE;
+	int  buffersize         = G_DEFAULT_BUFSIZE;
+	bool limitOutput        = false;
+	int  rsmpQuality        = 0;
+	bool jackTimebaseMaster = false;
 
 	int         midiSystem  = 0;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
@@ -68,6 +71,7 @@ struct Conf
 	std::string pluginPath;
 	std::string patchPath;
 	std::string samplePath;
+	std::string sampleLibraryPath;  // ';'-separated roots for the sample index
 
 	int mainWindowX = u::gui::centerWindowX(G_MIN_GUI_WIDTH);
 	int mainWindowY = u::gui::centerWindowY(G_MIN_GUI_HEIGHT);
@@ -112,8 +116,9 @@ struct Conf
 	int pluginListX;
 	int pluginListY;
 
-	RecTriggerMode recTriggerMode  = RecTriggerMode::NORMAL;
-	float          recTriggerLevel = G_DEFAULT_REC_TRIGGER_LEVEL;
+	RecTriggerMode recTriggerMode    = RecTriggerMode::NORMAL;
+	float          recTriggerLevel   = G_DEFAULT_REC_TRIGGER_LEVEL;
+	int            recTriggerPreRoll = 0; // ms
 
 	bool     midiInEnabled    = false;
 	int      midiInFilter     = -1;
@@ -95,6 +95,7 @@ constexpr auto   G_MAX_BPM_STR      = "999.0";
 constexpr int    G_MAX_BEATS        = 32;
 constexpr int    G_MAX_BARS         = 32;
 constexpr int    G_MAX_QUANTIZE     = 8;
+constexpr int    G_BEAT_SUBDIVISIONS = 840; // Multiple of every quantizer value and of the MIDI clock
 constexpr float  G_MIN_DB_SCALE     = 60.0f;
 constexpr int    G_MIN_COLUMN_WIDTH = 140;
 constexpr float  G_MAX_BOOST_DB     = 20.0f;
@@ -107,9 +108,20 @@ constexpr int    G_MAX_BUF_SIZE     = 4096;
 constexpr int    G_MIN_GUI_WIDTH    = 816;
 constexpr int    G_MIN_GUI_HEIGHT   = 510;
 constexpr int    G_MAX_IO_CHANS     = 2;
+constexpr int    G_MAX_IO_BUSES     = 8;
 constexpr int    G_MAX_VELOCITY     = 0x7F;
 constexpr int    G_MAX_MIDI_CHANS   = 16;
 constexpr int    G_MAX_POLYPHONY    = 32;
+constexpr int    G_MAX_TELEMETRY_CHANNELS = 1024;
+
+
+
+/* -- plug-ins -------------------------------------------------------------- */
+constexpr int  G_PLUGIN_MIDI_BUFFER_SIZE = 2048;   // bytes preallocated per MidiBuffer
+constexpr auto G_PLUGIN_SCAN_ARG         = "--scan-plugin";
+constexpr int  G_PLUGIN_SCAN_TIMEOUT     = 30000;  // ms before a scanner is killed
+constexpr int  G_PLUGIN_SCAN_POLL_RATE   = 20;     // ms
+constexpr int  G_PLUGIN_LOAD_POLL_RATE   = 10;     // ms
 
 
 
@@ -124,12 +136,28 @@ constexpr int G_SYS_API_PULSE  = 0x20;  // 0010 0000
 constexpr int G_SYS_API_WASAPI = 0x40;  // 0100 0000
 constexpr int G_SYS_API_ANY    = 0x7F;  // 0111 1111
 
+constexpr int G_JACK_EVENT_QUEUE_SIZE = 32;
+constexpr int G_JACK_SYNC_POLL_MS     = 2;
+constexpr int G_JACK_SYNC_TOLERANCE   = 16;    // frames
+constexpr int G_JACK_TICKS_PER_BEAT   = 1920;
+
 
 
 /* -- kernel midi ----------------------------------------------------------- */
 constexpr int G_MIDI_API_JACK = 0x01;  // 0000 0001
 constexpr int G_MIDI_API_ALSA = 0x02;  // 0000 0010
 
+constexpr int    G_MIDI_SYNC_QUEUE_SIZE    = 32;
+constexpr int    G_MIDI_SYNC_POLL_MS       = 2;
+constexpr int    G_MIDI_SYNC_TIMEOUT_MS    = 250;   // master gone if silent for so long
+constexpr int    G_MIDI_SYNC_TOLERANCE     = 128;   // frames
+constexpr double G_MIDI_SYNC_DLL_BANDWIDTH = 0.25;  // Hz
+constexpr float  G_MIDI_SYNC_BPM_STEP      = 0.05f;
+
+constexpr int    G_MAX_AUTOMATION_SLOTS    = 512;
+constexpr float  G_AUTOMATION_SMOOTHING_MS = 20.0f;
+constexpr float  G_AUTOMATION_EPSILON      = 0.0001f;
+
 
 
 /* -- default system -------------------------------------------------------- */
@@ -165,6 +193,25 @@ constexpr int   G_DEFAULT_ZOOM_RATIO        = 128;
 constexpr float G_DEFAULT_REC_TRIGGER_LEVEL = -10.0f;
 constexpr int   G_DEFAULT_SUBWINDOW_W       = 640;
 constexpr int   G_DEFAULT_SUBWINDOW_H       = 480;
+constexpr auto  G_RESAMPLE_CACHE_DIR        = "resample-cache";
+constexpr int   G_RESAMPLE_CACHE_MAX_SIZE   = 1024;   // megabytes
+constexpr int   G_RESAMPLE_CHUNK_SIZE       = 262144; // frames
+constexpr int   G_RESAMPLE_CHUNK_PAD        = 8192;   // frames
+constexpr auto  G_PEAK_CACHE_DIR            = "peak-cache";
+constexpr auto  G_SAMPLE_INDEX_FILE         = "sample-index.bin";
+constexpr int   G_SAMPLE_INDEX_MAX_DEPTH    = 32;
+constexpr int   G_SAMPLE_INDEX_READ_SIZE    = 8192;   // frames
+constexpr int   G_MAX_SEARCH_RESULTS        = 1000;
+constexpr int   G_AUDITION_HEAD_MS          = 300;
+constexpr int   G_AUDITION_HEAD_CACHE_SIZE  = 64;     // files
+constexpr int   G_AUDITION_RING_SIZE        = 32768;  // frames
+constexpr int   G_AUDITION_CHUNK_SIZE       = 4096;   // frames
+constexpr int   G_AUDITION_PREFETCH_LINES   = 4;
+constexpr auto  G_INPUT_REC_SPOOL_FILE      = "take-spool.wav";
+constexpr int   G_INPUT_REC_RING_SIZE       = 262144; // frames
+constexpr int   G_INPUT_REC_CHUNK_SIZE      = 1024;   // frames
+constexpr int   G_INPUT_REC_POLL_MS         = 10;
+constexpr int   G_INPUT_REC_MAX_PRE_ROLL_MS = 1000;
 
 
 
@@ -243,6 +290,7 @@ constexpr int G_MIDI_IN_SOLO         = 17;
 constexpr int G_MIDI_IN_VOLUME       = 18;
 constexpr int G_MIDI_IN_PITCH        = 19;
 constexpr int G_MIDI_IN_READ_ACTIONS = 20;
+constexpr int G_MIDI_IN_PLUGIN_PARAM = 21;
 
 
 
@@ -290,6 +338,8 @@ constexpr int G_MIDI_CHANS[G_MAX_MIDI_CHANS] = {
 #define MIDI_SYNC_MTC_M     0x04  // master
 #define MIDI_SYNC_MTC_S     0x08  // slave
 
+constexpr int G_MIDI_CLOCK_PPQN = 24;  // MIDI clocks per quarter note
+
 /* JSON patch keys */
 
 constexpr auto PATCH_KEY_HEADER                       = "header";
@@ -351,6 +401,8 @@ constexpr auto PATCH_KEY_CHANNEL_MIDI_OUT_CHAN        = "midi_out_chan";
 constexpr auto PATCH_KEY_CHANNEL_PLUGINS              = "plugins";
 constexpr auto PATCH_KEY_CHANNEL_PLUGIN_ID            = "plugin_id";
 constexpr auto PATCH_KEY_CHANNEL_ARMED                = "armed";
+constexpr auto PATCH_KEY_CHANNEL_OUT_BUS              = "out_bus";
+constexpr auto PATCH_KEY_CHANNEL_IN_BUS               = "in_bus";
 constexpr auto PATCH_KEY_WAVES                        = "waves";
 constexpr auto PATCH_KEY_WAVE_ID                      = "id";
 constexpr auto PATCH_KEY_WAVE_PATH                    = "path";
@@ -383,11 +435,14 @@ constexpr auto CONF_KEY_SOUND_DEVICE_IN          = "sound_device_in";
 constexpr auto CONF_KEY_SOUND_DEVICE_OUT         = "sound_device_out";
 constexpr auto CONF_KEY_CHANNELS_IN              = "channels_in";
 constexpr auto CONF_KEY_CHANNELS_OUT             = "channels_out";
+constexpr auto CONF_KEY_BUSES_IN                 = "buses_in";
+constexpr auto CONF_KEY_BUSES_OUT                = "buses_out";
 constexpr auto CONF_KEY_SAMPLERATE               = "samplerate";
 constexpr auto CONF_KEY_BUFFER_SIZE              = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION       = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT             = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY         = "resample_quality";
+constexpr auto CONF_KEY_JACK_TIMEBASE_MASTER     = "jack_timebase_master";
 constexpr auto CONF_KEY_MIDI_SYSTEM              = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT            = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN             = "midi_port_in";
@@ -413,6 +468,7 @@ constexpr auto CONF_KEY_INPUT_MONITOR_DEFAULT_ON = "input_monitor_default_on";
 constexpr auto CONF_KEY_PLUGINS_PATH             = "plugins_path";
 constexpr auto CONF_KEY_PATCHES_PATH             = "patches_path";
 constexpr auto CONF_KEY_SAMPLES_PATH             = "samples_path";
+constexpr auto CONF_KEY_SAMPLE_LIBRARY_PATH      = "sample_library_path";
 constexpr auto CONF_KEY_MAIN_WINDOW_X            = "main_window_x";
 constexpr auto CONF_KEY_MAIN_WINDOW_Y            = "main_window_y";
 constexpr auto CONF_KEY_MAIN_WINDOW_W            = "main_window_w";
@@ -455,6 +511,7 @@ constexpr auto CONF_KEY_MIDI_INPUT_H             = "midi_input_h";
 constexpr auto CONF_KEY_PLUGIN_SORT_METHOD       = "plugin_sort_method";
 constexpr auto CONF_KEY_REC_TRIGGER_MODE         = "rec_trigger_mode";
 constexpr auto CONF_KEY_REC_TRIGGER_LEVEL        = "rec_trigger_level";
+constexpr auto CONF_KEY_REC_TRIGGER_PRE_ROLL     = "rec_trigger_pre_roll";
 
 /* JSON midimaps keys */
 
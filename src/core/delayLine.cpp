@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <cassert>
+#include "delayLine.h"
+
+
+namespace giada {
+namespace m
+{
+DelayLine::DelayLine(Frame delay, int channels)
+: m_delay  (delay),
+  m_tracker(0)
+{
+	assert(delay >= 0);
+
+	if (m_delay > 0) {
+		m_buffer.alloc(m_delay, channels);
+		m_buffer.clear();
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Frame DelayLine::getDelay() const
+{
+	return m_delay;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void DelayLine::process(AudioBuffer& b)
+{
+	if (m_delay == 0)
+		return;
+
+	assert(b.countChannels() == m_buffer.countChannels());
+
+	for (int i=0; i<b.countFrames(); i++) {
+		float* in  = b[i];
+		float* mem = m_buffer[m_tracker];
+		for (int j=0; j<b.countChannels(); j++) {
+			float tmp = mem[j];
+			mem[j] = in[j];
+			in[j]  = tmp;
+		}
+		if (++m_tracker == m_delay)
+			m_tracker = 0;
+	}
+}
+}} // giada::m::
@@ -0,0 +1,68 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_DELAY_LINE_H
+#define G_DELAY_LINE_H
+
+
+#include "core/types.h"
+#include "core/audioBuffer.h"
+
+
+namespace giada {
+namespace m
+{
+/* DelayLine
+Fixed-length delay for interleaved audio buffers, used to compensate plug-in
+latency. Memory is allocated on construction only, so process() is safe to call
+from the audio thread. */
+
+class DelayLine
+{
+public:
+
+	DelayLine(Frame delay, int channels);
+
+	Frame getDelay() const;
+
+	/* process
+	Delays the content of buffer 'b' in place by 'delay' frames. 'b' must have
+	the same number of channels of the delay line. */
+
+	void process(AudioBuffer& b);
+
+private:
+
+	AudioBuffer m_buffer;
+	Frame       m_delay;
+	Frame       m_tracker;
+};
+}} // giada::m::
+
+
+#endif
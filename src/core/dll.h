@@ -0,0 +1,105 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_DLL_H
+#define G_DLL_H
+
+
+#include <cmath>
+
+
+namespace giada {
+namespace m
+{
+/* Dll
+Delay-locked loop. Filters the jitter out of the arrival times of a periodic 
+event, e.g. the MIDI clock, and tracks its actual period. 'bandwidth' (Hz) 
+trades jitter rejection for tracking speed. Source:
+	F. Adriaensen, "Using a DLL to filter time", 2005. */
+
+class Dll
+{
+public:
+
+	Dll(double bandwidth) 
+	: m_bandwidth(bandwidth), m_b(0.0), m_c(0.0), m_period(0.0), m_t0(0.0), 
+	  m_t1(0.0)
+	{
+	}
+
+
+	/* reset
+	Restarts the loop on an event at time 't', with a first guess of the 
+	period. */
+
+	void reset(double t, double period)
+	{
+		double omega = 2.0 * M_PI * m_bandwidth * period;
+		m_b      = std::sqrt(2.0) * omega;
+		m_c      = omega * omega;
+		m_period = period;
+		m_t0     = t;
+		m_t1     = t + period;
+	}
+
+
+	/* update
+	Feeds the arrival time 't' of a new event. */
+
+	void update(double t)
+	{
+		double e = t - m_t1;
+		m_t0      = m_t1;
+		m_t1     += m_b * e + m_period;
+		m_period += m_c * e;
+	}
+
+
+	/* getTime
+	Filtered time of the last event. */
+
+	double getTime() const { return m_t0; }
+
+	/* getNext
+	Expected time of the next event. */
+
+	double getNext() const { return m_t1; }
+
+	double getPeriod() const { return m_period; }
+
+private:
+
+	double m_bandwidth;
+	double m_b;
+	double m_c;
+	double m_period;
+	double m_t0;
+	double m_t1;
+};
+}} // giada::m::
+
+
+#endif
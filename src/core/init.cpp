@@ -28,6 +28,7 @@
 #include <thread>
 #include <atomic>
 #include <ctime>
+#include <algorithm>
 #ifdef __APPLE__
 	#include <pwd.h>
 #endif
@@ -55,6 +56,10 @@
 #include "core/patch.h"
 #include "core/conf.h"
 #include "core/waveManager.h"
+#include "core/peakCache.h"
+#include "core/sampleIndex.h"
+#include "core/audition.h"
+#include "core/inputRec.h"
 #include "core/pluginManager.h"
 #include "core/pluginHost.h"
 #include "core/recorder.h"
@@ -63,6 +68,8 @@
 #include "core/midiMapConf.h"
 #include "core/kernelMidi.h"
 #include "core/kernelAudio.h"
+#include "core/jackTransport.h"
+#include "core/midiSync.h"
 #include "init.h"
 
 
@@ -89,6 +96,11 @@ void initConf_()
 
 	if (midimap::read(conf::conf.midiMapPath) != MIDIMAP_READ_OK)
 		u::log::print("[init] MIDI map read failed!\n");
+
+	waveManager::setResampleCachePath(u::fs::getHomePath() + G_SLASH + G_RESAMPLE_CACHE_DIR);
+	peakCache::init(u::fs::getHomePath() + G_SLASH + G_PEAK_CACHE_DIR);
+	sampleIndex::init(u::fs::getHomePath() + G_SLASH + G_SAMPLE_INDEX_FILE);
+	sampleIndex::start(conf::conf.sampleLibraryPath);
 }
 
 
@@ -102,6 +114,9 @@ void initAudio_()
 	mh::init();
 	recorder::init();
 	recorderHandler::init();
+	audition::init(conf::conf.samplerate);
+	inputRec::init(u::fs::getHomePath() + G_SLASH + G_INPUT_REC_SPOOL_FILE, conf::conf.samplerate,
+		std::max(kernelAudio::countBusesIn(), 1) * G_MAX_IO_CHANS);
 
 #ifdef WITH_VST
 
@@ -113,6 +128,11 @@ void initAudio_()
 	if (!kernelAudio::isReady())
 		return;
 
+#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
+	jackTransport::init();
+#endif
+	midiSync::init();
+
 	mixer::enable();
 	kernelAudio::startStream();
 }
@@ -166,10 +186,17 @@ void shutdownAudio_()
 	if (kernelAudio::isReady()) {
 		kernelAudio::closeDevice();
 		u::log::print("[init] KernelAudio closed\n");
+#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
+		jackTransport::close();
+#endif
+		midiSync::close();
 		mh::close();
 		u::log::print("[init] Mixer closed\n");
 	}
 
+	audition::close();
+	inputRec::close();
+
 	/* TODO - why cleaning plug-ins and mixer memory? Just shutdown the audio
 	device and let the OS take care of the rest. */
 
@@ -285,6 +312,8 @@ void shutdown()
 
 	shutdownAudio_();
 
+	sampleIndex::stop();
+
 	u::log::print("[init] Giada %s closed\n\n", G_VERSION_STR);
 	u::log::close();
 }
@@ -0,0 +1,432 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <sndfile.h>
+#include "utils/log.h"
+#include "core/const.h"
+#include "core/audioBuffer.h"
+#include "core/ringBuffer.h"
+#include "inputRec.h"
+
+
+namespace giada {
+namespace m {
+namespace inputRec
+{
+namespace
+{
+/* Frames travel interleaved through ring_, from the audio thread to the disk 
+writer. */
+
+std::unique_ptr<RingBuffer<float>> ring_;
+
+std::string path_;
+int         samplerate_ = 0;
+int         channels_   = 0;
+
+/* Scratch buffers for interleaving, preallocated in init(). chunk_ belongs to
+the audio thread, diskChunk_ to the disk writer. */
+
+std::vector<float> chunk_;
+std::vector<float> diskChunk_;
+
+/* Input history, i.e. the last historySize_ frames seen by listen(): the 
+pre-roll of takes started by trigger(). Audio thread only. */
+
+std::vector<float> history_;
+Frame              historySize_ = 0;
+Frame              historyPos_  = 0;
+Frame              historyFill_ = 0;
+
+/* Take state, written by start() and read by the disk writer. A new 
+generation_ means a new take to open, starting on loop frame offset_. */
+
+std::atomic<bool>     recording_(false);
+std::atomic<bool>     writing_(false);
+std::atomic<unsigned> generation_(0);
+std::atomic<Frame>    offset_(0);
+std::atomic<Frame>    dropped_(0);
+
+std::atomic<Frame> punchIn_(-1);
+std::atomic<Frame> punchOut_(-1);
+
+/* Disk writer state. */
+
+std::thread             writer_;
+std::mutex              mutex_;
+std::condition_variable cond_;
+bool                    quit_   = false;
+bool                    flush_  = false;  // stop() is waiting for the take
+SNDFILE*                file_   = nullptr;
+unsigned                opened_ = 0;      // Generation of file_
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isPunchedIn_(Frame pos, Frame in, Frame out)
+{
+	if (in < 0)
+		return true;
+	return in <= out ? pos >= in && pos < out : pos >= in || pos < out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* pushChunk_
+Moves the first 'count' frames of chunk_ into the ring. Audio thread. */
+
+void pushChunk_(Frame count)
+{
+	size_t samples = count * channels_;
+	size_t pushed  = ring_->write(chunk_.data(), samples);
+	if (pushed < samples)
+		dropped_ += (samples - pushed) / channels_;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* push_
+Pushes block 'in' into the ring, from its frame 'first' on. 'frame' is the loop
+position of frame 'first', used to apply the punch range. Audio thread. */
+
+void push_(const AudioBuffer& in, Frame first, Frame frame, Frame framesInLoop, 
+	float volume)
+{
+	const Frame punchIn  = punchIn_.load();
+	const Frame punchOut = punchOut_.load();
+
+	assert(in.countChannels() == channels_);
+
+	for (Frame i = first; i < in.countFrames(); ) {
+		Frame count = std::min(in.countFrames() - i, G_INPUT_REC_CHUNK_SIZE);
+		for (Frame k = 0; k < count; k++) {
+			bool on = isPunchedIn_((frame + i - first + k) % framesInLoop, punchIn, punchOut);
+			for (int j = 0; j < channels_; j++)
+				chunk_[k * channels_ + j] = on ? in[i + k][j] * volume : 0.0f;
+		}
+		pushChunk_(count);
+		i += count;
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* open_
+Creates the spool file for a new take and fills it with silence up to the
+take offset. Writer thread. */
+
+void open_(unsigned generation)
+{
+	SF_INFO header = {};
+	header.samplerate = samplerate_;
+	header.channels   = channels_;
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	opened_ = generation;
+	file_   = sf_open(path_.c_str(), SFM_WRITE, &header);
+	if (file_ == nullptr) {
+		u::log::print("[inputRec::open_] unable to open %s\n", path_.c_str());
+		return;
+	}
+
+	std::fill(diskChunk_.begin(), diskChunk_.end(), 0.0f);
+	for (Frame f = offset_.load(); f > 0; f -= G_INPUT_REC_CHUNK_SIZE)
+		sf_writef_float(file_, diskChunk_.data(), std::min(f, G_INPUT_REC_CHUNK_SIZE));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* drain_
+Moves everything available in the ring to the spool file. Writer thread. */
+
+void drain_()
+{
+	size_t count;
+	while ((count = ring_->read(diskChunk_.data(), diskChunk_.size())) > 0)
+		if (file_ != nullptr)
+			sf_writef_float(file_, diskChunk_.data(), count / channels_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void work_()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+
+	while (!quit_) {
+		cond_.wait_for(lock, std::chrono::milliseconds(G_INPUT_REC_POLL_MS));
+
+		if (opened_ != generation_.load())
+			open_(generation_.load());
+		drain_();
+
+		if (flush_) {
+			if (file_ != nullptr)
+				sf_close(file_);
+			file_  = nullptr;
+			flush_ = false;
+			cond_.notify_all();
+		}
+	}
+
+	if (file_ != nullptr)
+		sf_close(file_);
+	file_ = nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* read_
+Loads the spool file 'path_' into 'out'. The buffer is rounded up to a multiple 
+of 'framesInLoop', the tail left silent. */
+
+bool read_(AudioBuffer& out, Frame framesInLoop)
+{
+	SF_INFO  header = {};
+	SNDFILE* file   = sf_open(path_.c_str(), SFM_READ, &header);
+	if (file == nullptr)
+		return false;
+
+	Frame frames = static_cast<Frame>(header.frames);
+	if (framesInLoop > 0 && frames % framesInLoop != 0)
+		frames += framesInLoop - (frames % framesInLoop);
+
+	bool ok = frames > 0 && header.channels == channels_;
+	if (ok) {
+		out.alloc(frames, channels_);
+		out.clear();
+		ok = sf_readf_float(file, out[0], header.frames) == header.frames;
+	}
+
+	sf_close(file);
+	std::remove(path_.c_str());
+	return ok;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init(const std::string& path, int samplerate, int channels)
+{
+	path_       = path;
+	samplerate_ = samplerate;
+	channels_   = channels;
+	ring_       = std::make_unique<RingBuffer<float>>(G_INPUT_REC_RING_SIZE * channels);
+	chunk_.assign(G_INPUT_REC_CHUNK_SIZE * channels, 0.0f);
+	diskChunk_.assign(G_INPUT_REC_CHUNK_SIZE * channels, 0.0f);
+	historySize_ = (samplerate * G_INPUT_REC_MAX_PRE_ROLL_MS) / 1000;
+	historyPos_  = 0;
+	historyFill_ = 0;
+	history_.assign(historySize_ * channels, 0.0f);
+	quit_       = false;
+	opened_     = generation_.load();
+	writer_     = std::thread(work_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close()
+{
+	recording_.store(false);
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		quit_ = true;
+	}
+	cond_.notify_all();
+	if (writer_.joinable())
+		writer_.join();
+	std::remove(path_.c_str());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void start(Frame offset)
+{
+	if (ring_ == nullptr || recording_.load())
+		return;
+	offset_.store(offset);
+	dropped_.store(0);
+	generation_++;
+	recording_.store(true);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool stop(AudioBuffer& out, Frame framesInLoop)
+{
+	if (!recording_.load())
+		return false;
+	recording_.store(false);
+
+	/* Let the audio thread finish the block it might be writing. */
+
+	while (writing_.load())
+		std::this_thread::yield();
+
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		flush_ = true;
+		cond_.notify_all();
+		cond_.wait(lock, [] { return !flush_; });
+	}
+
+	if (dropped_.load() > 0)
+		u::log::print("[inputRec::stop] disk writer too slow, %d frames dropped\n", 
+			dropped_.load());
+
+	return read_(out, framesInLoop);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void setPunch(Frame in, Frame out)
+{
+	punchOut_.store(out);
+	punchIn_.store(in);
+}
+
+
+void clearPunch()
+{
+	punchIn_.store(-1);
+	punchOut_.store(-1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isRecording()
+{
+	return recording_.load();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void write(const AudioBuffer& in, Frame frame, Frame framesInLoop, float volume)
+{
+	writing_.store(true);
+
+	if (recording_.load() && framesInLoop > 0)
+		push_(in, 0, frame, framesInLoop, volume);
+
+	writing_.store(false);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void listen(const AudioBuffer& in)
+{
+	if (historySize_ == 0)
+		return;
+
+	assert(in.countChannels() == channels_);
+
+	for (Frame i = 0; i < in.countFrames(); i++) {
+		std::copy(in[i], in[i] + channels_, history_.begin() + historyPos_ * channels_);
+		historyPos_ = (historyPos_ + 1) % historySize_;
+	}
+	historyFill_ = std::min(historyFill_ + in.countFrames(), historySize_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void trigger(const AudioBuffer& in, Frame from, Frame preRoll, Frame framesInLoop, 
+	float volume)
+{
+	writing_.store(true);
+
+	if (ring_ == nullptr || recording_.load() || framesInLoop <= 0) {
+		writing_.store(false);
+		return;
+	}
+
+	/* Frames of pre-roll that precede the block come from the history. What the
+	history can't provide (e.g. the input has just been enabled) becomes 
+	silence, so that the take stays aligned to the clock. */
+
+	const Frame before    = std::max(preRoll - from, 0);
+	const Frame available = std::min(before, historyFill_);
+
+	start(before - available);
+
+	Frame pos = (historyPos_ - available + historySize_) % std::max(historySize_, 1);
+	for (Frame i = 0; i < available; ) {
+		Frame count = std::min(available - i, G_INPUT_REC_CHUNK_SIZE);
+		for (Frame k = 0; k < count; k++, pos = (pos + 1) % historySize_)
+			for (int j = 0; j < channels_; j++)
+				chunk_[k * channels_ + j] = history_[pos * channels_ + j] * volume;
+		pushChunk_(count);
+		i += count;
+	}
+
+	push_(in, std::max(from - preRoll, 0), before, framesInLoop, volume);
+
+	writing_.store(false);
+}
+}}} // giada::m::inputRec::
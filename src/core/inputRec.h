@@ -0,0 +1,100 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_INPUT_REC_H
+#define G_INPUT_REC_H
+
+
+#include <string>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m 
+{
+class AudioBuffer;
+namespace inputRec
+{
+/* init
+Allocates the recording ring and starts the disk writer. Takes are spooled to
+the file 'path' while recording, at 'samplerate', with all the 'channels' of 
+the input device. */
+
+void init(const std::string& path, int samplerate, int channels);
+
+/* close
+Stops the disk writer, discarding any take in progress. */
+
+void close();
+
+/* start
+Starts a new take on loop frame 'offset': the take is padded with silence up to
+there, so that it stays aligned to the loop. Never blocks nor allocates, it can
+be called from the audio thread. */
+
+void start(Frame offset);
+
+/* stop
+Ends the current take and waits for the disk writer to flush it. Fills 'out' 
+with the whole take, rounded up to a multiple of 'framesInLoop' and with as
+many channels as given to init(). Returns false if there was nothing 
+recorded. */
+
+bool stop(AudioBuffer& out, Frame framesInLoop);
+
+/* setPunch, clearPunch
+Records only while the loop position is within [in, out), silence otherwise. 
+The range can wrap around the end of the loop, i.e. in > out. */
+
+void setPunch(Frame in, Frame out);
+void clearPunch();
+
+bool isRecording();
+
+/* write
+Pushes the block 'in' into the ring. 'frame' is the loop position of its first
+frame. Audio thread only. */
+
+void write(const AudioBuffer& in, Frame frame, Frame framesInLoop, float volume);
+
+/* listen
+Keeps the block 'in' in the input history, so that the next trigger() can 
+record what was played right before it. Audio thread only, for every block. */
+
+void listen(const AudioBuffer& in);
+
+/* trigger
+Starts a take on frame 'from' of block 'in', including 'preRoll' frames of 
+input before it. Frame 'from' lands on loop position 'preRoll'. Call it before
+listen() for the same block. Audio thread only. */
+
+void trigger(const AudioBuffer& in, Frame from, Frame preRoll, Frame framesInLoop, 
+	float volume);
+}}} // giada::m::inputRec::
+
+
+#endif
@@ -0,0 +1,257 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include "glue/main.h"
+#include "utils/log.h"
+#include "core/queue.h"
+#include "core/const.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/kernelAudio.h"
+#include "core/mixerHandler.h"
+#include "jackTransport.h"
+
+
+#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
+
+
+namespace giada {
+namespace m {
+namespace jackTransport
+{
+namespace
+{
+struct Event
+{
+	enum class Type { START, STOP, REWIND, BPM };
+
+	Type  type;
+	float bpm;
+};
+
+/* events_
+Transport changes, from the audio thread to the control thread. */
+
+Queue<Event, G_JACK_EVENT_QUEUE_SIZE> events_;
+
+/* prev_
+Last transport state seen by the audio thread. */
+
+kernelAudio::JackState prev_ = {};
+
+/* rewindPending_
+A rewind still to be posted to the control thread, because the queue was full.
+Audio thread only. */
+
+bool rewindPending_ = false;
+
+std::thread       worker_;
+std::atomic<bool> running_(false);
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool post_(Event::Type type, float bpm=0.0f)
+{
+	return events_.push({ type, bpm });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* process_
+Applies the pending events. Tempo changes are coalesced: when the master 
+ramps the tempo only the last value is worth the action map rebuild. */
+
+void process_()
+{
+	Event e;
+	float bpm = 0.0f;
+
+	while (events_.pop(e)) {
+		switch (e.type) {
+			case Event::Type::START:
+				if (!clock::isRunning())
+					mh::startSequencer();
+				break;
+			case Event::Type::STOP:
+				if (clock::isRunning())
+					mh::stopSequencer();
+				break;
+			case Event::Type::REWIND:
+				mh::rewindChannels();
+				break;
+			case Event::Type::BPM:
+				bpm = e.bpm;
+				break;
+		}
+	}
+
+	if (bpm > 0.0f)
+		c::main::setBpm(bpm);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* follow_
+Keeps the clock in phase with the transport master. The loop position is 
+taken from the BBT info when available, mapped on the current loop length, so 
+that it holds even while a tempo change is on its way to the clock; from the
+plain JACK frame otherwise. Offsets within G_JACK_SYNC_TOLERANCE frames are 
+left alone. Larger ones are nudged, so that recorded actions in between are 
+neither replayed nor lost. */
+
+void follow_(const kernelAudio::JackState& state)
+{
+	const Frame framesInLoop = clock::getFramesInLoop();
+	const int   beats        = clock::getBeats();
+	const Frame current      = clock::getCurrentFrame();
+
+	/* The first frame of the loop is where loops and queued channels start: 
+	never jump away from it before it has been played. */
+
+	if (framesInLoop <= 0 || current == 0)
+		return;
+
+	Frame expected;
+	if (state.bbt && state.ticksPerBeat > 0) {
+		double beat = (state.bar - 1) * static_cast<double>(state.beatsPerBar) + 
+		              (state.beat - 1) + (state.tick / state.ticksPerBeat);
+		expected = static_cast<Frame>(std::fmod(beat, beats) * framesInLoop / beats);
+	}
+	else
+		expected = state.frame % static_cast<uint32_t>(framesInLoop);
+
+	Frame delta = expected - current;
+	if      (delta >  framesInLoop / 2) delta -= framesInLoop;
+	else if (delta < -framesInLoop / 2) delta += framesInLoop;
+
+	if (std::abs(delta) <= G_JACK_SYNC_TOLERANCE)
+		return;
+
+	/* Lagging behind across the end of the loop: nudge() lands on the first 
+	frame, so that the new loop starts as usual. The remaining offset is 
+	recovered on the next callback. */
+
+	clock::nudge(delta);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void run_()
+{
+	while (running_.load()) {
+		process_();
+		std::this_thread::sleep_for(std::chrono::milliseconds(G_JACK_SYNC_POLL_MS));
+	}
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init()
+{
+	if (kernelAudio::getAPI() != G_SYS_API_JACK || running_.load())
+		return;
+	kernelAudio::jackSetTimebaseMaster(conf::conf.jackTimebaseMaster);
+	prev_          = {};
+	rewindPending_ = false;
+	running_.store(true);
+	worker_ = std::thread(run_);
+	u::log::print("[jackTransport::init] control thread started\n");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close()
+{
+	if (!running_.load())
+		return;
+	running_.store(false);
+	worker_.join();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void recvJackSync()
+{
+	const kernelAudio::JackState& state = kernelAudio::jackTransportQuery();
+	const bool                    master = kernelAudio::jackIsTimebaseMaster();
+
+	/* Each change is marked as seen only once posted: if the queue is full it
+	will be retried on the next callback. */
+
+	if (state.running != prev_.running)
+		if (post_(state.running ? Event::Type::START : Event::Type::STOP))
+			prev_.running = state.running;
+
+	/* As timebase master the tempo published is Giada's own one. */
+
+	if (state.bpm != prev_.bpm) {
+		if (master || state.bpm <= 1.0f || post_(Event::Type::BPM, state.bpm)) // 0 bpm if Jack does not send that info
+			prev_.bpm = state.bpm;
+	}
+
+	/* The clock is rewound right here, so that the next frame played is the
+	first one of the loop. Channels follow from the control thread: rewinds not
+	posted yet are coalesced into a single one. */
+
+	if (state.frame == 0 && state.frame != prev_.frame) {
+		clock::rewind();
+		rewindPending_ = true;
+	}
+	else
+	if (state.running && !master && clock::isRunning() && !clock::isWaiting())
+		follow_(state);
+
+	if (rewindPending_ && post_(Event::Type::REWIND))
+		rewindPending_ = false;
+
+	prev_.frame = state.frame;
+}
+}}} // giada::m::jackTransport::
+
+
+#endif
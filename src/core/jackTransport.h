@@ -0,0 +1,65 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_JACK_TRANSPORT_H
+#define G_JACK_TRANSPORT_H
+
+
+#include "core/const.h"
+
+
+#if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
+
+
+namespace giada {
+namespace m {
+namespace jackTransport
+{
+/* init
+Starts the control thread that applies JACK transport changes to the 
+sequencer and takes the timebase master role, if configured so. Call it once 
+the JACK device is open. */
+
+void init();
+
+/* close
+Stops the control thread. Call it after the audio device has been closed. */
+
+void close();
+
+/* recvJackSync
+Polls the JACK transport and posts the changes found to the control thread.
+The only things done here are the clock position updates, i.e. rewinds and, 
+when Giada is not the timebase master, phase corrections, so that the position
+stays sample-accurate. Audio thread only: never blocks nor allocates. */
+
+void recvJackSync();
+}}} // giada::m::jackTransport::
+
+
+#endif
+#endif
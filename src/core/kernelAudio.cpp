@@ -27,12 +27,16 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <atomic>
+#include <algorithm>
 #include "deps/rtaudio/RtAudio.h"
 #include "utils/log.h"
+#include "utils/math.h"
 #include "glue/main.h"
 #include "core/model/model.h"
 #include "conf.h"
 #include "mixer.h"
+#include "clock.h"
 #include "const.h"
 #include "kernelAudio.h"
 
@@ -48,16 +52,117 @@ unsigned numDevs      = 0;
 bool     inputEnabled = false;
 unsigned realBufsize  = 0;     // Real buffer size from the soundcard
 int      api          = 0;
+int      busesOut     = 1;     // Stereo buses actually opened
+int      busesIn      = 0;
+
+
+/* countBuses_
+Returns how many stereo buses fit in a device with 'maxChans' channels, starting
+from pair 'first'. Never less than one: RtAudio will complain on its own if the
+device can't even host the first pair. */
+
+int countBuses_(unsigned maxChans, int first, int wanted)
+{
+	int avail = static_cast<int>(maxChans) / G_MAX_IO_CHANS - first;
+	return std::max(1, std::min({ wanted, avail, G_MAX_IO_BUSES }));
+}
 
 #if defined(__linux__) || defined(__FreeBSD__)
 
 JackState jackState;
+std::atomic<bool> jackTimebaseMaster(false);
 
 jack_client_t* jackGetHandle()
 {
 	return static_cast<jack_client_t*>(rtSystem->HACK__getJackClient());
 }
 
+
+/* jackLoops_, jackLastFrame_, jackNewMaster_
+Loops played since the last relocation and clock position at the previous 
+cycle, for the bar count published as timebase master. jackNewMaster_ flags the
+first cycle after taking over the role. JACK process thread only, apart from 
+jackNewMaster_. */
+
+uint32_t          jackLoops_     = 0;
+Frame             jackLastFrame_ = 0;
+std::atomic<bool> jackNewMaster_(false);
+
+
+/* jackTimebaseCb
+Fills the BBT fields of 'pos' from Giada's own clock, so that the position 
+published is the very same grid the sequencer plays on, whatever the tempo 
+changes. The callback runs right after the process one: the clock is already on
+the first frame of the next cycle, i.e. pos->frame. A relocation requested by 
+any client moves the clock along. JACK process thread. */
+
+void jackTimebaseCb(jack_transport_state_t state, jack_nframes_t nframes, 
+	jack_position_t* pos, int newPos, void* arg)
+{
+	Frame framesInLoop;
+	Frame framesInBeat;
+	int   bars;
+	int   beats;
+	float bpm;
+	{
+		model::ClockLock lock(model::clock);
+		const model::Clock* c = model::clock.get();
+		framesInLoop = c->framesInLoop;
+		framesInBeat = c->framesInBeat;
+		bars         = c->bars;
+		beats        = c->beats;
+		bpm          = c->bpm;
+	}
+
+	if (framesInLoop <= 0 || framesInBeat <= 0)
+		return;
+
+	Frame inLoop;
+
+	if (jackNewMaster_.exchange(false)) {
+		jackLoops_ = 0;
+		inLoop     = clock::getCurrentFrame();
+	}
+	else
+	if (newPos) {
+		jackLoops_ = pos->frame / framesInLoop;
+		inLoop     = pos->frame % framesInLoop;
+		clock::setCurrentFrame(inLoop);
+	}
+	else {
+		inLoop = clock::getCurrentFrame();
+		if (inLoop < jackLastFrame_)
+			jackLoops_++;
+	}
+	jackLastFrame_ = inLoop;
+
+	/* The extra frame of a loop that carries the fractional length over (see 
+	clock::incrCurrentFrame) belongs to the last beat. */
+
+	inLoop = std::min(inLoop, framesInLoop - 1);
+
+	/* Beats are counted on the integer grid of each bar, so that a bar made of 
+	a fractional number of beats (e.g. 7 beats over 2 bars) ends with a shorter
+	beat. */
+
+	int   barInLoop = u::math::gridIndex(inLoop, framesInLoop, bars);
+	Frame inBar     = inLoop - u::math::gridFrame(barInLoop, framesInLoop, bars);
+	int   beat      = inBar / framesInBeat;
+	Frame inBeat    = inBar - beat * framesInBeat;
+
+	uint32_t bar = jackLoops_ * bars + barInLoop;
+
+	pos->valid            = static_cast<jack_position_bits_t>(pos->valid | JackPositionBBT);
+	pos->beats_per_bar    = beats / static_cast<float>(bars);
+	pos->beat_type        = 4.0f;
+	pos->ticks_per_beat   = G_JACK_TICKS_PER_BEAT;
+	pos->beats_per_minute = bpm;
+	pos->bar              = bar + 1;
+	pos->beat             = beat + 1;
+	pos->tick             = (static_cast<uint64_t>(inBeat) * G_JACK_TICKS_PER_BEAT) / framesInBeat;
+	pos->bar_start_tick   = bar * pos->beats_per_bar * G_JACK_TICKS_PER_BEAT;
+}
+
 #endif
 };  // {anonymous}
 
@@ -75,6 +180,12 @@ bool isReady()
 }
 
 
+bool isRunning()
+{
+	return rtSystem != nullptr && rtSystem->isStreamOpen() && rtSystem->isStreamRunning();
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -144,20 +255,29 @@ int openDevice()
 	RtAudio::StreamParameters outParams;
 	RtAudio::StreamParameters inParams;
 
+	/* Buses are consecutive stereo pairs, starting from the one selected as
+	output (or input) channels. */
+
 	outParams.deviceId     = conf::conf.soundDeviceOut == G_DEFAULT_SOUNDDEV_OUT ? getDefaultOut() : conf::conf.soundDeviceOut;
-	outParams.nChannels    = G_MAX_IO_CHANS;
+	busesOut               = countBuses_(getMaxOutChans(outParams.deviceId), conf::conf.channelsOut, conf::conf.busesOut);
+	outParams.nChannels    = busesOut * G_MAX_IO_CHANS;
 	outParams.firstChannel = conf::conf.channelsOut * G_MAX_IO_CHANS; // chan 0=0, 1=2, 2=4, ...
 
 	/* inDevice can be disabled. */
 
 	if (conf::conf.soundDeviceIn != -1) {
 		inParams.deviceId     = conf::conf.soundDeviceIn;
-		inParams.nChannels    = G_MAX_IO_CHANS;
+		busesIn               = countBuses_(getMaxInChans(inParams.deviceId), conf::conf.channelsIn, conf::conf.busesIn);
+		inParams.nChannels    = busesIn * G_MAX_IO_CHANS;
 		inParams.firstChannel = conf::conf.channelsIn * G_MAX_IO_CHANS;   // chan 0=0, 1=2, 2=4, ...
 		inputEnabled = true;
 	}
-	else
+	else {
+		busesIn      = 0;
 		inputEnabled = false;
+	}
+
+	u::log::print("[KA] %d output bus(es), %d input bus(es)\n", busesOut, busesIn);
 
 	RtAudio::StreamOptions options;
 	options.streamName = G_APP_NAME;
@@ -258,6 +378,9 @@ int closeDevice()
 		delete rtSystem;
 		rtSystem = nullptr;
 	}
+#if defined(__linux__) || defined(__FreeBSD__)
+	jackTimebaseMaster.store(false);  // Released by JACK along with the client
+#endif
 	return 1;
 }
 
@@ -384,6 +507,8 @@ int	getFreq(unsigned dev, int i)
 unsigned getRealBufSize() { return realBufsize; }
 bool isInputEnabled() { return inputEnabled; }
 unsigned countDevices() { return numDevs; }
+int countBusesOut() { return busesOut; }
+int countBusesIn() { return busesIn; }
 
 
 /* -------------------------------------------------------------------------- */
@@ -442,8 +567,18 @@ const JackState &jackTransportQuery()
 	jack_position_t position;
 	jack_transport_state_t ts = jack_transport_query(jackGetHandle(), &position);
 	jackState.running = ts != JackTransportStopped;
-	jackState.bpm     = position.beats_per_minute;
 	jackState.frame   = position.frame;
+	jackState.bbt     = position.valid & JackPositionBBT;
+	if (jackState.bbt) {
+		jackState.bpm          = position.beats_per_minute;
+		jackState.bar          = position.bar;
+		jackState.beat         = position.beat;
+		jackState.tick         = position.tick;
+		jackState.beatsPerBar  = position.beats_per_bar;
+		jackState.ticksPerBeat = position.ticks_per_beat;
+	}
+	else
+		jackState.bpm = 0.0;  // No tempo info from the master
 	return jackState;
 }
 
@@ -499,6 +634,37 @@ void jackStop()
 		jack_transport_stop(jackGetHandle());
 }
 
+
+/* -------------------------------------------------------------------------- */
+
+
+bool jackSetTimebaseMaster(bool v)
+{
+	if (api != G_SYS_API_JACK || v == jackTimebaseMaster.load())
+		return true;
+
+	if (v) {
+		/* conditional = 0: take over the role even if another client owns it. */
+		jackNewMaster_.store(true);
+		if (jack_set_timebase_callback(jackGetHandle(), 0, jackTimebaseCb, nullptr) != 0) {
+			u::log::print("[KA] unable to become JACK timebase master\n");
+			return false;
+		}
+	}
+	else
+		jack_release_timebase(jackGetHandle());
+
+	jackTimebaseMaster.store(v);
+	u::log::print("[KA] JACK timebase master: %d\n", v);
+	return true;
+}
+
+
+bool jackIsTimebaseMaster()
+{
+	return jackTimebaseMaster.load();
+}
+
 #endif  // defined(__linux__) || defined(__FreeBSD__)
 
 }}}; // giada::m::kernelAudio
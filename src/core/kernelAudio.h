@@ -48,6 +48,15 @@ struct JackState
   bool running;
   double bpm;
   uint32_t frame;
+
+  /* BBT position, if published by the timebase master (bbt == true). */
+
+  bool bbt;
+  int32_t bar;
+  int32_t beat;
+  int32_t tick;
+  float beatsPerBar;
+  double ticksPerBeat;
 };
 
 #endif
@@ -58,6 +67,13 @@ int startStream();
 int stopStream();
 
 bool isReady();
+
+/* isRunning
+Whether the stream is open and running, i.e. the audio callback is being 
+called. */
+
+bool isRunning();
+
 bool isProbed(unsigned dev);
 bool isDefaultIn(unsigned dev);
 bool isDefaultOut(unsigned dev);
@@ -76,6 +92,13 @@ int getDefaultIn();
 bool hasAPI(int API);
 int getAPI();
 
+/* countBuses[Out/In]
+Number of stereo buses opened on the output and input devices. No input buses
+if the input device is disabled. */
+
+int countBusesOut();
+int countBusesIn();
+
 #if defined(__linux__) || defined(__FreeBSD__)
 
 void jackStart();
@@ -84,6 +107,13 @@ void jackSetPosition(uint32_t frame);
 void jackSetBpm(double bpm);
 const JackState &jackTransportQuery();
 
+/* jackSetTimebaseMaster
+Makes Giada the JACK timebase master, publishing its own BBT position and 
+tempo to the other clients, or releases the role. Returns false on failure. */
+
+bool jackSetTimebaseMaster(bool v);
+bool jackIsTimebaseMaster();
+
 #endif
 }}}; // giada::m::kernelAudio::
 
@@ -32,7 +32,10 @@
 #include <rtmidi/RtMidi.h>
 #endif
 #include "utils/log.h"
+#include "const.h"
+#include "conf.h"
 #include "midiDispatcher.h"
+#include "midiSync.h"
 #include "midiMapConf.h"
 #include "kernelMidi.h"
 
@@ -53,6 +56,13 @@ unsigned numInPorts_  = 0;
 
 static void callback_(double t, std::vector<unsigned char>* msg, void* data)
 {
+	/* System messages (clock, transport, time code) are for the sync slave. */
+
+	if (msg->size() > 0 && msg->at(0) >= MIDI_SYSEX) {
+		midiSync::receive(*msg);
+		return;
+	}
+
 	if (msg->size() < 3) {
 		//u::log::print("[KM] MIDI received - unknown signal - size=%d, value=0x", (int) msg->size());
 		//for (unsigned i=0; i<msg->size(); i++)
@@ -64,6 +74,19 @@ static void callback_(double t, std::vector<unsigned char>* msg, void* data)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/* ignoreTypes_
+Sets the message types filtered out by the MIDI in port: sysex messages are 
+needed only by the MTC slave, for the full frames. */
+
+void ignoreTypes_()
+{
+	midiIn_->ignoreTypes(/*midiSysex=*/conf::conf.midiSync != MIDI_SYNC_MTC_S, 
+		/*midiTime=*/false, /*midiSense=*/true);
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -165,7 +188,7 @@ int openInDevice(int port)
 	if (port != -1 && numInPorts_ > 0) {
 		try {
 			midiIn_->openPort(port, getInPortName(port));
-			midiIn_->ignoreTypes(true, false, true); // ignore all system/time msgs, for now
+			ignoreTypes_();
 			u::log::print("[KM] MIDI in port %d open\n", port);
 			midiIn_->setCallback(&callback_);
 			return 1;
@@ -184,6 +207,16 @@ int openInDevice(int port)
 /* -------------------------------------------------------------------------- */
 
 
+void updateInFilter()
+{
+	if (midiIn_ != nullptr)
+		ignoreTypes_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool hasAPI(int API)
 {
 	std::vector<RtMidi::Api> APIs;
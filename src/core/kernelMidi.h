@@ -78,6 +78,12 @@ int openInDevice(int port);
 int closeInDevice();
 int closeOutDevice();
 
+/* updateInFilter
+Applies the current sync mode to the message types accepted by the MIDI in 
+port. Call it whenever conf::conf.midiSync changes. */
+
+void updateInFilter();
+
 /* getIn/OutPortName
 Returns the name of the port 'p'. */
 
@@ -25,7 +25,9 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <cassert>
+#include <mutex>
 #include <vector>
 #include "glue/plugin.h"
 #include "glue/io.h"
@@ -43,6 +45,7 @@
 #include "core/pluginHost.h"
 #include "core/plugin.h"
 #include "core/recManager.h"
+#include "core/automation.h"
 #include "core/types.h"
 #include "core/midiDispatcher.h"
 
@@ -60,6 +63,18 @@ contains things to do once the midi message has been stored. */
 std::function<void()>          signalCb_ = nullptr;
 std::function<void(MidiEvent)> learnCb_  = nullptr;
 
+/* targets_
+Scratch list of routes matching the current message, filled by the MIDI 
+thread. */
+
+std::vector<model::MidiRoute> targets_;
+
+/* rebuildMutex_
+RCUList never runs two overlapping swaps: rebuilds may come from both the MIDI
+thread (learning) and the main thread, so serialize them. */
+
+std::mutex rebuildMutex_;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -86,187 +101,330 @@ bool isChannelMidiInAllowed_(ID channelId, int c)
 /* -------------------------------------------------------------------------- */
 
 
-#ifdef WITH_VST
+/* bind_
+Returns the automation slot for continuous parameters, -1 otherwise. */
 
-void processPlugins_(const std::vector<ID>& ids, const MidiEvent& midiEvent)
+int bind_(const model::MidiRoute& r)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
-	float    vf   = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, 1.0f);
+	namespace ma = automation;
+
+	switch (r.param) {
+		case G_MIDI_IN_VOLUME_IN:
+			return ma::bind(ma::Param::VOLUME, mixer::MASTER_IN_CHANNEL_ID);
+		case G_MIDI_IN_VOLUME_OUT:
+			return ma::bind(ma::Param::VOLUME, mixer::MASTER_OUT_CHANNEL_ID);
+		case G_MIDI_IN_VOLUME:
+			return ma::bind(ma::Param::VOLUME, r.channelId);
+		case G_MIDI_IN_PITCH:
+			return ma::bind(ma::Param::PITCH, r.channelId);
+		case G_MIDI_IN_PLUGIN_PARAM:
+			return ma::bind(ma::Param::PLUGIN, r.pluginId, r.paramIndex);
+		default:
+			return -1;
+	}
+}
 
-	/* Plugins' parameters layout reflects the structure of the matrix
-	Channel::midiInPlugins. It is safe to assume then that Plugin 'p' and 
-	k indexes match both the structure of Channel::midiInPlugins and the vector
-	of plugins. */
 
-	m::model::PluginsLock l(m::model::plugins);
+/* -------------------------------------------------------------------------- */
 
-	for (ID id : ids) {
-		m::Plugin& p = m::model::get(m::model::plugins, id);
-		for (unsigned k = 0; k < p.midiInParams.size(); k++) {
-			if (pure != p.midiInParams.at(k))
-				continue;
-			c::plugin::setParameter(id, k, vf, /*gui=*/false);
-			u::log::print("  >>> [plugin %d parameter %d] (pure=0x%X, value=%d, float=%f)\n",
-				p.id, k, pure, midiEvent.getVelocity(), vf);
-		}
+
+/* toFloat_
+Maps the velocity of a message to the range of continuous parameter 'param'. */
+
+float toFloat_(int param, int velocity)
+{
+	switch (param) {
+		case G_MIDI_IN_PITCH:
+			return u::math::map(velocity, G_MAX_VELOCITY, G_MAX_PITCH);
+		case G_MIDI_IN_PLUGIN_PARAM:
+			return u::math::map(velocity, G_MAX_VELOCITY, 1.0f);
+		default:
+			return u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME);
 	}
 }
 
-#endif
+
+/* -------------------------------------------------------------------------- */
+
+
+/* addRoute_
+Adds a target for the learned message 'pure'. Unlearned messages (0x0) are 
+skipped. */
+
+void addRoute_(model::MidiRoutes& routes, uint32_t pure, model::MidiRoute r)
+{
+	if (pure == 0x0)
+		return;
+	r.slot = bind_(r);
+	routes.map[pure].push_back(r);
+}
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void processChannels_(const MidiEvent& midiEvent)
+void addMasterRoutes_(model::MidiRoutes& routes)
 {
-	uint32_t pure = midiEvent.getRawNoVelocity();
+	model::MidiInLock l(model::midiIn);
 
-	/* TODO - this is definitely not the best approach but it's necessary as
-	you can't call actions on m::model::channels while locking on a upper
-	level. Let's wait for a better async mechanism... */
+	const model::MidiIn* m = model::midiIn.get();
+
+	/* Master parameters are mutually exclusive for the same message: keep the
+	first match only, as the linear lookup used to do. */
+
+	const std::pair<int, uint32_t> params[] = {
+		{ G_MIDI_IN_REWIND,      m->rewind     },
+		{ G_MIDI_IN_START_STOP,  m->startStop  },
+		{ G_MIDI_IN_ACTION_REC,  m->actionRec  },
+		{ G_MIDI_IN_INPUT_REC,   m->inputRec   },
+		{ G_MIDI_IN_METRONOME,   m->metronome  },
+		{ G_MIDI_IN_VOLUME_IN,   m->volumeIn   },
+		{ G_MIDI_IN_VOLUME_OUT,  m->volumeOut  },
+		{ G_MIDI_IN_BEAT_DOUBLE, m->beatDouble },
+		{ G_MIDI_IN_BEAT_HALF,   m->beatHalf   },
+	};
+
+	std::vector<uint32_t> taken;
+	for (const auto& p : params) {
+		if (std::find(taken.begin(), taken.end(), p.second) != taken.end())
+			continue;
+		taken.push_back(p.second);
+		addRoute_(routes, p.second, { p.first });
+	}
+}
 
-	std::vector<std::function<void()>> actions;
 
-	model::channels.lock();
-	for (Channel* ch : model::channels) {
+/* -------------------------------------------------------------------------- */
 
-		/* Do nothing on this channel if MIDI in is disabled or filtered out for
-		the current MIDI channel. */
 
-		if (!ch->midiIn || !ch->isMidiInAllowed(midiEvent.getChannel()))
+void addChannelRoutes_(model::MidiRoutes& routes, const Channel& ch)
+{
+	std::vector<std::pair<int, uint32_t>> params = {
+		{ G_MIDI_IN_KEYPRESS, ch.midiInKeyPress },
+		{ G_MIDI_IN_KEYREL,   ch.midiInKeyRel   },
+		{ G_MIDI_IN_MUTE,     ch.midiInMute     },
+		{ G_MIDI_IN_KILL,     ch.midiInKill     },
+		{ G_MIDI_IN_ARM,      ch.midiInArm      },
+		{ G_MIDI_IN_SOLO,     ch.midiInSolo     },
+		{ G_MIDI_IN_VOLUME,   ch.midiInVolume   },
+	};
+	if (ch.type == ChannelType::SAMPLE) {
+		const SampleChannel& sch = static_cast<const SampleChannel&>(ch);
+		params.push_back({ G_MIDI_IN_PITCH,        sch.midiInPitch       });
+		params.push_back({ G_MIDI_IN_READ_ACTIONS, sch.midiInReadActions });
+	}
+
+	/* Same as master parameters: one channel parameter per message. */
+
+	std::vector<uint32_t> taken;
+	for (const auto& p : params) {
+		if (std::find(taken.begin(), taken.end(), p.second) != taken.end())
 			continue;
+		taken.push_back(p.second);
+		addRoute_(routes, p.second, { p.first, ch.id, ch.midiInFilter });
+	}
 
-		if      (pure == ch->midiInKeyPress) {
-			actions.push_back([=] {
-				u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::io::keyPress(ch->id, false, false, midiEvent.getVelocity());
-			});
-		}
-		else if (pure == ch->midiInKeyRel) {
-			actions.push_back([=] {
-				u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::io::keyRelease(ch->id, false, false);
-			});
-		}
-		else if (pure == ch->midiInMute) {
-			actions.push_back([=] {
-				u::log::print("  >>> mute ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleMute(ch->id);
-			});
-		}		
-		else if (pure == ch->midiInKill) {
-			actions.push_back([=] {
-				u::log::print("  >>> kill ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::kill(ch->id, /*record=*/false);
-			});
-		}		
-		else if (pure == ch->midiInArm) {
-			actions.push_back([=] {
-				u::log::print("  >>> arm ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleArm(ch->id);
-			});
-		}
-		else if (pure == ch->midiInSolo) {
-			actions.push_back([=] {
-				u::log::print("  >>> solo ch=%d (pure=0x%X)\n", ch->id, pure);
-				c::channel::toggleSolo(ch->id);
-			});
-		}
-		else if (pure == ch->midiInVolume) {
-			actions.push_back([=] {
-				float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME); 
-				u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
-					ch->id, pure, midiEvent.getVelocity(), vf);
-				c::channel::setVolume(ch->id, vf, /*gui=*/false);
-			});
-		}
-		else {
-			const SampleChannel* sch = static_cast<const SampleChannel*>(ch);
-			if (pure == sch->midiInPitch) {
-				actions.push_back([=] {
-					float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_PITCH); 
-					u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
-						sch->id, pure, midiEvent.getVelocity(), vf);
-					c::channel::setPitch(sch->id, vf);
-				});
-			}
-			else 
-			if (pure == sch->midiInReadActions) {
-				actions.push_back([=] {
-					u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", sch->id, pure);
-					c::channel::toggleReadingActions(sch->id);
-				});
-			}
-		}
 #ifdef WITH_VST
 
-		/* Process learned plugins parameters. */
-		processPlugins_(ch->pluginIds, midiEvent); 
+	/* Learned plug-in parameters are routed in addition to the channel ones. */
 
-#endif
+	model::PluginsLock l(model::plugins);
 
-		/* Redirect full midi message (pure + velocity) to plugins. */
-		ch->receiveMidi(midiEvent.getRaw());
+	for (ID id : ch.pluginIds) {
+		const Plugin* p = model::find(model::plugins, id);
+		if (p == nullptr)
+			continue;
+		for (unsigned k = 0; k < p->midiInParams.size(); k++)
+			addRoute_(routes, p->midiInParams[k], 
+				{ G_MIDI_IN_PLUGIN_PARAM, ch.id, ch.midiInFilter, id, static_cast<int>(k) });
 	}
-	model::channels.unlock();
 
-	/* Apply all the collected actions. */
-	for (auto& action : actions)
-		action();
+#endif
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void processMaster_(const MidiEvent& midiEvent)
+bool isAlive_(const model::MidiRoute& r)
 {
-	m::model::MidiInLock l(m::model::midiIn);
-
-	const uint32_t       pure   = midiEvent.getRawNoVelocity();
-	const model::MidiIn* midiIn = model::midiIn.get();
-
-	if      (pure == midiIn->rewind) {
-		mh::rewindSequencer();
-		u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn->startStop) {
-		mh::toggleSequencer();
-		u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn->actionRec) {
-		recManager::toggleActionRec(conf::conf.recTriggerMode);
-		u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
+	if (r.channelId != 0) {
+		model::ChannelsLock l(model::channels);
+		if (model::find(model::channels, r.channelId) == nullptr)
+			return false;
 	}
-	else if (pure == midiIn->inputRec) {
-		c::main::toggleInputRec();
-		u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn->metronome) {
-		m::mixer::toggleMetronome();
-		u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
-	}
-	else if (pure == midiIn->volumeIn) {
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME); 
-		c::main::setInVol(vf, /*gui=*/false);
-		u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
-			pure, midiEvent.getVelocity(), vf);
+#ifdef WITH_VST
+	if (r.param == G_MIDI_IN_PLUGIN_PARAM) {
+		model::PluginsLock l(model::plugins);
+		if (model::find(model::plugins, r.pluginId) == nullptr)
+			return false;
 	}
-	else if (pure == midiIn->volumeOut) {
-		float vf = u::math::map(midiEvent.getVelocity(), G_MAX_VELOCITY, G_MAX_VOLUME); 
-		c::main::setOutVol(vf, /*gui=*/false);
-		u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
-			pure, midiEvent.getVelocity(), vf);
+#endif
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void apply_(const model::MidiRoute& r, const MidiEvent& midiEvent)
+{
+	const uint32_t pure     = midiEvent.getRawNoVelocity();
+	const int      velocity = midiEvent.getVelocity();
+
+	/* Continuous parameters go through their automation slot: the audio thread
+	smooths and applies the value, the UI picks it up on its next refresh. */
+
+	if (r.slot != -1) {
+		automation::write(r.slot, toFloat_(r.param, velocity));
+		return;
 	}
-	else if (pure == midiIn->beatDouble) {
-		c::main::beatsMultiply();
-		u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
+
+	/* The table might still point to a channel or plug-in removed in the 
+	meantime. */
+
+	if (!isAlive_(r))
+		return;
+
+	switch (r.param) {
+		case G_MIDI_IN_REWIND:
+			mh::rewindSequencer();
+			u::log::print("  >>> rewind (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_START_STOP:
+			mh::toggleSequencer();
+			u::log::print("  >>> startStop (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_ACTION_REC:
+			recManager::toggleActionRec(conf::conf.recTriggerMode);
+			u::log::print("  >>> actionRec (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_INPUT_REC:
+			c::main::toggleInputRec();
+			u::log::print("  >>> inputRec (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_METRONOME:
+			m::mixer::toggleMetronome();
+			u::log::print("  >>> metronome (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_VOLUME_IN: {
+			float vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME); 
+			c::main::setInVol(vf, /*gui=*/false);
+			u::log::print("  >>> input volume (master) (pure=0x%X, value=%d, float=%f)\n",
+				pure, velocity, vf);
+			break;
+		}
+		case G_MIDI_IN_VOLUME_OUT: {
+			float vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME); 
+			c::main::setOutVol(vf, /*gui=*/false);
+			u::log::print("  >>> output volume (master) (pure=0x%X, value=%d, float=%f)\n",
+				pure, velocity, vf);
+			break;
+		}
+		case G_MIDI_IN_BEAT_DOUBLE:
+			c::main::beatsMultiply();
+			u::log::print("  >>> sequencer x2 (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_BEAT_HALF:
+			c::main::beatsDivide();
+			u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
+			break;
+		case G_MIDI_IN_KEYPRESS:
+			u::log::print("  >>> keyPress, ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::io::keyPress(r.channelId, false, false, velocity);
+			break;
+		case G_MIDI_IN_KEYREL:
+			u::log::print("  >>> keyRel ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::io::keyRelease(r.channelId, false, false);
+			break;
+		case G_MIDI_IN_MUTE:
+			u::log::print("  >>> mute ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::channel::toggleMute(r.channelId);
+			break;
+		case G_MIDI_IN_KILL:
+			u::log::print("  >>> kill ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::channel::kill(r.channelId, /*record=*/false);
+			break;
+		case G_MIDI_IN_ARM:
+			u::log::print("  >>> arm ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::channel::toggleArm(r.channelId);
+			break;
+		case G_MIDI_IN_SOLO:
+			u::log::print("  >>> solo ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::channel::toggleSolo(r.channelId);
+			break;
+		case G_MIDI_IN_VOLUME: {
+			float vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_VOLUME); 
+			u::log::print("  >>> volume ch=%d (pure=0x%X, value=%d, float=%f)\n",
+				r.channelId, pure, velocity, vf);
+			c::channel::setVolume(r.channelId, vf, /*gui=*/false);
+			break;
+		}
+		case G_MIDI_IN_PITCH: {
+			float vf = u::math::map(velocity, G_MAX_VELOCITY, G_MAX_PITCH); 
+			u::log::print("  >>> pitch ch=%d (pure=0x%X, value=%d, float=%f)\n",
+				r.channelId, pure, velocity, vf);
+			c::channel::setPitch(r.channelId, vf);
+			break;
+		}
+		case G_MIDI_IN_READ_ACTIONS:
+			u::log::print("  >>> toggle read actions ch=%d (pure=0x%X)\n", r.channelId, pure);
+			c::channel::toggleReadingActions(r.channelId);
+			break;
+#ifdef WITH_VST
+		case G_MIDI_IN_PLUGIN_PARAM: {
+			float vf = u::math::map(velocity, G_MAX_VELOCITY, 1.0f);
+			c::plugin::setParameter(r.pluginId, r.paramIndex, vf, /*gui=*/false);
+			u::log::print("  >>> [plugin %d parameter %d] (pure=0x%X, value=%d, float=%f)\n",
+				r.pluginId, r.paramIndex, pure, velocity, vf);
+			break;
+		}
+#endif
 	}
-	else if (pure == midiIn->beatHalf) {
-		c::main::beatsDivide();
-		u::log::print("  >>> sequencer /2 (master) (pure=0x%X)\n", pure);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void process_(const MidiEvent& midiEvent)
+{
+	const uint32_t pure = midiEvent.getRawNoVelocity();
+	const int      chan = midiEvent.getChannel();
+
+	/* Copy the matching targets out of the routing table and release it before
+	applying them: glue functions may wait for the GUI thread, which in turn 
+	may be waiting to publish a new table. 'targets_' is only touched by the 
+	MIDI thread and keeps its capacity across calls. */
+
+	targets_.clear();
+	{
+		model::MidiRoutesLock l(model::midiRoutes);
+		
+		const model::MidiRoutes* routes = model::midiRoutes.get();
+
+		const auto it = routes->map.find(pure);
+		if (it != routes->map.end())
+			for (const model::MidiRoute& r : it->second)
+				if (r.accepts(chan))
+					targets_.push_back(r);
+
+		/* Redirect full midi message (pure + velocity) to MIDI channels. */
+
+		if (!routes->receivers.empty()) {
+			model::ChannelsLock cl(model::channels);
+			for (const model::MidiRoute& r : routes->receivers) {
+				if (!r.accepts(chan))
+					continue;
+				Channel* ch = model::find(model::channels, r.channelId);
+				if (ch != nullptr)
+					ch->receiveMidi(midiEvent.getRaw());
+			}
+		}
 	}
+
+	for (const model::MidiRoute& r : targets_)
+		apply_(r, midiEvent);
 }
 
 
@@ -295,6 +453,7 @@ void learnChannel_(MidiEvent e, int param, ID channelId, std::function<void()> d
 		}
 	});
 
+	rebuild();
 	stopLearn();
 	doneCb();
 }
@@ -322,6 +481,7 @@ void learnMaster_(MidiEvent e, int param, std::function<void()> doneCb)
 		}
 	});
 
+	rebuild();
 	stopLearn();
 	doneCb();
 }
@@ -336,6 +496,7 @@ void learnPlugin_(MidiEvent e, int paramIndex, ID pluginId, std::function<void()
 		p.midiInParams[paramIndex] = e.getRawNoVelocity();
 	});
 
+	rebuild();
 	stopLearn();
 	doneCb();
 }
@@ -417,6 +578,32 @@ void clearPluginLearn (int paramIndex, ID pluginId, std::function<void()> f)
 /* -------------------------------------------------------------------------- */
 
 
+void rebuild()
+{
+	std::lock_guard<std::mutex> lock(rebuildMutex_);
+
+	auto routes = std::make_unique<model::MidiRoutes>();
+
+	addMasterRoutes_(*routes);
+	{
+		model::ChannelsLock l(model::channels);
+
+		for (const Channel* ch : model::channels) {
+			if (!ch->midiIn)
+				continue;
+			addChannelRoutes_(*routes, *ch);
+			if (ch->type == ChannelType::MIDI)
+				routes->receivers.push_back({ 0, ch->id, ch->midiInFilter });
+		}
+	}
+
+	model::midiRoutes.swap(std::move(routes));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void dispatch(int byte1, int byte2, int byte3)
 {
 	/* Here we want to catch two things: a) note on/note off from a keyboard and 
@@ -440,8 +627,7 @@ void dispatch(int byte1, int byte2, int byte3)
 		learnCb_(midiEvent);
 	}
 	else {
-		processMaster_(midiEvent);
-		processChannels_(midiEvent);
+		process_(midiEvent);
 		triggerSignalCb_();
 	}	
 }
@@ -50,6 +50,12 @@ void startPluginLearn (int paramIndex, ID pluginId, std::function<void()> f);
 void clearPluginLearn (int paramIndex, ID pluginId, std::function<void()> f);
 #endif
 
+/* rebuild
+Rebuilds the MIDI input lookup table from the learned messages of master, 
+channels and plug-ins. Call it whenever one of them changes. */
+
+void rebuild();
+
 void dispatch(int byte1, int byte2, int byte3);
 
 void setSignalCallback(std::function<void()> f);
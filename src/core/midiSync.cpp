@@ -0,0 +1,632 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include "glue/main.h"
+#include "utils/log.h"
+#include "core/queue.h"
+#include "core/tripleBuffer.h"
+#include "core/dll.h"
+#include "core/const.h"
+#include "core/clock.h"
+#include "core/conf.h"
+#include "core/mixerHandler.h"
+#include "core/kernelMidi.h"
+#include "midiSync.h"
+
+
+namespace giada {
+namespace m {
+namespace midiSync
+{
+namespace
+{
+struct Event
+{
+	enum class Type { START, CONTINUE, STOP, BPM };
+
+	Type  type;
+	float bpm;
+};
+
+/* Estimate
+Position of the external master, from the MIDI thread to the audio thread. */
+
+struct Estimate
+{
+	bool     rolling = false;  // Master playing, tempo locked
+	double   time    = 0.0;    // Seconds, steady clock
+	double   beat    = 0.0;    // Master position at 'time', in beats
+	double   rate    = 0.0;    // Beats per second
+	unsigned cue     = 0;      // Bumped on every jump of the master position
+};
+
+/* MTC frame rates: the ones used to count frames and the actual ones. */
+
+constexpr int    MTC_FPS_COUNT[4] = { 24, 25, 30, 30 };
+constexpr double MTC_FPS[4]       = { 24.0, 25.0, 29.97, 30.0 };
+
+/* events_
+Transport changes, from the MIDI thread to the control thread. */
+
+Queue<Event, G_MIDI_SYNC_QUEUE_SIZE> events_;
+
+/* estimate_
+Latest position estimated, from the MIDI thread to the audio thread. */
+
+TripleBuffer<Estimate> estimate_;
+
+/* MIDI thread state. 'position_' counts clock ticks (or MTC quarter frames): 
+it's the position of the last tick received. */
+
+Dll      dll_(G_MIDI_SYNC_DLL_BANDWIDTH);
+bool     playing_   = false;
+bool     synced_    = false;  // MTC position known
+int      position_  = -1;
+int      count_     = 0;      // Ticks since the DLL was reset
+int      mtcRate_   = 0;
+std::array<int, 8> mtc_ = {};
+double   last_      = 0.0;
+unsigned cue_       = 0;
+float    bpm_       = 0.0f;   // Last tempo posted
+double   beatStart_ = 0.0;
+int      beatTicks_ = 0;
+
+std::atomic<double> lastQuarter_(0.0);
+
+/* Audio thread state. */
+
+unsigned lastCue_ = 0;
+
+/* Control thread state. */
+
+bool mtcRolling_ = false;
+
+std::thread       worker_;
+std::atomic<bool> running_(false);
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isSlave_()
+{
+	return conf::conf.midiSync == MIDI_SYNC_CLOCK_S || 
+	       conf::conf.midiSync == MIDI_SYNC_MTC_S;
+}
+
+
+double now_()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+bool post_(Event::Type type, float bpm=0.0f)
+{
+	return events_.push({ type, bpm });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void publish_(bool rolling, double time, double beat, double rate)
+{
+	estimate_.getWriteBuffer() = { rolling, time, beat, rate, cue_ };
+	estimate_.publish();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* track_
+Feeds the DLL with the arrival time 't' of a tick. Starts over if the master 
+has been silent for a while. Returns whether the DLL is locked. */
+
+bool track_(double t)
+{
+	if (count_ > 0 && t - last_ > G_MIDI_SYNC_TIMEOUT_MS / 1000.0)
+		count_ = 0;
+
+	if (count_ == 1)
+		dll_.reset(t, t - last_);
+	else
+	if (count_ > 1)
+		dll_.update(t);
+
+	last_ = t;
+	count_++;
+	return count_ > 2;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* measureBpm_
+Measures the master tempo over a whole beat of filtered ticks, so that the 
+residual jitter is averaged out. Changes are posted to the control thread once
+the DLL has settled for a few beats. Small variations are ignored: each change
+rebuilds the action map, the phase correction takes care of the rest. */
+
+void measureBpm_()
+{
+	if (count_ == 3) {  // Just locked
+		beatStart_ = dll_.getTime();
+		beatTicks_ = 0;
+		return;
+	}
+	if (++beatTicks_ < G_MIDI_CLOCK_PPQN)
+		return;
+
+	float bpm = 60.0 / (dll_.getTime() - beatStart_);
+	beatStart_ = dll_.getTime();
+	beatTicks_ = 0;
+
+	if (count_ < G_MIDI_CLOCK_PPQN * 4 || std::fabs(bpm - bpm_) < G_MIDI_SYNC_BPM_STEP)
+		return;
+	if (post_(Event::Type::BPM, bpm))
+		bpm_ = bpm;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void onClock_(double t)
+{
+	bool locked = track_(t);
+
+	/* The first tick after a start (or continue) is the position the master 
+	starts from. */
+
+	if (playing_)
+		position_++;
+	if (!locked)
+		return;
+
+	double rate = 1.0 / (dll_.getPeriod() * G_MIDI_CLOCK_PPQN);
+	
+	publish_(playing_, dll_.getTime(), std::max(position_, 0) / (double) G_MIDI_CLOCK_PPQN, rate);
+	measureBpm_();
+}
+
+
+void onStart_(double t)
+{
+	playing_  = true;
+	position_ = -1;
+	cue_++;
+	publish_(false, t, 0.0, 0.0);
+	post_(Event::Type::START);
+}
+
+
+void onContinue_()
+{
+	playing_ = true;
+	post_(Event::Type::CONTINUE);
+}
+
+
+void onStop_(double t)
+{
+	playing_ = false;
+	publish_(false, t, std::max(position_, 0) / (double) G_MIDI_CLOCK_PPQN, 0.0);
+	post_(Event::Type::STOP);
+}
+
+
+/* onPosition_
+Song position pointer, in MIDI beats (i.e. sixteenth notes, six ticks each). */
+
+void onPosition_(double t, int spp)
+{
+	position_ = spp * 6 - 1;
+	cue_++;
+	publish_(false, t, spp * 6 / (double) G_MIDI_CLOCK_PPQN, 0.0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* publishMtc_
+MTC carries no tempo: the position in seconds is mapped on Giada's own. */
+
+void publishMtc_(bool rolling, double time, double speed)
+{
+	const double quarter = 1.0 / (MTC_FPS[mtcRate_] * 4);
+	const double bps     = clock::getBpm() / 60.0;
+
+	publish_(rolling, time, position_ * quarter * bps, bps * speed);
+}
+
+
+void onQuarterFrame_(double t, unsigned char data)
+{
+	if (t - last_ > G_MIDI_SYNC_TIMEOUT_MS / 1000.0)
+		synced_ = false;
+
+	bool locked = track_(t);
+
+	position_++;
+
+	/* The last piece completes a time code, which refers to the moment the 
+	first piece was sent, i.e. 7 quarter frames ago. */
+
+	Timecode tc;
+	if (decodeQuarterFrame(data, mtc_, tc)) {
+		mtcRate_ = tc.rate;
+		int quarters = toQuarterFrames(tc) + 7;
+		if (!synced_ || std::abs(quarters - position_) > 1) {
+			position_ = quarters;
+			synced_   = true;
+			cue_++;
+		}
+	}
+
+	if (!locked || !synced_)
+		return;
+
+	lastQuarter_.store(t);
+
+	const double nominal = 1.0 / (MTC_FPS[mtcRate_] * 4);
+	publishMtc_(true, dll_.getTime(), nominal / dll_.getPeriod());
+}
+
+
+/* onFullFrame_
+Locates the master. */
+
+void onFullFrame_(double t, const std::vector<unsigned char>& msg)
+{
+	Timecode tc;
+	if (!decodeFullFrame(msg, tc))
+		return;
+
+	mtcRate_  = tc.rate;
+	position_ = toQuarterFrames(tc);
+	synced_   = true;
+	cue_++;
+	publishMtc_(false, t, 1.0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* frameOf_
+Loop frame of master position 'beat'. */
+
+Frame frameOf_(double beat, Frame framesInLoop, int beats)
+{
+	double b = std::fmod(beat, beats);
+	if (b < 0.0)
+		b += beats;
+	return std::min<Frame>(b * framesInLoop / beats, framesInLoop - 1);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* follow_
+Keeps the clock in phase with the master. Offsets within G_MIDI_SYNC_TOLERANCE
+frames are left alone. Larger ones are nudged, so that recorded actions in 
+between are neither replayed nor lost. */
+
+void follow_(double beat, Frame framesInLoop, int beats)
+{
+	const Frame current = clock::getCurrentFrame();
+
+	/* The first frame of the loop is where loops and queued channels start: 
+	never jump away from it before it has been played. */
+
+	if (current == 0)
+		return;
+
+	const Frame expected = frameOf_(beat, framesInLoop, beats);
+
+	Frame delta = expected - current;
+	if      (delta >  framesInLoop / 2) delta -= framesInLoop;
+	else if (delta < -framesInLoop / 2) delta += framesInLoop;
+
+	if (std::abs(delta) <= G_MIDI_SYNC_TOLERANCE)
+		return;
+
+	/* Lagging behind across the end of the loop: nudge() lands on the first 
+	frame, so that the new loop starts as usual. */
+
+	clock::nudge(delta);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* watchMtc_
+MTC has no start and stop messages: the master is playing as long as quarter
+frames keep coming, once its position is known. */
+
+void watchMtc_()
+{
+	bool alive = now_() - lastQuarter_.load() < G_MIDI_SYNC_TIMEOUT_MS / 1000.0;
+
+	if (alive && !mtcRolling_) {
+		mtcRolling_ = true;
+		if (!clock::isRunning())
+			mh::startSequencer();
+	}
+	else
+	if (!alive && mtcRolling_) {
+		mtcRolling_ = false;
+		if (clock::isRunning())
+			mh::stopSequencer();
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* process_
+Applies the pending events. Tempo changes are coalesced, as in 
+jackTransport. */
+
+void process_()
+{
+	Event e;
+	float bpm = 0.0f;
+
+	while (events_.pop(e)) {
+		switch (e.type) {
+			case Event::Type::START:
+				mh::rewindChannels();
+				if (!clock::isRunning())
+					mh::startSequencer();
+				break;
+			case Event::Type::CONTINUE:
+				if (!clock::isRunning())
+					mh::startSequencer();
+				break;
+			case Event::Type::STOP:
+				if (clock::isRunning())
+					mh::stopSequencer();
+				break;
+			case Event::Type::BPM:
+				bpm = e.bpm;
+				break;
+		}
+	}
+
+	if (bpm > 0.0f)
+		c::main::setBpm(bpm);
+
+	if (conf::conf.midiSync == MIDI_SYNC_MTC_S)
+		watchMtc_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void run_()
+{
+	while (running_.load()) {
+		process_();
+		std::this_thread::sleep_for(std::chrono::milliseconds(G_MIDI_SYNC_POLL_MS));
+	}
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init()
+{
+	if (!isSlave_() || running_.load())
+		return;
+	mtcRolling_ = false;
+	running_.store(true);
+	worker_ = std::thread(run_);
+	u::log::print("[midiSync::init] control thread started\n");
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void close()
+{
+	if (!running_.load())
+		return;
+	running_.store(false);
+	worker_.join();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void setMode(int mode)
+{
+	if (mode == conf::conf.midiSync)
+		return;
+
+	conf::conf.midiSync = mode;
+	kernelMidi::updateInFilter();
+
+	if (isSlave_())
+		init();
+	else
+		close();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void receive(const std::vector<unsigned char>& msg)
+{
+	if (msg.empty() || !isSlave_())
+		return;
+
+	/* Arrival times are taken right here: the jitter of the MIDI thread is 
+	filtered by the DLL. */
+
+	const double t   = now_();
+	const bool   mtc = conf::conf.midiSync == MIDI_SYNC_MTC_S;
+
+	switch (msg[0]) {
+		case MIDI_CLOCK:
+			if (!mtc) onClock_(t);
+			break;
+		case MIDI_START:
+			if (!mtc) onStart_(t);
+			break;
+		case MIDI_CONTINUE:
+			if (!mtc) onContinue_();
+			break;
+		case MIDI_STOP:
+			if (!mtc) onStop_(t);
+			break;
+		case MIDI_POSITION_PTR: {
+			int spp = decodePosition(msg);
+			if (!mtc && spp != -1) onPosition_(t, spp);
+			break;
+		}
+		case MIDI_MTC_QUARTER:
+			if (mtc && msg.size() >= 2) onQuarterFrame_(t, msg[1]);
+			break;
+		case MIDI_SYSEX:
+			if (mtc) onFullFrame_(t, msg);
+			break;
+		default:
+			break;
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void recvMidiSync()
+{
+	if (!isSlave_())
+		return;
+
+	estimate_.fetch();
+
+	const Estimate& e            = estimate_.get();
+	const Frame     framesInLoop = clock::getFramesInLoop();
+	const int       beats        = clock::getBeats();
+	const double    now          = now_();
+
+	if (framesInLoop <= 0)
+		return;
+
+	/* Position at the beginning of this block, extrapolated from the last 
+	tick. */
+
+	const double beat = e.beat + (e.rolling ? (now - e.time) * e.rate : 0.0);
+
+	/* The master has jumped (start, song position pointer, MTC full frame): 
+	jump along, whatever the clock status. */
+
+	if (e.cue != lastCue_) {
+		lastCue_ = e.cue;
+		clock::setCurrentFrame(frameOf_(beat, framesInLoop, beats));
+		return;
+	}
+
+	if (!e.rolling || now - e.time > G_MIDI_SYNC_TIMEOUT_MS / 1000.0 || 
+	    !clock::isRunning() || clock::isWaiting())
+		return;
+
+	follow_(beat, framesInLoop, beats);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int decodePosition(const std::vector<unsigned char>& msg)
+{
+	if (msg.size() < 3 || msg[0] != MIDI_POSITION_PTR)
+		return -1;
+	return (msg[1] & 0x7F) | ((msg[2] & 0x7F) << 7);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool decodeQuarterFrame(unsigned char data, std::array<int, 8>& pieces, Timecode& tc)
+{
+	int piece = (data >> 4) & 0x7;
+	pieces[piece] = data & 0x0F;
+
+	if (piece != 7)
+		return false;
+
+	tc.rate    = (pieces[7] >> 1) & 0x3;
+	tc.hours   = pieces[6] | ((pieces[7] & 0x1) << 4);
+	tc.minutes = pieces[4] | (pieces[5] << 4);
+	tc.seconds = pieces[2] | (pieces[3] << 4);
+	tc.frames  = pieces[0] | (pieces[1] << 4);
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool decodeFullFrame(const std::vector<unsigned char>& msg, Timecode& tc)
+{
+	if (msg.size() < 10 || msg[0] != MIDI_SYSEX || msg[1] != 0x7F || 
+	    msg[3] != 0x01 || msg[4] != 0x01)
+		return false;
+
+	tc.rate    = (msg[5] >> 5) & 0x3;
+	tc.hours   = msg[5] & 0x1F;
+	tc.minutes = msg[6];
+	tc.seconds = msg[7];
+	tc.frames  = msg[8];
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int toQuarterFrames(const Timecode& tc)
+{
+	return ((((tc.hours * 60) + tc.minutes) * 60 + tc.seconds) * MTC_FPS_COUNT[tc.rate] + tc.frames) * 4;
+}
+}}} // giada::m::midiSync::
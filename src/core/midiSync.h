@@ -0,0 +1,111 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MIDI_SYNC_H
+#define G_MIDI_SYNC_H
+
+
+#include <array>
+#include <vector>
+
+
+namespace giada {
+namespace m {
+namespace midiSync
+{
+/* init
+Starts the control thread that applies start, stop and tempo changes from an
+external MIDI Clock or MTC master, if Giada is configured as a slave. */
+
+void init();
+
+/* close
+Stops the control thread. */
+
+void close();
+
+/* setMode
+Switches MIDI sync to mode 'mode' (MIDI_SYNC_*) while running: starts or stops
+the control thread and updates the MIDI in filter accordingly. Main thread 
+only. */
+
+void setMode(int mode);
+
+/* receive
+Parses a MIDI system message coming from the external master: clock, start, 
+continue, stop, song position pointer, MTC quarter and full frames. Tick times 
+are filtered by a delay-locked loop, which estimates the master tempo. MIDI 
+thread only. */
+
+void receive(const std::vector<unsigned char>& msg);
+
+/* recvMidiSync
+Keeps the clock in phase with the position estimated for the external master.
+Call it once per block. Audio thread only: never blocks nor allocates. */
+
+void recvMidiSync();
+
+/* -------------------------------------------------------------------------- */
+
+/* Timecode
+MTC position. 'rate' is the MTC frame rate code: 0 = 24, 1 = 25, 2 = 29.97 
+(drop frame), 3 = 30 fps. */
+
+struct Timecode
+{
+	int rate    = 0;
+	int hours   = 0;
+	int minutes = 0;
+	int seconds = 0;
+	int frames  = 0;
+};
+
+/* decodePosition
+Returns the song position pointer carried by message 'msg', in MIDI beats 
+(i.e. sixteenth notes), or -1 if 'msg' is not a valid one. */
+
+int decodePosition(const std::vector<unsigned char>& msg);
+
+/* decodeQuarterFrame
+Stores the piece of time code carried by the quarter frame data byte 'data' 
+into 'pieces'. Returns true and fills 'tc' when the last piece completes it. */
+
+bool decodeQuarterFrame(unsigned char data, std::array<int, 8>& pieces, Timecode& tc);
+
+/* decodeFullFrame
+Fills 'tc' from a MTC full frame message: F0 7F <device> 01 01 hh mm ss ff F7.
+Returns false if 'msg' is not one. */
+
+bool decodeFullFrame(const std::vector<unsigned char>& msg, Timecode& tc);
+
+/* toQuarterFrames
+Position of time code 'tc', in quarter frames. */
+
+int toQuarterFrames(const Timecode& tc);
+}}} // giada::m::midiSync::
+
+
+#endif
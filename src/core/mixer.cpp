@@ -27,6 +27,9 @@
 
 #include <cassert>
 #include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <vector>
 #include "deps/rtaudio/RtAudio.h"
 #include "utils/log.h"
 #include "utils/math.h"
@@ -36,8 +39,11 @@
 #include "core/channels/midiChannel.h"
 #include "core/wave.h"
 #include "core/kernelAudio.h"
+#include "core/jackTransport.h"
+#include "core/midiSync.h"
+#include "core/automation.h"
 #include "core/recorder.h"
-#include "core/recManager.h"
+#include "core/inputRec.h"
 #include "core/pluginHost.h"
 #include "core/conf.h"
 #include "core/mixerHandler.h"
@@ -45,6 +51,7 @@
 #include "core/const.h"
 #include "core/audioBuffer.h"
 #include "core/action.h"
+#include "core/telemetry.h"
 #include "core/mixer.h"
 
 
@@ -78,42 +85,68 @@ struct Metronome
 		 0.069639,  0.031320
 	};
 
-	Frame tracker  = 0;
-	bool  running  = false;
-	bool  playBar  = false;
-	bool  playBeat = false;
+	Frame  tracker = 0;
+	Frame  wait    = 0;
+	bool   running = false;
+	float* click   = nullptr;
 
-	void render(AudioBuffer& outBuf, bool& process, float* data, Frame f)
+	/* schedule
+	Starts a new click after 'delay' frames. The delay keeps the metronome in 
+	sync with channels delayed by the plug-in delay compensation. */
+
+	void schedule(float* data, Frame delay)
 	{
-		process = true;
+		click   = data;
+		wait    = delay;
+		tracker = 0;
+	}
+
+	void render(AudioBuffer& outBuf, Frame f)
+	{
+		if (click == nullptr)
+			return;
+		if (wait > 0) {
+			wait--;
+			return;
+		}
 		for (int i=0; i<outBuf.countChannels(); i++)
-			outBuf[f][i] += data[tracker];
-		if (++tracker > Metronome::CLICK_SIZE) {
-			process = false;
-			tracker = 0;
-		}	
+			outBuf[f][i] += click[tracker];
+		if (++tracker >= Metronome::CLICK_SIZE)
+			click = nullptr;
 	}
 } metronome_;
 
-/* vChanInput_
-Virtual channel for input recording. */
-
-AudioBuffer vChanInput_;
-
 /* vChanInToOut_
 Virtual channel in->out bridge (hear what you're playin). */
 
 AudioBuffer vChanInToOut_;
 
-/* inputTracker_
-Frame position while recording. */
+/* outBuses_, inBuses_
+Stereo buses, one per pair of device channels. Channels render straight into
+the bus they are routed to. With a single bus there is nothing to route: bus 0 
+borrows the device buffer itself, so no copy takes place. */
+
+std::vector<AudioBuffer> outBuses_;
+std::vector<AudioBuffer> inBuses_;
+
+/* noInput_
+Unallocated buffer given to channels that record from a bus not available. */
 
-Frame inputTracker_ = 0;
+const AudioBuffer noInput_;
 
-/* signalCb_
-Callback triggered when the input signal level reaches a threshold. */
+/* signalArmed_, signalFired_
+Signal-triggered recording: armed by the main thread, fired by the audio 
+thread as soon as the input level reaches the threshold. */
 
-std::function<void()> signalCb_ = nullptr;
+std::atomic<bool> signalArmed_(false);
+std::atomic<bool> signalFired_(false);
+
+/* triggerAt_, triggerPos_
+Frame of the current block where the input signal has started the clock, if
+any (-1 otherwise), and the loop position it starts from. */
+
+Frame triggerAt_  = -1;
+Frame triggerPos_ = 0;
 
 std::atomic<bool> processing_(false);
 std::atomic<bool> active_(false);
@@ -122,30 +155,118 @@ std::atomic<bool> active_(false);
 /* -------------------------------------------------------------------------- */
 
 
-void computePeak_(const AudioBuffer& buf, std::atomic<float>& peak)
+/* computeLevels_
+Computes peak and RMS values of the whole buffer in a single pass. */
+
+void computeLevels_(const AudioBuffer& buf, float& peak, float& rms)
 {
+	float max = 0.0f;
+	float sum = 0.0f;
 	for (int i=0; i<buf.countFrames(); i++)
-		for (int j=0; j<buf.countChannels(); j++)
-			if (buf[i][j] > peak)
-				peak = buf[i][j];
+		for (int j=0; j<buf.countChannels(); j++) {
+			float v = buf[i][j];
+			if (std::fabs(v) > max)
+				max = std::fabs(v);
+			sum += v * v;
+		}
+	peak = max;
+	rms  = buf.countSamples() > 0 ? std::sqrt(sum / buf.countSamples()) : 0.0f;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* bindBuses_
+Points the buses to the device buffers 'out' and 'in'. With multiple buses, 
+output ones are cleared and input ones filled with their own pair of 'in'. */
+
+void bindBuses_(AudioBuffer& out, const AudioBuffer& in)
+{
+	if (outBuses_.size() == 1)
+		outBuses_[0].setData(out[0], out.countFrames(), G_MAX_IO_CHANS);
+	else
+		for (AudioBuffer& bus : outBuses_)
+			bus.clear();
+
+	if (!in.isAllocd() || inBuses_.size() == 0)
+		return;
+
+	if (inBuses_.size() == 1)
+		inBuses_[0].setData(in[0], in.countFrames(), G_MAX_IO_CHANS);
+	else
+		for (int i=0; i<in.countFrames(); i++)
+			for (size_t b=0; b<inBuses_.size(); b++)
+				for (int j=0; j<G_MAX_IO_CHANS; j++)
+					inBuses_[b][i][j] = in[i][b * G_MAX_IO_CHANS + j];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* unbindBuses_
+Interleaves the output buses into the device buffer 'out', if more than one, 
+then releases any borrowed device buffer. */
+
+void unbindBuses_(AudioBuffer& out)
+{
+	if (outBuses_.size() == 1)
+		outBuses_[0].setData(nullptr, 0, 0);
+	else
+		for (int i=0; i<out.countFrames(); i++)
+			for (size_t b=0; b<outBuses_.size(); b++)
+				for (int j=0; j<G_MAX_IO_CHANS; j++)
+					out[i][b * G_MAX_IO_CHANS + j] = outBuses_[b][i][j];
+
+	if (inBuses_.size() == 1)
+		inBuses_[0].setData(nullptr, 0, 0);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 /* lineInRec
-Records from line in. */
+Records from line in. A block that has just triggered the recording has been
+already written by detectSignal_(). */
 
 void lineInRec_(const AudioBuffer& inBuf)
 {
-	if (!recManager::isRecordingInput() || !kernelAudio::isInputEnabled())
+	if (!inputRec::isRecording() || !kernelAudio::isInputEnabled() || triggerAt_ != -1)
+		return;
+	inputRec::write(inBuf, clock::getCurrentFrame(), clock::getFramesInLoop(), 
+		mh::getInVol());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* detectSignal_
+Looks for the first frame above the threshold when signal-triggered recording
+is armed. The take starts right there, minus the pre-roll, and the clock will 
+be started on that very frame by processSequencer_(). */
+
+void detectSignal_(const AudioBuffer& inBuf)
+{
+	if (!signalArmed_.load())
 		return;
 
-	for (int i=0; i<inBuf.countFrames(); i++, inputTracker_++)
+	const float threshold = u::math::dBtoLinear(conf::conf.recTriggerLevel);
+
+	for (Frame i=0; i<inBuf.countFrames(); i++)
 		for (int j=0; j<inBuf.countChannels(); j++) {
-			if (inputTracker_ >= clock::getFramesInLoop())
-				inputTracker_ = 0;
-			vChanInput_[inputTracker_][j] += inBuf[i][j] * mh::getInVol();  // adding: overdub!
+			if (std::fabs(inBuf[i][j]) <= threshold)
+				continue;
+
+			const Frame framesInLoop = clock::getFramesInLoop();
+			const Frame preRoll      = std::min<Frame>(conf::conf.recTriggerPreRoll * 
+				conf::conf.samplerate / 1000, framesInLoop - 1);
+
+			inputRec::trigger(inBuf, i, preRoll, framesInLoop, mh::getInVol());
+
+			triggerAt_  = std::max(i - preRoll, 0);
+			triggerPos_ = std::max(preRoll - i, 0);
+			signalArmed_.store(false);
+			signalFired_.store(true);
+			return;
 		}
 }
 
@@ -155,17 +276,16 @@ void lineInRec_(const AudioBuffer& inBuf)
 /* processLineIn
 Computes line in peaks, plus handles "hear what you're playin'" thing. */
 
-void processLineIn_(const AudioBuffer& inBuf)
+void processLineIn_(const AudioBuffer& inBuf, telemetry::Snapshot& t)
 {
+	triggerAt_ = -1;
+
 	if (!kernelAudio::isInputEnabled())
 		return;
 
-	computePeak_(inBuf, peakIn);
-
-	if (signalCb_ != nullptr && u::math::linearToDB(peakIn) > conf::conf.recTriggerLevel) {
-		signalCb_();
-		signalCb_ = nullptr;
-	}
+	computeLevels_(inBuf, t.peakIn, t.rmsIn);
+	detectSignal_(inBuf);
+	inputRec::listen(inBuf);
 
 	/* "hear what you're playing" - process, copy and paste the input buffer onto 
 	the output buffer. */
@@ -188,7 +308,7 @@ void doQuantize_(unsigned frame)
 {
 	/* Nothing to do if quantizer disabled or a quanto has not passed yet. */
 
-	if (clock::getQuantize() == 0 || !clock::quantoHasPassed())
+	if (clock::getBlockQuantize() == 0 || !clock::quantoHasPassed())
 		return;
 
 	if (rewindWait) {
@@ -207,11 +327,19 @@ void renderMetronome_(AudioBuffer& outBuf, Frame f)
 	if (!metronome_.running)
 		return;
 
-	if (clock::isOnBar() || metronome_.playBar)
-		metronome_.render(outBuf, metronome_.playBar, metronome_.bar, f);
+#ifdef WITH_VST
+	Frame delay = pluginHost::getDelayCompensation();
+#else
+	Frame delay = 0;
+#endif
+
+	if (clock::isOnBar())
+		metronome_.schedule(metronome_.bar, delay);
 	else
-	if (clock::isOnBeat() || metronome_.playBeat)
-		metronome_.render(outBuf, metronome_.playBeat, metronome_.beat, f);
+	if (clock::isOnBeat())
+		metronome_.schedule(metronome_.beat, delay);
+
+	metronome_.render(outBuf, f);
 }
 
 
@@ -223,11 +351,11 @@ void parseEvents_(Frame f)
 	mixer::FrameEvents fe = {
 		.frameLocal   = f,
 		.frameGlobal  = clock::getCurrentFrame(),
-		.doQuantize   = clock::getQuantize() == 0 || !clock::quantoHasPassed(),
+		.doQuantize   = clock::getBlockQuantize() == 0 || !clock::quantoHasPassed(),
 		.onBar        = clock::isOnBar(),
 		.onFirstBeat  = clock::isOnFirstBeat(),
 		.quantoPassed = clock::quantoHasPassed(),
-		.actions      = recorder::getActionsOnFrame(clock::getCurrentFrame()),
+		.actions      = clock::areActionsMuted() ? nullptr : recorder::getActionsOnFrame(clock::getCurrentFrame()),
 	};
 
 	model::ChannelsLock lock(model::channels);
@@ -240,10 +368,39 @@ void parseEvents_(Frame f)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/* chaseActions_
+Plays at once, on the first frame of the block, the actions recorded on frames
+[a, b) jumped over by the clock to follow an external master. */
+
+void chaseActions_(Frame a, Frame b)
+{
+	model::ActionsLock  al(model::actions);
+	model::ChannelsLock cl(model::channels);
+
+	const recorder::ActionMap& map = model::actions.get()->map;
+
+	for (auto it = map.lower_bound(a); it != map.end() && it->first < b; ++it) {
+		mixer::FrameEvents fe = {
+			.frameLocal   = 0,
+			.frameGlobal  = it->first,
+			.doQuantize   = false,
+			.onBar        = false,
+			.onFirstBeat  = false,
+			.quantoPassed = false,
+			.actions      = &it->second,
+		};
+		for (Channel* ch : model::channels)
+			ch->parseEvents(fe); 
+	}
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
-void render_(AudioBuffer& out, const AudioBuffer& in, AudioBuffer& inToOut)
+void render_(AudioBuffer& inToOut)
 {
 	bool running = clock::isRunning();
 
@@ -257,14 +414,19 @@ void render_(AudioBuffer& out, const AudioBuffer& in, AudioBuffer& inToOut)
 			ch->id == mixer::MASTER_OUT_CHANNEL_ID ||
 			ch->id == mixer::MASTER_IN_CHANNEL_ID)
 			continue;
-		const_cast<Channel*>(ch)->render(out, in, inToOut, isChannelAudible(ch), running);
+		const_cast<Channel*>(ch)->render(getOutBus(ch), getInBus(ch), inToOut, 
+			isChannelAudible(ch), running);
 	}
 
 	assert(model::channels.size() >= 3); // Preview channel included
 
 	/* Master channels are processed at the end, when the buffers have already 
-	been filled. */
+	been filled. They work on the main mix only: the other buses leave the 
+	mixer as they are. */
 	
+	AudioBuffer&       out = outBuses_[0];
+	const AudioBuffer& in  = inBuses_.size() > 0 ? inBuses_[0] : noInput_;
+
 	model::get(model::channels, mixer::MASTER_OUT_CHANNEL_ID).render(out, in, inToOut, true, true);
 	model::get(model::channels, mixer::MASTER_IN_CHANNEL_ID).render(out, in, inToOut, true, true);
 }
@@ -275,8 +437,24 @@ void render_(AudioBuffer& out, const AudioBuffer& in, AudioBuffer& inToOut)
 
 void processSequencer_(AudioBuffer& out, const AudioBuffer& in)
 {
+	/* Input goes first: the take is aligned to the clock position at the 
+	beginning of the block. */
+
+	lineInRec_(in);
+
+	clock::beginBlock();
+	bool running = clock::isRunning();
+
+	Frame skippedA, skippedB;
+	if (clock::getSkipped(skippedA, skippedB) && running)
+		chaseActions_(skippedA, skippedB);
+
 	for (int j=0; j<out.countFrames(); j++) {
-		if (clock::isRunning()) {
+		if (j == triggerAt_) {
+			clock::trigger(triggerPos_);
+			running = true;
+		}
+		if (running) {
 			parseEvents_(j);
 			doQuantize_(j);
 		}
@@ -284,19 +462,19 @@ void processSequencer_(AudioBuffer& out, const AudioBuffer& in)
 		clock::incrCurrentFrame();
 		renderMetronome_(out, j);
 	}
-	lineInRec_(in);
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 /* prepareBuffers
-Cleans up every buffer. */
+Cleans up every buffer and binds the buses to the device ones. */
 
-void prepareBuffers_(AudioBuffer& outBuf)
+void prepareBuffers_(AudioBuffer& outBuf, const AudioBuffer& inBuf)
 {
 	outBuf.clear();
 	vChanInToOut_.clear();
+	bindBuses_(outBuf, inBuf);
 }
 
 
@@ -335,6 +513,53 @@ void finalizeOutput_(AudioBuffer& outBuf)
 			outBuf[i][j] *= mh::getOutVol(); 
 		}
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+/* fillTelemetry_
+Collects channels and clock state for the UI. Master levels have been already
+computed. */
+
+void fillTelemetry_(telemetry::Snapshot& t)
+{
+	t.clockStatus  = clock::getStatus();
+	t.currentFrame = clock::getCurrentFrame();
+	t.currentBeat  = clock::getCurrentBeat();
+
+	model::ChannelsLock lock(model::channels);
+
+	size_t i = 0;
+	for (const Channel* ch : model::channels) {
+		if (i == t.channels.size())
+			break;
+		telemetry::Channel& tc = t.channels[i++];
+		tc.id          = ch->id;
+		tc.playStatus  = ch->playStatus;
+		tc.recStatus   = ch->recStatus;
+		tc.armed       = ch->armed;
+		tc.mute        = ch->mute;
+		tc.solo        = ch->solo;
+		tc.hasData     = ch->hasData();
+		tc.hasActions  = ch->hasActions;
+		tc.readActions = ch->readActions;
+		tc.peak        = ch->peak;
+		tc.rms         = ch->rms;
+		tc.stackPeak   = ch->stackPeak;
+		if (ch->type == ChannelType::SAMPLE) {
+			const SampleChannel* sc = static_cast<const SampleChannel*>(ch);
+			tc.position       = sc->getPosition();
+			tc.length         = sc->getEnd() - sc->getBegin();
+			tc.trackerPreview = sc->trackerPreview;
+		}
+		else {
+			tc.position       = -1;
+			tc.length         = 0;
+			tc.trackerPreview = 0;
+		}
+	}
+	t.countChannels = i;
+}
 }; // {anonymous}
 
 
@@ -344,23 +569,31 @@ void finalizeOutput_(AudioBuffer& outBuf)
 
 
 std::atomic<bool>  rewindWait(false);
-std::atomic<float> peakOut(0.0);
-std::atomic<float> peakIn(0.0);
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void init(Frame framesInSeq, Frame framesInBuffer)
+void init(Frame framesInBuffer, int busesOut, int busesIn)
 {
-	/* Allocate virtual inputs. vChanInput_ has variable size: it depends
-	on how many frames there are in sequencer. */
-	
-	vChanInput_.alloc(framesInSeq, G_MAX_IO_CHANS);
 	vChanInToOut_.alloc(framesInBuffer, G_MAX_IO_CHANS);
 
-	u::log::print("[mixer::init] buffers ready - framesInSeq=%d, framesInBuffer=%d\n", 
-		framesInSeq, framesInBuffer);	
+	/* A single bus borrows the device buffer: no allocation needed. */
+
+	outBuses_.clear();
+	outBuses_.resize(std::max(busesOut, 1));
+	if (outBuses_.size() > 1)
+		for (AudioBuffer& bus : outBuses_)
+			bus.alloc(framesInBuffer, G_MAX_IO_CHANS);
+
+	inBuses_.clear();
+	inBuses_.resize(std::max(busesIn, 0));
+	if (inBuses_.size() > 1)
+		for (AudioBuffer& bus : inBuses_)
+			bus.alloc(framesInBuffer, G_MAX_IO_CHANS);
+
+	u::log::print("[mixer::init] buffers ready - framesInBuffer=%d, buses out=%d, in=%d\n", 
+		framesInBuffer, busesOut, busesIn);	
 
 	clock::rewind();
 }
@@ -369,6 +602,25 @@ void init(Frame framesInSeq, Frame framesInBuffer)
 /* -------------------------------------------------------------------------- */
 
 
+AudioBuffer& getOutBus(const Channel* ch)
+{
+	if (ch->outBus < 0 || static_cast<size_t>(ch->outBus) >= outBuses_.size())
+		return outBuses_[0];
+	return outBuses_[ch->outBus];
+}
+
+
+const AudioBuffer& getInBus(const Channel* ch)
+{
+	if (ch->inBus < 0 || static_cast<size_t>(ch->inBus) >= inBuses_.size())
+		return noInput_;
+	return inBuses_[ch->inBus];
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void enable()
 { 
 	active_.store(true); 
@@ -388,27 +640,6 @@ void disable()
 /* -------------------------------------------------------------------------- */
 
 
-void allocVirtualInput(Frame frames)
-{
-	vChanInput_.alloc(frames, G_MAX_IO_CHANS);
-}
-
-
-void clearVirtualInput()
-{
-	vChanInput_.clear();
-}
-
-
-const AudioBuffer& getVirtualInput()
-{
-	return vChanInput_;
-}
-
-
-/* -------------------------------------------------------------------------- */
-
-
 int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize, 
 	double streamTime, RtAudioStreamStatus status, void* userData)
 {
@@ -420,39 +651,47 @@ int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize,
 #if defined(__linux__) || defined(__FreeBSD__)
 
 	if (kernelAudio::getAPI() == G_SYS_API_JACK)
-		clock::recvJackSync();
+		jackTransport::recvJackSync();
 
 #endif
 
+	midiSync::recvMidiSync();
+	automation::process(conf::conf.samplerate, bufferSize);
+
 	AudioBuffer out, in;
-	out.setData((float*) outBuf, bufferSize, G_MAX_IO_CHANS);
+	out.setData((float*) outBuf, bufferSize, outBuses_.size() * G_MAX_IO_CHANS);
 	if (kernelAudio::isInputEnabled())
-		in.setData((float*) inBuf, bufferSize, G_MAX_IO_CHANS);
-
-	/* Reset peak computation. */
+		in.setData((float*) inBuf, bufferSize, inBuses_.size() * G_MAX_IO_CHANS);
 
-	peakOut = 0.0;
-	peakIn  = 0.0;
+	/* Telemetry for the UI, filled along the way and published at the end of
+	the block. */
 
-	prepareBuffers_(out);
-	processLineIn_(in);
+	telemetry::Snapshot& t = telemetry::getWriteSnapshot();
+	t.peakIn = 0.0f;
+	t.rmsIn  = 0.0f;
 
-	/* Process model. */
+	prepareBuffers_(out, in);
+	processLineIn_(in, t);
 
-//out[0][0] = 3.0f;
+	/* Process model. Input recording takes all the input channels, while the
+	metronome and the master processing only touch the main mix. */
 
 	if (clock::isActive()) 
-		processSequencer_(out, in);
-	render_(out, in, vChanInToOut_);
+		processSequencer_(outBuses_[0], in);
+	render_(vChanInToOut_);
 
 	/* Post processing. */
 
-	finalizeOutput_(out);
-	limitOutput_(out);
-	computePeak_(out, peakOut);
+	finalizeOutput_(outBuses_[0]);
+	for (AudioBuffer& bus : outBuses_)
+		limitOutput_(bus);
+	computeLevels_(outBuses_[0], t.peakOut, t.rmsOut);
+	fillTelemetry_(t);
+	telemetry::publish();
 
 	/* Unset data in buffers. If you don't do this, buffers go out of scope and
 	destroy memory allocated by RtAudio ---> havoc. */
+	unbindBuses_(out);
 	out.setData(nullptr, 0, 0);
 	in.setData (nullptr, 0, 0);
 
@@ -465,6 +704,31 @@ int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize,
 /* -------------------------------------------------------------------------- */
 
 
+void publishIdleTelemetry()
+{
+	/* The audio thread is the only writer while it is processing: step in only 
+	when no callback can touch the snapshot. */
+
+	if (kernelAudio::isRunning() && active_.load() == true)
+		return;
+	if (processing_.load() == true)
+		return;
+
+	telemetry::Snapshot& t = telemetry::getWriteSnapshot();
+	t.peakOut = 0.0f;
+	t.rmsOut  = 0.0f;
+	t.peakIn  = 0.0f;
+	t.rmsIn   = 0.0f;
+	fillTelemetry_(t);
+	for (size_t i = 0; i < t.countChannels; i++) // Silence: no stale meters
+		t.channels[i].peak = t.channels[i].rms = t.channels[i].stackPeak = 0.0f;
+	telemetry::publish();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void close()
 {
 	clock::setStatus(ClockStatus::STOPPED);
@@ -488,39 +752,40 @@ bool isMetronomeOn() { return metronome_.running; }
 /* -------------------------------------------------------------------------- */
 
 
-void startInputRec()
+void toggleMetronome()
 {
-	/* Start inputTracker_ from the current frame, not the beginning. */
-	inputTracker_ = clock::getCurrentFrame();
+	metronome_.running = !metronome_.running;
 }
 
 
-void stopInputRec()
-{
-	inputTracker_ = 0;
+void setMetronome(bool v) 
+{ 
+	metronome_.running = v; 
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void toggleMetronome()
+void armSignal(bool v)
 {
-	metronome_.running = !metronome_.running;
-}
+	if (v == true) {
+		signalFired_.store(false);
+		signalArmed_.store(true);
+		return;
+	}
 
+	/* The block being processed right now might still fire: wait for it, so 
+	that a following pollSignal() sees any trigger. */
 
-void setMetronome(bool v) 
-{ 
-	metronome_.running = v; 
+	signalArmed_.store(false);
+	while (processing_.load() == true) 
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
 }
 
 
-/* -------------------------------------------------------------------------- */
-
-
-void setSignalCallback(std::function<void()> f)
+bool pollSignal()
 {
-	signalCb_ = f;
+	return signalFired_.exchange(false);
 }
 }}}; // giada::m::mixer::
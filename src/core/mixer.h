@@ -30,7 +30,6 @@
 
 
 #include <atomic>
-#include <functional>
 #include <vector>
 #include "deps/rtaudio/RtAudio.h"
 #include "core/recorder.h"
@@ -61,11 +60,13 @@ constexpr int MASTER_OUT_CHANNEL_ID = 1;
 constexpr int MASTER_IN_CHANNEL_ID  = 2;
 constexpr int PREVIEW_CHANNEL_ID    = 3;
 
-extern std::atomic<bool>  rewindWait;    // rewind guard, if quantized
-extern std::atomic<float> peakOut;
-extern std::atomic<float> peakIn;
+extern std::atomic<bool> rewindWait;    // rewind guard, if quantized
 
-void init(Frame framesInSeq, Frame framesInBuffer);
+/* init
+Allocates the internal buffers, plus 'busesOut' and 'busesIn' stereo buses to
+route the channels to. */
+
+void init(Frame framesInBuffer, int busesOut, int busesIn);
 
 /* enable, disable
 Toggles master callback processing. Useful when loading a new patch. Mixer
@@ -75,23 +76,6 @@ called. */
 void enable();
 void disable();
 
-/* allocVirtualInput
-Allocates new memory for the virtual input channel. Call this whenever you 
-shrink or resize the sequencer. */
-
-void allocVirtualInput(Frame frames);
-
-/* clearVirtualInput
-Clears internal virtual channel. */
-
-void clearVirtualInput();
-
-/* getVirtualInput
-Returns a read-only reference to the internal virtual channel. Use this to
-merge data into channel after an input recording session. */
-
-const AudioBuffer& getVirtualInput(); 
-
 void close();
 
 /* masterPlay
@@ -100,19 +84,38 @@ Core method (callback) */
 int masterPlay(void* outBuf, void* inBuf, unsigned bufferSize, double streamTime,
 	RtAudioStreamStatus status, void* userData);
 
+/* publishIdleTelemetry
+Main thread only. Publishes a telemetry snapshot built from the model when the
+audio thread can't, i.e. with no running stream or with the mixer disabled. 
+Does nothing otherwise. */
+
+void publishIdleTelemetry();
+
 bool isChannelAudible(const Channel* ch);
 
-/* startInputRec, stopInputRec
-Starts/stops input recording on frame clock::getCurrentFrame(). */
+/* getOutBus, getInBus
+Buses channel 'ch' is routed to. Unknown buses fall back to the main mix for
+output and to no input at all, i.e. an unallocated buffer. */
 
-void startInputRec();
-void stopInputRec();
+AudioBuffer&       getOutBus(const Channel* ch);
+const AudioBuffer& getInBus(const Channel* ch);
 
 void toggleMetronome();
 bool isMetronomeOn();
 void setMetronome(bool v);
 
-void setSignalCallback(std::function<void()> f);
+/* armSignal
+Enables or disables signal-triggered recording: the audio thread starts the 
+take and the clock on the first input frame above the threshold. Disabling it 
+waits for the current block, and keeps a trigger already fired pending for 
+pollSignal(). */
+
+void armSignal(bool v);
+
+/* pollSignal
+Whether the input signal has fired since the last call. Main thread only. */
+
+bool pollSignal();
 }}} // giada::m::mixer::;
 
 
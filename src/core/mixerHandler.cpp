@@ -27,6 +27,7 @@
 
 #include <cassert>
 #include <vector>
+#include <map>
 #include <algorithm>
 #include "utils/fs.h"
 #include "utils/string.h"
@@ -52,9 +53,11 @@
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
 #include "core/recManager.h"
+#include "core/inputRec.h"
 #include "core/clock.h"
 #include "core/kernelAudio.h"
 #include "core/midiMapConf.h"
+#include "core/midiDispatcher.h"
 #include "core/wave.h"
 #include "core/waveManager.h"
 #include "core/mixerHandler.h"
@@ -119,6 +122,27 @@ bool canInputRec_(size_t chanIndex)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+/* splitBus_
+Fills 'out' with the stereo input bus 'bus' of the multichannel take 'take'. 
+Unknown buses give a silent buffer. */
+
+void splitBus_(const AudioBuffer& take, int bus, AudioBuffer& out)
+{
+	out.alloc(take.countFrames(), G_MAX_IO_CHANS);
+	out.clear();
+
+	const int offset = bus * G_MAX_IO_CHANS;
+	if (bus < 0 || offset + G_MAX_IO_CHANS > take.countChannels())
+		return;
+
+	for (int i=0; i<take.countFrames(); i++)
+		for (int j=0; j<G_MAX_IO_CHANS; j++)
+			out[i][j] = take[i][offset + j];
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 /* pushWave_
@@ -146,7 +170,8 @@ void pushWave_(SampleChannel& ch, std::unique_ptr<Wave>&& w, bool clone)
 
 void init()
 {
-	mixer::init(clock::getFramesInLoop(), kernelAudio::getRealBufSize());
+	mixer::init(kernelAudio::getRealBufSize(), kernelAudio::countBusesOut(), 
+		kernelAudio::countBusesIn());
 	
 	model::channels.push(createChannel_(ChannelType::MASTER, /*column=*/0, 
 		mixer::MASTER_OUT_CHANNEL_ID));
@@ -154,6 +179,7 @@ void init()
 		mixer::MASTER_IN_CHANNEL_ID));
 	model::channels.push(createChannel_(ChannelType::PREVIEW, /*column=*/0, 
 		mixer::PREVIEW_CHANNEL_ID));
+	midiDispatcher::rebuild();
 }
 
 
@@ -165,6 +191,7 @@ void close()
 	mixer::disable();
 	model::channels.clear();
 	model::waves.clear();
+	midiDispatcher::rebuild();
 	mixer::close();
 }
 
@@ -196,6 +223,10 @@ ID addChannel(ChannelType type, ID columnId)
 	std::unique_ptr<Channel> c  = createChannel_(type, columnId);
 	ID                       id = c->id;
 	model::channels.push(std::move(c));
+	midiDispatcher::rebuild();
+#ifdef WITH_VST
+	pluginHost::updateDelayCompensation();
+#endif
 	return id;
 }
 
@@ -241,6 +272,10 @@ void addAndLoadChannel(ID columnId, std::unique_ptr<Wave>&& w)
 	/* Then add new channel to Channel list. */
 
 	model::channels.push(std::move(ch));
+	midiDispatcher::rebuild();
+#ifdef WITH_VST
+	pluginHost::updateDelayCompensation();
+#endif
 }
 
 
@@ -271,6 +306,7 @@ void cloneChannel(ID channelId)
 	/* Then push the new channel in the channels list. */
 
 	model::channels.push(std::move(newChannel));
+	midiDispatcher::rebuild();
 }
 
 
@@ -334,6 +370,7 @@ void deleteChannel(ID channelId)
 	});
 	
 	model::channels.pop(model::getIndex(model::channels, channelId));
+	midiDispatcher::rebuild();
 
 	if (hasWave)
 		model::waves.pop(model::getIndex(model::waves, waveId)); 
@@ -511,7 +548,7 @@ void rewindSequencer()
 void rewindChannels()
 {
 	for (size_t i = 3; i < model::channels.size(); i++)
-		model::onSwap(model::channels, model::getId(model::channels, i), [&](Channel& c) { c.rewindBySeq();	});
+		model::onSwapStatus(model::channels, model::getId(model::channels, i), [&](Channel& c) { c.rewindBySeq();	});
 }
 
 
@@ -524,40 +561,74 @@ has to be overwritten somehow). */
 
 void finalizeInputRec()
 {
-	const AudioBuffer& virtualInput = mixer::getVirtualInput();
+	/* The take is as long as the recording, rounded up to whole loops. */
 
-	/* Can't loop with foreach, as it would require a lock on model::channels
-	list which would deadlock during the model::channels::swap() call below. 
-	Also skip channels 0, 1 and 2: they are MASTER_IN, MASTER_OUT and PREVIEW. */
+	AudioBuffer take;
+	if (!inputRec::stop(take, clock::getFramesInLoop()))
+		return;
 
-	for (size_t i = 3; i < model::channels.size(); i++) {
+	/* Skip channels 0, 1 and 2: they are MASTER_IN, MASTER_OUT and PREVIEW. */
 
-		if (!canInputRec_(i))
-			continue;
+	std::vector<size_t> armed;
+	for (size_t i = 3; i < model::channels.size(); i++)
+		if (canInputRec_(i))
+			armed.push_back(i);
+
+	/* Prepare all the new channels first, then swap them in with a single 
+	model update. */
+
+	std::vector<std::pair<size_t, std::unique_ptr<Channel>>> batch;
+	std::map<int, int> users;  // Armed channels on each input bus
+
+	for (size_t i : armed) {
+		model::channels.lock();
+		std::unique_ptr<Channel> ch(model::channels.get(i)->clone());
+		model::channels.unlock();
+		users[ch->inBus]++;
+		batch.emplace_back(i, std::move(ch));
+	}
+
+	/* The take holds all the input buses: split it into one buffer per input 
+	pair in use. A take made of a single pair is taken as is. */
 
-		/* Create a new Wave with audio coming from Mixer's virtual input. */
+	std::map<int, AudioBuffer> buses;
+
+	for (const auto& u : users) {
+		if (u.first == 0 && take.countChannels() == G_MAX_IO_CHANS)
+			buses[0].moveData(take);
+		else
+			splitBus_(take, u.first, buses[u.first]);
+	}
+
+	/* The last channel on each bus takes the buffer itself, the others a copy of
+	it. */
+
+	for (auto& b : batch) {
+
+		SampleChannel& sc  = static_cast<SampleChannel&>(*b.second.get());
+		AudioBuffer&   bus = buses[sc.inBus];
 
 		std::string filename = "TAKE-" + std::to_string(patch::patch.lastTakeId++) + ".wav";
-	
-		std::unique_ptr<Wave> wave = waveManager::createEmpty(clock::getFramesInLoop(), 
-			G_MAX_IO_CHANS, conf::conf.samplerate, filename);
 
-		wave->copyData(virtualInput[0], virtualInput.countFrames());
+		std::unique_ptr<Wave> wave;
+		if (--users[sc.inBus] == 0)
+			wave = waveManager::createFromBuffer(bus, conf::conf.samplerate, filename);
+		else {
+			wave = waveManager::createEmpty(bus.countFrames(), G_MAX_IO_CHANS, 
+				conf::conf.samplerate, filename);
+			wave->copyData(bus[0], bus.countFrames());
+		}
 
 		/* Update Channel with the new Wave. The function pushWave_ will take
 		take of pushing it into the stack first. Also start all channels in
 		LOOP mode. */
 
-		model::onSwap(model::channels, model::getId(model::channels, i), [&](Channel& c)
-		{
-			SampleChannel& sc = static_cast<SampleChannel&>(c);
-			pushWave_(sc, std::move(wave), /*clone=*/false);
-			if (sc.isAnyLoopMode())
-				sc.playStatus = ChannelStatus::PLAY;
-		});
+		pushWave_(sc, std::move(wave), /*clone=*/false);
+		if (sc.isAnyLoopMode())
+			sc.playStatus = ChannelStatus::PLAY;
 	}
 
-	mixer::clearVirtualInput();
+	model::channels.swap(std::move(batch));
 }
 
 
@@ -43,6 +43,7 @@ RCUList<Mixer>    mixer(std::make_unique<Mixer>());
 RCUList<Kernel>   kernel(std::make_unique<Kernel>());
 RCUList<Recorder> recorder(std::make_unique<Recorder>());
 RCUList<MidiIn>   midiIn(std::make_unique<MidiIn>());
+RCUList<MidiRoutes> midiRoutes(std::make_unique<MidiRoutes>());
 RCUList<Actions>  actions(std::make_unique<Actions>());
 RCUList<Channel>  channels;
 RCUList<Wave>     waves;
@@ -57,6 +58,7 @@ Actions::Actions(const Actions& o) : map(o.map)
 	coming from the new 'actions' map.  */
 
 	recorder::updateMapPointers(map);
+	recorder::updateIndex(map, index);
 }
 
 
@@ -30,7 +30,10 @@
 
 
 #include <algorithm>
+#include <cstdint>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 #include "core/channels/channel.h"
 #include "core/const.h"
 #include "core/wave.h"
@@ -45,15 +48,16 @@ namespace model
 {
 struct Clock
 {	
-	ClockStatus status       = ClockStatus::STOPPED;
-	int         framesInLoop = 0;
-	int         framesInBar  = 0;
-	int         framesInBeat = 0;
-	int         framesInSeq  = 0;
-	int         bars         = G_DEFAULT_BARS;
-	int         beats        = G_DEFAULT_BEATS;
-	float       bpm          = G_DEFAULT_BPM;
-	int         quantize     = G_DEFAULT_QUANTIZE;
+	ClockStatus status           = ClockStatus::STOPPED;
+	int         framesInLoop     = 0;
+	uint32_t    framesInLoopFrac = 0; // Fractional part, in 1/2^32 of frame
+	int         framesInBar      = 0;
+	int         framesInBeat     = 0;
+	int         framesInSeq      = 0;
+	int         bars             = G_DEFAULT_BARS;
+	int         beats            = G_DEFAULT_BEATS;
+	float       bpm              = G_DEFAULT_BPM;
+	int         quantize         = G_DEFAULT_QUANTIZE;
 };
 
 struct Mixer
@@ -93,12 +97,46 @@ struct MidiIn
 };
 
 
+/* MidiRoute
+A target for an incoming MIDI message: either a master or channel parameter 
+(one of the G_MIDI_IN_* values) or a plug-in parameter. Continuous parameters
+also carry their automation slot, or -1. */
+
+struct MidiRoute
+{
+	int param      = 0;
+	ID  channelId  = 0;
+	int filter     = -1;
+	ID  pluginId   = 0;
+	int paramIndex = 0;
+	int slot       = -1;
+
+	/* accepts
+	Whether a message coming from MIDI channel 'c' passes the filter. */
+
+	bool accepts(int c) const { return filter == -1 || filter == c; }
+};
+
+
+/* MidiRoutes
+Lookup table built from the learned MIDI messages, indexed by the 'pure' 
+message (i.e. without velocity). 'receivers' holds the MIDI channels that get
+the full message as input. */
+
+struct MidiRoutes
+{
+	std::unordered_map<uint32_t, std::vector<MidiRoute>> map;
+	std::vector<MidiRoute>                               receivers;
+};
+
+
 struct Actions
 {
 	Actions() = default;
 	Actions(const Actions& o);
 
-	recorder::ActionMap map;
+	recorder::ActionMap   map;
+	recorder::ActionIndex index;
 };
 
 
@@ -107,6 +145,7 @@ using MixerLock    = RCUList<Mixer>::Lock;
 using KernelLock   = RCUList<Kernel>::Lock;
 using RecorderLock = RCUList<Recorder>::Lock;
 using MidiInLock   = RCUList<MidiIn>::Lock;
+using MidiRoutesLock = RCUList<MidiRoutes>::Lock;
 using ActionsLock  = RCUList<Actions>::Lock;
 using ChannelsLock = RCUList<Channel>::Lock;
 using WavesLock    = RCUList<Wave>::Lock;
@@ -119,6 +158,7 @@ extern RCUList<Mixer>    mixer;
 extern RCUList<Kernel>   kernel;
 extern RCUList<Recorder> recorder;
 extern RCUList<MidiIn>   midiIn;
+extern RCUList<MidiRoutes> midiRoutes;
 extern RCUList<Actions>  actions;
 extern RCUList<Channel>  channels;
 extern RCUList<Wave>     waves;
@@ -195,6 +235,44 @@ typename L::value_type& get(L& list, ID id)
 /* -------------------------------------------------------------------------- */
 
 
+/* find
+Same as get(), but returns nullptr if the element is not in the list. */
+
+template<typename L>
+typename L::value_type* find(L& list, ID id)
+{
+	static_assert(has_id<typename L::value_type>(), "This type has no ID");
+	for (typename L::value_type* t : list)
+		if (t->id == id)
+			return t;
+	return nullptr;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* getVersion
+Returns the version of the element with ID 'id', or 0 if the element is not in 
+the list. The version changes only when that element is swapped with onSwap(),
+not with onSwapStatus(): compare it with a previous one to find out if 
+something structural has changed. */
+
+template<typename L>
+std::uint64_t getVersion(L& list, ID id)
+{
+	static_assert(has_id<typename L::value_type>(), "This type has no ID");
+	typename L::Lock l(list);
+	for (auto it = list.begin(); it != list.end(); ++it)
+		if ((*it)->id == id)
+			return it.getVersion();
+	return 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 /* onGet (1)
 Utility function for reading ID-based things from a RCUList. */
 
@@ -223,11 +301,12 @@ void onGet(L& list, std::function<void(typename L::value_type&)> f)
 
 
 template<typename L>
-void onSwapByIndex_(L& list, size_t i, std::function<void(typename L::value_type&)> f)
+void onSwapByIndex_(L& list, size_t i, std::function<void(typename L::value_type&)> f,
+	bool keepVersion=false)
 {
 	std::unique_ptr<typename L::value_type> o = list.clone(i);
 	f(*o.get());
-	list.swap(std::move(o), i);
+	list.swap(std::move(o), i, keepVersion);
 }
 
 /* onSwapById_ (1)
@@ -235,10 +314,10 @@ Regular version for copyable types. */
 
 template<typename L>
 void onSwapById_(L& list, ID id, std::function<void(typename L::value_type&)> f, 
-	const std::true_type& /*is_copyable=true*/)
+	const std::true_type& /*is_copyable=true*/, bool keepVersion=false)
 {
 	static_assert(has_id<typename L::value_type>(), "This type has no ID");
-	onSwapByIndex_(list, getIndex(list, id), f); 
+	onSwapByIndex_(list, getIndex(list, id), f, keepVersion); 
 }
 
 
@@ -248,7 +327,7 @@ no-virtual channel refactoring... */
 
 template<typename L>
 void onSwapById_(L& list, ID id, std::function<void(typename L::value_type&)> f,
-	const std::false_type& /*is_copyable=false*/)
+	const std::false_type& /*is_copyable=false*/, bool keepVersion=false)
 {	
 	static_assert(has_id<typename L::value_type>(), "This type has no ID");
 	
@@ -260,7 +339,7 @@ void onSwapById_(L& list, ID id, std::function<void(typename L::value_type&)> f,
 
 	f(*o.get());
 
-	channels.swap(std::move(o), i);
+	channels.swap(std::move(o), i, keepVersion);
 }
 
 
@@ -287,6 +366,20 @@ void onSwap(L& list, std::function<void(typename L::value_type&)> f)
 }
 
 
+/* onSwapStatus
+Same as onSwap (1), for runtime-only changes (play and rec status, mute, 
+solo, ...): the element version is left untouched, so that getVersion() readers
+rebuild only on structural edits. Runtime status reaches the UI through 
+telemetry instead. */
+
+template<typename L>
+void onSwapStatus(L& list, ID id, std::function<void(typename L::value_type&)> f)
+{
+	static_assert(has_id<typename L::value_type>(), "This type has no ID");
+	onSwapById_(list, id, f, is_copyable<typename L::value_type>(), /*keepVersion=*/true);
+}
+
+
 /* ---------------------------------------------------------------------------*/ 
 
 
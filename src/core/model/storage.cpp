@@ -26,6 +26,9 @@
 
 
 #include <cassert>
+#include <cmath>
+#include <map>
+#include "utils/log.h"
 #include "core/model/model.h"
 #include "core/channels/channelManager.h"
 #include "core/channels/sampleChannel.h"
@@ -34,8 +37,10 @@
 #include "core/patch.h"
 #include "core/conf.h"
 #include "core/pluginManager.h"
+#include "core/pluginHost.h"
 #include "core/recorderHandler.h"
 #include "core/waveManager.h"
+#include "core/wave.h"
 #include "core/model/storage.h"
 
 
@@ -43,6 +48,47 @@ namespace giada {
 namespace m {
 namespace model
 {
+namespace
+{
+/* Sizes
+Size of a Wave before and after the conversion to the system rate. */
+
+struct Sizes
+{
+	Frame from;
+	Frame to;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+/* scalePoints_
+Sample channels store begin, end and shift in frames of the Wave as it was 
+saved: maps them on the converted Wave. */
+
+patch::Channel scalePoints_(const patch::Channel& pchannel, Sizes s)
+{
+	auto scale = [&](Frame f)
+	{
+		if (f >= s.from)
+			return s.to;
+		return static_cast<Frame>(std::lround(f * (s.to / static_cast<double>(s.from))));
+	};
+
+	patch::Channel out = pchannel;
+	out.begin = scale(pchannel.begin);
+	out.end   = scale(pchannel.end);
+	out.shift = scale(pchannel.shift);
+	return out;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
 void store(patch::Patch& patch)
 {
 #ifdef WITH_VST
@@ -112,18 +158,35 @@ void load(const patch::Patch& patch)
 	onSwap(actions, [&](Actions& a)
 	{
 		a.map = std::move(recorderHandler::deserializeActions(patch.actions));
+		recorder::updateIndex(a.map, a.index);
 	});
-#ifdef WITH_VST
-    for (const patch::Plugin& pplugin : patch.plugins)
-        plugins.push(pluginManager::deserializePlugin(pplugin));
-#endif
-    
-    for (const patch::Wave& pwave : patch.waves)
-        waves.push(std::move(waveManager::deserializeWave(pwave)));	
+
+	/* Waves with a rate other than the system one are converted. Remember their
+	sizes, so that the points of the channels using them can be scaled. */
+
+	std::map<ID, Sizes> converted;
+
+    for (const patch::Wave& pwave : patch.waves) {
+		std::unique_ptr<Wave> w = waveManager::deserializeWave(pwave);
+		if (w != nullptr && w->getRate() != conf::conf.samplerate) {
+			u::log::print("[model::load] input rate (%d) != system rate (%d), conversion needed\n",
+				w->getRate(), conf::conf.samplerate);
+			Frame from = w->getSize();
+			if (waveManager::resample(*w, conf::conf.rsmpQuality, conf::conf.samplerate) == G_RES_OK)
+				converted[w->id] = { from, w->getSize() };
+			else
+				w = nullptr;
+		}
+        waves.push(std::move(w));
+	}
 
     for (const patch::Channel& pchannel : patch.channels) {
 		if (pchannel.type == ChannelType::MASTER || pchannel.type == ChannelType::PREVIEW)
             onSwap(channels, pchannel.id, [&](Channel& ch) { ch.load(pchannel); });
+		else
+		if (converted.count(pchannel.waveId) > 0)
+			channels.push(channelManager::deserializeChannel(scalePoints_(pchannel, 
+				converted.at(pchannel.waveId)), kernelAudio::getRealBufSize()));
 		else
 			channels.push(channelManager::deserializeChannel(pchannel, kernelAudio::getRealBufSize()));
     }
@@ -133,6 +196,23 @@ void load(const patch::Patch& patch)
 /* -------------------------------------------------------------------------- */
 
 
+#ifdef WITH_VST
+
+void loadPlugins(const patch::Patch& patch)
+{
+	pluginManager::deserializePlugins(patch.plugins, [](std::unique_ptr<Plugin> p)
+	{
+		plugins.push(std::move(p));
+	});
+	pluginHost::updateDelayCompensation();
+}
+
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void load(const conf::Conf& c)
 {
 	onSwap(midiIn, [&](MidiIn& m)
@@ -45,6 +45,17 @@ void store(conf::Conf& c);
 void store(patch::Patch& p);
 void load(const patch::Patch& p);
 void load(const conf::Conf& c);
+
+#ifdef WITH_VST
+
+/* loadPlugins
+Creates plug-ins found in patch 'p' in parallel and pushes each one into the
+model as soon as it is ready. Call it after load(): a channel stays silent until
+all its plug-ins are in place. */
+
+void loadPlugins(const patch::Patch& p);
+
+#endif
 }}} // giada::m::model::
 
 
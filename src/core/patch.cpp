@@ -178,6 +178,8 @@ void readChannels_(const nl::json& j)
 		c.midiOutLmute      = jchannel.value(PATCH_KEY_CHANNEL_MIDI_OUT_L_MUTE, 0);
 		c.midiOutLsolo      = jchannel.value(PATCH_KEY_CHANNEL_MIDI_OUT_L_SOLO, 0);
 		c.armed             = jchannel.value(PATCH_KEY_CHANNEL_ARMED, false);
+		c.outBus            = jchannel.value(PATCH_KEY_CHANNEL_OUT_BUS, 0);
+		c.inBus             = jchannel.value(PATCH_KEY_CHANNEL_IN_BUS, 0);
 		c.mode              = static_cast<ChannelMode>(jchannel.value(PATCH_KEY_CHANNEL_MODE, 1));
 		c.waveId            = jchannel.value(PATCH_KEY_CHANNEL_WAVE_ID, 0);
 		c.begin             = jchannel.value(PATCH_KEY_CHANNEL_BEGIN, 0);
@@ -329,6 +331,8 @@ void writeChannels_(nl::json& j)
 		jchannel[PATCH_KEY_CHANNEL_PAN]                  = c.pan;
 		jchannel[PATCH_KEY_CHANNEL_HAS_ACTIONS]          = c.hasActions;
 		jchannel[PATCH_KEY_CHANNEL_ARMED]                = c.armed;
+		jchannel[PATCH_KEY_CHANNEL_OUT_BUS]              = c.outBus;
+		jchannel[PATCH_KEY_CHANNEL_IN_BUS]               = c.inBus;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_IN]              = c.midiIn;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_IN_KEYREL]       = c.midiInKeyRel;
 		jchannel[PATCH_KEY_CHANNEL_MIDI_IN_KEYPRESS]     = c.midiInKeyPress;
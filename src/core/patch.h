@@ -70,6 +70,8 @@ struct Channel
 	bool        solo;
 	float       volume = G_DEFAULT_VOL;
 	float       pan    = 0.5f;
+	int         outBus = 0;
+	int         inBus  = 0;
 	bool        hasActions;
 	bool        armed;
 	bool        midiIn;
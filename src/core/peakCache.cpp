@@ -0,0 +1,213 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+#include <sys/stat.h>
+#include "utils/fs.h"
+#include "utils/log.h"
+#include "core/const.h"
+#include "core/wave.h"
+#include "peakCache.h"
+
+
+namespace giada {
+namespace m {
+namespace peakCache
+{
+namespace
+{
+std::string path_ = "";
+
+constexpr char MAGIC_[4] = { 'G', 'P', 'K', '2' };
+
+
+/* Header_
+Beginning of each peak file, followed by the peaks of each level. */
+
+struct Header_
+{
+	char     magic[4];
+	uint64_t fileSize;   // Size of the audio file, in bytes
+	int64_t  fileTime;   // Modification time of the audio file
+	int32_t  frames;     // Size of the Wave in memory
+	int32_t  levels;
+};
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool stat_(const std::string& path, uint64_t& size, int64_t& time)
+{
+	struct stat s;
+	if (stat(path.c_str(), &s) != 0)
+		return false;
+	size = s.st_size;
+	time = s.st_mtime;
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* makePath_
+Returns the path of the peak file for audio file 'audioPath'. The file name is
+a 64-bit FNV-1a hash of path, size and modification time of the audio file. */
+
+std::string makePath_(const std::string& audioPath, uint64_t size, int64_t time)
+{
+	uint64_t h = 0xcbf29ce484222325;
+
+	auto mix = [&h](const void* data, size_t n)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		for (size_t i = 0; i < n; i++) {
+			h ^= bytes[i];
+			h *= 0x100000001b3;
+		}
+	};
+
+	mix(audioPath.data(), audioPath.size());
+	mix(&size, sizeof(size));
+	mix(&time, sizeof(time));
+
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.peaks", static_cast<unsigned long long>(h));
+	return path_ + G_SLASH + name;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* read_
+Reads header and peaks of the peak file for audio file 'audioPath'. Returns
+false if the file is missing or doesn't match the audio file on disk. */
+
+bool read_(const std::string& audioPath, Header_& h, WavePeaks::Levels& out)
+{
+	uint64_t size;
+	int64_t  time;
+	if (path_ == "" || !stat_(audioPath, size, time))
+		return false;
+
+	std::ifstream file(makePath_(audioPath, size, time), std::ios::binary);
+	if (!file.read(reinterpret_cast<char*>(&h), sizeof(h)))
+		return false;
+
+	if (std::memcmp(h.magic, MAGIC_, sizeof(MAGIC_)) != 0 || h.fileSize != size || 
+	    h.fileTime != time || h.frames < 0 || h.levels != static_cast<int32_t>(out.size()))
+		return false;
+
+	for (size_t l = 0; l < out.size(); l++) {
+		out[l].resize((h.frames + WavePeaks::LEVELS[l] - 1) / WavePeaks::LEVELS[l]);
+		if (!file.read(reinterpret_cast<char*>(out[l].data()), out[l].size() * sizeof(WavePeaks::Peak)))
+			return false;
+	}
+	return true;
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+void init(const std::string& path)
+{
+	path_ = path;
+
+	if (path == "" || u::fs::dirExists(path))
+		return;
+	if (!u::fs::mkdir(path)) {
+		u::log::print("[peakCache::init] unable to create %s, cache disabled\n", 
+			path.c_str());
+		path_ = "";
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool read(const std::string& path, WavePeaks::Levels& out, Frame& frames)
+{
+	Header_ h;
+	if (!read_(path, h, out))
+		return false;
+	frames = h.frames;
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void write(const Wave& w, const WavePeaks::Levels& in)
+{
+	if (w.isLogical() || w.isEdited())
+		return;
+	write(w.getPath(), w.getSize(), in);
+}
+
+
+void write(const std::string& audioPath, Frame frames, const WavePeaks::Levels& in)
+{
+	uint64_t size;
+	int64_t  time;
+	if (path_ == "" || !stat_(audioPath, size, time))
+		return;
+
+	Header_ h;
+	std::memcpy(h.magic, MAGIC_, sizeof(MAGIC_));
+	h.fileSize = size;
+	h.fileTime = time;
+	h.frames   = frames;
+	h.levels   = in.size();
+
+	/* Write to a temporary file first and then rename it, as in the resample
+	cache. */
+
+	std::string path    = makePath_(audioPath, size, time);
+	std::string tmpPath = path + ".tmp";
+
+	std::ofstream file(tmpPath, std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&h), sizeof(h));
+	for (const std::vector<WavePeaks::Peak>& level : in)
+		file.write(reinterpret_cast<const char*>(level.data()), level.size() * sizeof(WavePeaks::Peak));
+	file.close();
+
+	if (file.fail() || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+		u::log::print("[peakCache::write] unable to store %s\n", path.c_str());
+		std::remove(tmpPath.c_str());
+	}
+}
+}}}; // giada::m::peakCache::
@@ -0,0 +1,69 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_PEAK_CACHE_H
+#define G_PEAK_CACHE_H
+
+
+#include <string>
+#include "core/types.h"
+#include "core/wavePeaks.h"
+
+
+namespace giada {
+namespace m 
+{
+class Wave;
+namespace peakCache
+{
+/* init
+Enables the on-disk cache of peak files in directory 'path', creating it if 
+necessary. An empty string disables the cache. */
+
+void init(const std::string& path);
+
+/* read
+Fills 'out' with the cached peaks of audio file 'path', and 'frames' with the 
+length of the Wave they were computed from. The peak file is keyed by path, 
+size and modification time of the audio file: only the file on disk is checked,
+so no decoding is required. Returns false if no valid peak file is found. */
+
+bool read(const std::string& path, WavePeaks::Levels& out, Frame& frames);
+
+/* write
+Stores peaks 'in' computed from Wave 'w'. Does nothing if 'w' is not backed by
+an audio file or has been edited in memory. The second version takes the path
+and length of a Wave read from an audio file, so that it can be called without
+holding the Wave. */
+
+void write(const Wave& w, const WavePeaks::Levels& in);
+void write(const std::string& path, Frame frames, const WavePeaks::Levels& in);
+}}}; // giada::m::peakCache::
+
+
+#endif
@@ -29,6 +29,7 @@
 
 
 #include <cassert>
+#include <algorithm>
 #include <FL/Fl.H>
 #include "utils/log.h"
 #include "utils/time.h"
@@ -94,6 +95,10 @@ Plugin::Plugin(const Plugin& o)
   m_bypass    (o.m_bypass.load()),
   midiInParams(o.midiInParams)
 {
+	/* Allocate the working buffer right away: the audio thread must never do
+	it when processing a freshly swapped plug-in. */
+
+	m_buffer.setSize(o.m_buffer.getNumChannels(), o.m_buffer.getNumSamples());
 }
 
 
@@ -130,6 +135,13 @@ int Plugin::countMainOutChannels() const
 }
 
 
+bool Plugin::canProcessInPlace(const juce::AudioBuffer<float>& b) const
+{
+	return m_plugin->getTotalNumInputChannels()  == b.getNumChannels() &&
+	       m_plugin->getTotalNumOutputChannels() == b.getNumChannels();
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 
@@ -214,19 +226,38 @@ void Plugin::setBypass(bool b) { m_bypass.store(b); }
 /* -------------------------------------------------------------------------- */
 
 
-void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer m)
+Frame Plugin::getLatency() const
 {
-	/* If this is not an instrument (i.e. doesn't accept MIDI), copy the 
-	incoming buffer data into the temporary one. This way FXes will process
-	existing audio data. Conversely, if the plug-in is an instrument, it 
-	generates its own audio data inside a clean m_buffer and we can play more 
-	than one plug-in instrument in the same stack, driven by the same set of 
-	MIDI events. */
+	if (!valid || isSuspended() || isBypassed())
+		return 0;
+	return m_plugin->getLatencySamples();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void Plugin::process(juce::AudioBuffer<float>& out, juce::MidiBuffer& m)
+{
+	/* If this is not an instrument (i.e. doesn't accept MIDI), FXes process
+	existing audio data. When the bus layout matches the incoming buffer there
+	is nothing to adapt: let the plug-in work on it directly. Otherwise copy the 
+	incoming buffer data into the temporary one, without reallocating.
+	Conversely, if the plug-in is an instrument, it generates its own audio data 
+	inside a clean m_buffer and we can play more than one plug-in instrument in 
+	the same stack, driven by the same set of MIDI events. */
 
 	const bool isInstrument = m_plugin->acceptsMidi();
 
+	if (!isInstrument && canProcessInPlace(out)) {
+		m_plugin->processBlock(out, m);
+		return;
+	}
+
 	if (!isInstrument)
-		m_buffer = out;
+		for (int i=0; i<m_buffer.getNumChannels(); i++)
+			m_buffer.copyFrom(i, 0, out, std::min(i, out.getNumChannels() - 1), 0, 
+				out.getNumSamples());
 	else
 		m_buffer.clear();
 
@@ -69,16 +69,22 @@ public:
 	void setCurrentProgram(int index) const;
 	bool acceptsMidi() const;
 
+	/* getLatency
+	Returns the processing latency in frames, as reported by the plug-in. A
+	plug-in that doesn't process audio (invalid, suspended or bypassed) adds no 
+	latency. */
+
+	Frame getLatency() const;
+
 	juce::AudioProcessorEditor* createEditor() const;
 
 	/* process
 	Process the plug-in with audio and MIDI data. The audio buffer is a reference:
-	it has to be altered by the plug-in itself. Conversely, the MIDI buffer must
-	be passed by copy: each plug-in must receive its own copy of the event set, so
-	that any attempt to change/clear the MIDI buffer will only modify the local 
-	copy. */
+	it has to be altered by the plug-in itself. The MIDI buffer is a reference as
+	well, to avoid copying (and allocating) in the audio thread: the caller is 
+	responsible for clearing it between plug-ins, if needed. */
 
-	void process(juce::AudioBuffer<float>& b, juce::MidiBuffer m);
+	void process(juce::AudioBuffer<float>& b, juce::MidiBuffer& m);
 
 	void setBypass(bool b);
 
@@ -117,6 +123,12 @@ private:
 
 	int countMainOutChannels() const;
 
+	/* canProcessInPlace
+	True if the plug-in can work directly on buffer 'b', i.e. its main buses 
+	have the same number of channels of 'b'. */
+
+	bool canProcessInPlace(const juce::AudioBuffer<float>& b) const;
+
 	juce::AudioPluginInstance* m_plugin;
 	juce::AudioBuffer<float>   m_buffer;
 
@@ -28,13 +28,18 @@
 #ifdef WITH_VST
 
 #include <cassert>
+#include <atomic>
+#include <algorithm>
+#include <utility>
 #include "utils/log.h"
 #include "utils/vector.h"
 #include "core/model/model.h"
 #include "core/channels/channel.h"
 #include "core/const.h"
+#include "core/delayLine.h"
 #include "core/plugin.h"
 #include "core/pluginManager.h"
+#include "core/midiDispatcher.h"
 #include "core/pluginHost.h"
 
 
@@ -48,15 +53,38 @@ juce::MessageManager* messageManager_;
 juce::AudioBuffer<float> audioBuffer_;
 ID pluginId_;
 
+/* emptyEvents_
+Empty MIDI buffer given to audio stacks (master in, master out and sample
+channels), so that no MidiBuffer is constructed in the audio thread. It is 
+cleared after each plug-in anyway. */
+
+juce::MidiBuffer emptyEvents_;
+
+/* delayCompensation_
+Latency of the slowest plug-in stack, in frames. Every channel output is 
+delayed by this amount in total (stack latency + delay line). */
+
+std::atomic<Frame> delayCompensation_(0);
+
 
 /* -------------------------------------------------------------------------- */
 
+/* giadaToJuceTempBuf_
+Deinterleaves Giada's buffer into the planar Juce one. Works on raw pointers
+with no per-sample function calls, so that the compiler can vectorize the 
+inner loop. */
 
 void giadaToJuceTempBuf_(const AudioBuffer& outBuf)
 {
-	for (int i=0; i<outBuf.countFrames(); i++)
-		for (int j=0; j<outBuf.countChannels(); j++)
-			audioBuffer_.setSample(j, i, outBuf[i][j]);
+	const int    frames   = outBuf.countFrames();
+	const int    channels = outBuf.countChannels();
+	const float* in       = outBuf[0];
+
+	for (int j=0; j<channels; j++) {
+		float* out = audioBuffer_.getWritePointer(j);
+		for (int i=0; i<frames; i++)
+			out[i] = in[i * channels + j];
+	}
 }
 
 
@@ -66,29 +94,63 @@ Converts buffer from Juce to Giada. A note for the future: if we overwrite (=)
 
 void juceToGiadaOutBuf_(AudioBuffer& outBuf)
 {
-	for (int i=0; i<outBuf.countFrames(); i++)
-		for (int j=0; j<outBuf.countChannels(); j++)	
-			outBuf[i][j] = audioBuffer_.getSample(j, i);
+	const int frames   = outBuf.countFrames();
+	const int channels = outBuf.countChannels();
+	float*    out      = outBuf[0];
+
+	for (int j=0; j<channels; j++) {
+		const float* in = audioBuffer_.getReadPointer(j);
+		for (int i=0; i<frames; i++)
+			out[i * channels + j] = in[i];
+	}
 }
 
 
 /* -------------------------------------------------------------------------- */
 
 
-void processPlugins_(const std::vector<ID>& pluginIds, juce::MidiBuffer& events)
+/* processPlugins_
+Returns false if one or more plug-ins of the stack are not in the model yet, 
+e.g. while they are still being created during a project load. */
+
+bool processPlugins_(const std::vector<ID>& pluginIds, juce::MidiBuffer& events)
 {
 	model::PluginsLock l(model::plugins);
 
 	for (ID id : pluginIds) {
-		Plugin& p = model::get(model::plugins, id);
-		if (!p.valid || p.isSuspended() || p.isBypassed())
+		Plugin* p = model::find(model::plugins, id);
+		if (p == nullptr)
+			return false;
+		if (!p->valid || p->isSuspended() || p->isBypassed())
 			continue;
-		p.process(audioBuffer_, events);
+		p->process(audioBuffer_, events);
 		events.clear();
 	}
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* getStackLatency_
+Returns the overall latency of a plug-in stack. Plug-ins not yet in the model
+are ignored: the compensation is computed again once they are loaded. */
+
+Frame getStackLatency_(const std::vector<ID>& pluginIds)
+{
+	Frame latency = 0;
+	for (ID id : pluginIds) {
+		const Plugin* p = model::find(model::plugins, id);
+		if (p != nullptr)
+			latency += p->getLatency();
+	}
+	return latency;
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+
 ID clonePlugin_(ID pluginId)
 {
 	model::PluginsLock l(model::plugins);
@@ -113,6 +175,8 @@ void close()
 {
 	messageManager_->deleteInstance();
 	model::plugins.clear();
+	midiDispatcher::rebuild();
+	delayCompensation_.store(0);
 }
 
 
@@ -123,7 +187,9 @@ void init(int buffersize)
 {
 	messageManager_ = juce::MessageManager::getInstance();
 	audioBuffer_.setSize(G_MAX_IO_CHANS, buffersize);
+	emptyEvents_.ensureSize(G_PLUGIN_MIDI_BUFFER_SIZE);
 	pluginId_ = 0;
+	delayCompensation_.store(0);
 }
 
 
@@ -140,15 +206,24 @@ void processStack(AudioBuffer& outBuf, const std::vector<ID>& pluginIds,
 	If events are not null: MIDI stack (MIDI channels). MIDI channels must not 
 	process the current buffer: give them an empty and clean one. */
 	
+	bool ready;
 	if (events == nullptr) {
 		giadaToJuceTempBuf_(outBuf);
-		juce::MidiBuffer events; // empty
-		processPlugins_(pluginIds, events);
+		ready = processPlugins_(pluginIds, emptyEvents_);
 	}
 	else {
 		audioBuffer_.clear();
-		processPlugins_(pluginIds, *events);
+		ready = processPlugins_(pluginIds, *events);
+	}
+
+	/* An incomplete stack would sound wrong: keep the channel silent until all 
+	its plug-ins are available. */
 
+	if (!ready) {
+		if (events != nullptr)
+			events->clear();
+		outBuf.clear();
+		return;
 	}
 	juceToGiadaOutBuf_(outBuf);
 }
@@ -167,6 +242,9 @@ void addPlugin(std::unique_ptr<Plugin> p, ID channelId)
 	{
 		c.pluginIds.push_back(pluginId);
 	});
+
+	midiDispatcher::rebuild();
+	updateDelayCompensation();
 }
 
 
@@ -182,6 +260,8 @@ void swapPlugin(ID pluginId1, ID pluginId2, ID channelId)
 	
 		std::swap(c.pluginIds.at(a), c.pluginIds.at(b));
 	});
+
+	updateDelayCompensation();
 }
 
 
@@ -196,6 +276,9 @@ void freePlugin(ID pluginId, ID channelId)
 	});
 
 	model::plugins.pop(model::getIndex(model::plugins, pluginId));
+
+	midiDispatcher::rebuild();
+	updateDelayCompensation();
 }
 
 
@@ -203,6 +286,9 @@ void freePlugins(const std::vector<ID>& pluginIds)
 {
 	for (ID id : pluginIds)
 		model::plugins.pop(model::getIndex(model::plugins, id));
+
+	midiDispatcher::rebuild();
+	updateDelayCompensation();
 }
 
 
@@ -214,6 +300,13 @@ void clonePlugins(const Channel& oldChannel, Channel& newChannel)
 	newChannel.pluginIds.clear();
 	for (ID id : oldChannel.pluginIds)
 		newChannel.pluginIds.push_back(clonePlugin_(id));
+
+	/* Same plug-ins, same latency: the clone gets a delay line of the same size,
+	but of its own. */
+
+	if (oldChannel.delayLine != nullptr)
+		newChannel.delayLine = std::make_shared<DelayLine>(
+			oldChannel.delayLine->getDelay(), G_MAX_IO_CHANS);
 }
 
 
@@ -250,6 +343,58 @@ void toggleBypass(ID pluginId)
 	{
 		p.setBypass(!p.isBypassed());
 	});
+
+	updateDelayCompensation();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void updateDelayCompensation()
+{
+	/* Collect the stack latency of each channel first, then swap only those
+	channels whose delay line must change. Delay lines are allocated here, 
+	never in the audio thread. */
+
+	std::vector<std::pair<ID, Frame>> latencies;
+	std::vector<Frame>                delays;
+	Frame                             maxLatency = 0;
+
+	{
+		model::ChannelsLock cl(model::channels);
+		model::PluginsLock  pl(model::plugins);
+
+		for (const Channel* c : model::channels) {
+			if (c->isInternal())
+				continue;
+			Frame latency = getStackLatency_(c->pluginIds);
+			latencies.push_back({ c->id, latency });
+			delays.push_back(c->delayLine != nullptr ? c->delayLine->getDelay() : 0);
+			maxLatency = std::max(maxLatency, latency);
+		}
+	}
+
+	for (size_t i = 0; i < latencies.size(); i++) {
+		Frame delay = maxLatency - latencies[i].second;
+		if (delay == delays[i])
+			continue;
+		model::onSwap(model::channels, latencies[i].first, [&](Channel& c)
+		{
+			c.delayLine = delay > 0 ? std::make_shared<DelayLine>(delay, G_MAX_IO_CHANS) : nullptr;
+		});
+	}
+
+	delayCompensation_.store(maxLatency);
+
+	u::log::print("[pluginHost::updateDelayCompensation] compensation=%d frames\n", 
+		maxLatency);
+}
+
+
+Frame getDelayCompensation()
+{
+	return delayCompensation_.load();
 }
 
 
@@ -57,7 +57,8 @@ Adds a new plugin to channel 'channelId'. */
 void addPlugin(std::unique_ptr<Plugin> p, ID channelId);
 
 /* processStack
-Applies the fx list to the buffer. */
+Applies the fx list to the buffer. The buffer is silenced if some plug-ins in 
+the list are not available yet. */
 
 void processStack(AudioBuffer& outBuf, const std::vector<ID>& pluginIds, 
 	juce::MidiBuffer* events=nullptr);
@@ -88,6 +89,19 @@ void setPluginProgram(ID pluginId, int programIndex);
 
 void toggleBypass(ID pluginId);
 
+/* updateDelayCompensation
+Computes the latency of each channel's plug-in stack and resizes the channel 
+delay lines, so that all channels line up with the slowest stack. Called 
+automatically whenever a plug-in is added, moved, removed or bypassed; call it
+also when channels are added to the mixer. */
+
+void updateDelayCompensation();
+
+/* getDelayCompensation
+Returns the overall delay applied to channels, in frames. */
+
+Frame getDelayCompensation();
+
 /* runDispatchLoop
 Wakes up plugins' GUI manager for N milliseconds. */
 
@@ -29,7 +29,14 @@
 
 
 #include <cassert>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 #include "utils/log.h"
+#include "utils/time.h"
 #include "utils/fs.h"
 #include "utils/string.h"
 #include "core/const.h"
@@ -71,6 +78,212 @@ If some plugins from any stack are missing. */
 
 bool missingPlugins_;
 
+/* mutex_
+Protects pluginId_, unknownPluginList_ and missingPlugins_ when plug-ins are
+created by multiple threads (see deserializePlugins). */
+
+std::mutex mutex_;
+
+/* ScanCacheEntry
+What is known about a plug-in binary after a scan: its modification time, 
+whether it crashed or hung the scanner and the descriptions found inside it. */
+
+struct ScanCacheEntry
+{
+	juce::int64 mtime       = 0;
+	bool        blacklisted = false;
+	std::vector<juce::PluginDescription> descriptions;
+};
+
+/* ScanJob
+A plug-in binary being scanned by a child process. */
+
+struct ScanJob
+{
+	std::string                        path;
+	juce::int64                        mtime;
+	juce::File                         output;
+	std::unique_ptr<juce::ChildProcess> process;
+	juce::uint32                       startTime;
+};
+
+/* scanCache_
+Scan results keyed by plug-in file path. Only binaries not in here or with a 
+different modification time are scanned again. */
+
+std::map<std::string, ScanCacheEntry> scanCache_;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string getCachePath_(const std::string& listPath)
+{
+	return u::fs::stripExt(listPath) + "-cache.xml";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+juce::int64 getMtime_(const std::string& path)
+{
+	return juce::File(path).getLastModificationTime().toMilliseconds();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* startScanJob_
+Spawns a new Giada process in plug-in scanner mode: it loads the binary 'path'
+and writes the descriptions found into a temporary XML file. */
+
+bool startScanJob_(ScanJob& job, int index)
+{
+	juce::File exe = juce::File::getSpecialLocation(juce::File::currentExecutableFile);
+
+	job.output = juce::File::getSpecialLocation(juce::File::tempDirectory)
+		.getNonexistentChildFile("giada-scan-" + juce::String(index), ".xml");
+	job.process   = std::make_unique<juce::ChildProcess>();
+	job.startTime = juce::Time::getMillisecondCounter();
+
+	juce::StringArray args;
+	args.add(exe.getFullPathName());
+	args.add(G_PLUGIN_SCAN_ARG);
+	args.add(job.path);
+	args.add(job.output.getFullPathName());
+
+	return job.process->start(args, 0);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* finishScanJob_
+Stores the result of a terminated (or killed) scan job into the cache. A crash
+or a timeout puts the binary in the blacklist. */
+
+void finishScanJob_(ScanJob& job, bool timedOut)
+{
+	ScanCacheEntry entry;
+	entry.mtime = job.mtime;
+
+	std::unique_ptr<juce::XmlElement> xml;
+	if (!timedOut && job.process->getExitCode() == 0)
+		xml.reset(juce::XmlDocument::parse(job.output));
+
+	if (xml == nullptr) {
+		u::log::print("[pluginManager::scanDirs]   '%s' %s, blacklisted\n", job.path.c_str(), 
+			timedOut ? "timed out" : "crashed");
+		entry.blacklisted = true;
+	}
+	else {
+		forEachXmlChildElement(*xml, e) {
+			juce::PluginDescription pd;
+			if (pd.loadFromXml(*e))
+				entry.descriptions.push_back(pd);
+		}
+		u::log::print("[pluginManager::scanDirs]   '%s' scanned, %lu plugin(s)\n", 
+			job.path.c_str(), entry.descriptions.size());
+	}
+
+	job.output.deleteFile();
+	scanCache_[job.path] = entry;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* runScanJobs_
+Scans all binaries in 'paths' with a pool of child processes. Kills and 
+blacklists the ones that take longer than G_PLUGIN_SCAN_TIMEOUT. */
+
+void runScanJobs_(const std::vector<std::string>& paths, const std::function<void(float)>& cb)
+{
+	const size_t maxJobs = std::max(1u, std::thread::hardware_concurrency());
+
+	std::vector<ScanJob> running;
+	size_t next = 0;
+	size_t done = 0;
+
+	while (done < paths.size()) {
+
+		while (running.size() < maxJobs && next < paths.size()) {
+			ScanJob job;
+			job.path  = paths[next];
+			job.mtime = getMtime_(job.path);
+			if (startScanJob_(job, next))
+				running.push_back(std::move(job));
+			else {
+				u::log::print("[pluginManager::scanDirs] unable to spawn scanner for '%s'\n", 
+					paths[next].c_str());
+				done++;
+			}
+			next++;
+		}
+
+		for (auto it = running.begin(); it != running.end();) {
+			bool timedOut = juce::Time::getMillisecondCounter() - it->startTime > G_PLUGIN_SCAN_TIMEOUT;
+			if (it->process->isRunning() && !timedOut) {
+				++it;
+				continue;
+			}
+			if (timedOut)
+				it->process->kill();
+			finishScanJob_(*it, timedOut);
+			it = running.erase(it);
+			done++;
+		}
+
+		cb(done / static_cast<float>(paths.size()));
+		u::time::sleep(G_PLUGIN_SCAN_POLL_RATE);
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void saveCache_(const std::string& path)
+{
+	juce::XmlElement xml("SCANCACHE");
+	for (const auto& kv : scanCache_) {
+		juce::XmlElement* file = xml.createNewChildElement("FILE");
+		file->setAttribute("path", juce::String(kv.first));
+		file->setAttribute("mtime", juce::String(kv.second.mtime));
+		file->setAttribute("blacklisted", kv.second.blacklisted);
+		for (const juce::PluginDescription& pd : kv.second.descriptions) {
+			std::unique_ptr<juce::XmlElement> e(pd.createXml());
+			file->addChildElement(e.release());
+		}
+	}
+	if (!xml.writeToFile(juce::File(path), ""))
+		u::log::print("[pluginManager::saveCache_] unable to save scan cache to %s\n", path.c_str());
+}
+
+
+void loadCache_(const std::string& path)
+{
+	scanCache_.clear();
+
+	std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(juce::File(path)));
+	if (xml == nullptr)
+		return;
+
+	forEachXmlChildElementWithTagName(*xml, file, "FILE") {
+		ScanCacheEntry entry;
+		entry.mtime       = file->getStringAttribute("mtime").getLargeIntValue();
+		entry.blacklisted = file->getBoolAttribute("blacklisted");
+		forEachXmlChildElement(*file, e) {
+			juce::PluginDescription pd;
+			if (pd.loadFromXml(*e))
+				entry.descriptions.push_back(pd);
+		}
+		scanCache_[file->getStringAttribute("path").toStdString()] = entry;
+	}
+}
+
+
 std::vector<std::string> splitPluginDescription_(const std::string& descr)
 {
 	// input:  VST-mda-Ambience-18fae2d2-6d646141  string
@@ -116,6 +329,66 @@ const juce::PluginDescription* findPluginDescription_(const std::string& id)
 	}
 	return nullptr;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+/* makeInvalid_
+Records plug-in 'fid' as missing and returns its invalid placeholder. Call it 
+with mutex_ held. */
+
+std::unique_ptr<Plugin> makeInvalid_(const std::string& fid, ID id)
+{
+	missingPlugins_ = true;
+	unknownPluginList_.push_back(fid);
+	return std::make_unique<Plugin>(pluginId_.get(id), fid);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* wrap_
+Wraps instance 'pi' of plug-in 'fid' into a Plugin object. A null instance 
+gives an invalid plug-in. */
+
+std::unique_ptr<Plugin> wrap_(juce::AudioPluginInstance* pi, const std::string& fid, ID id)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if (pi == nullptr) {
+		u::log::print("[pluginManager::makePlugin] unable to create instance with fid=%s!\n", fid.c_str());
+		return makeInvalid_(fid, id);
+	}
+	u::log::print("[pluginManager::makePlugin] plugin instance with fid=%s created\n", fid.c_str());
+
+	return std::make_unique<Plugin>(pluginId_.get(id), pi, samplerate_, buffersize_);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* restore_
+Fills plug-in 'plugin' with the state stored in patch data 'p'. */
+
+void restore_(Plugin& plugin, const patch::Plugin& p)
+{
+	if (!plugin.valid)
+		return;
+
+	plugin.setBypass(p.bypass);
+	for (unsigned j=0; j<p.params.size(); j++)
+		plugin.setParameter(j, p.params.at(j));
+
+	/* Fill plug-in MidiIn parameters. Don't fill Channel::midiInParam if 
+	Plugin::midiInParams are zero: it would wipe out the current default 0x0
+	values. */
+	
+	if (!p.midiInParams.empty()) {
+		plugin.midiInParams.clear();
+		for (uint32_t midiInParam : p.midiInParams)
+			plugin.midiInParams.emplace_back(midiInParam);
+	}
+}
 }; // {anonymous}
 
 
@@ -144,22 +417,45 @@ int scanDirs(const std::string& dirs, const std::function<void(float)>& cb)
 	u::log::print("[pluginManager::scanDir] requested directories: '%s'\n", dirs.c_str());
 	u::log::print("[pluginManager::scanDir] current plugins: %d\n", knownPluginList_.getNumTypes());
 
-	knownPluginList_.clear();   // clear up previous plugins
-
 	std::vector<std::string> dirVec = u::string::split(dirs, ";");
 
-	juce::VSTPluginFormat format;
 	juce::FileSearchPath searchPath;
 	for (const std::string& dir : dirVec)
 		searchPath.add(juce::File(dir));
 
-	juce::PluginDirectoryScanner scanner(knownPluginList_, format, searchPath, 
-		/*recursive=*/true, juce::File());
+	juce::StringArray files = pluginFormat_.searchPathsForPlugins(searchPath, 
+		/*recursive=*/true);
 
-	juce::String name;
-	while (scanner.scanNextFile(false, name)) {
-		u::log::print("[pluginManager::scanDir]   scanning '%s'\n", name.toRawUTF8());
-		cb(scanner.getProgress());
+	/* Scan only new binaries or the ones changed since the last scan. The 
+	others are taken from the cache as they are, blacklisted ones included. */
+
+	std::vector<std::string> toScan;
+	for (const juce::String& f : files) {
+		std::string path = f.toStdString();
+		auto it = scanCache_.find(path);
+		if (it == scanCache_.end() || it->second.mtime != getMtime_(path))
+			toScan.push_back(path);
+	}
+
+	u::log::print("[pluginManager::scanDir] %d file(s) found, %lu to scan\n", 
+		files.size(), toScan.size());
+
+	runScanJobs_(toScan, cb);
+
+	/* Rebuild the list of known plug-ins from the cache, with binaries found in
+	the requested directories only. */
+
+	knownPluginList_.clear();
+	knownPluginList_.clearBlacklistedFiles();
+
+	for (const juce::String& f : files) {
+		auto it = scanCache_.find(f.toStdString());
+		if (it == scanCache_.end())
+			continue;
+		if (it->second.blacklisted)
+			knownPluginList_.addToBlacklist(f);
+		for (const juce::PluginDescription& pd : it->second.descriptions)
+			knownPluginList_.addType(pd);
 	}
 
 	u::log::print("[pluginManager::scanDir] %d plugin(s) found\n", knownPluginList_.getNumTypes());
@@ -170,11 +466,33 @@ int scanDirs(const std::string& dirs, const std::function<void(float)>& cb)
 /* -------------------------------------------------------------------------- */
 
 
+int scanFile(const std::string& path, const std::string& outPath)
+{
+	juce::ScopedJuceInitialiser_GUI juceInit;
+
+	juce::VSTPluginFormat                     format;
+	juce::OwnedArray<juce::PluginDescription> found;
+	format.findAllTypesForFile(found, juce::String(path));
+
+	juce::XmlElement xml("PLUGINS");
+	for (const juce::PluginDescription* pd : found) {
+		std::unique_ptr<juce::XmlElement> e(pd->createXml());
+		xml.addChildElement(e.release());
+	}
+
+	return xml.writeToFile(juce::File(outPath), "") ? 0 : 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 int saveList(const std::string& filepath)
 {
 	int out = knownPluginList_.createXml()->writeToFile(juce::File(filepath), "");
 	if (!out)
 		u::log::print("[pluginManager::saveList] unable to save plugin list to %s\n", filepath.c_str());
+	saveCache_(getCachePath_(filepath));
 	return out;
 }
 
@@ -184,6 +502,8 @@ int saveList(const std::string& filepath)
 
 int loadList(const std::string& filepath)
 {
+	loadCache_(getCachePath_(filepath));
+
 	std::unique_ptr<juce::XmlElement> elem(juce::XmlDocument::parse(juce::File(filepath)));
 	if (elem == nullptr)
 		return 0;
@@ -200,26 +520,21 @@ std::unique_ptr<Plugin> makePlugin(const std::string& fid, ID id)
 	/* Plug-in ID generator is updated anyway, as we store Plugin objects also
 	if they are in an invalid state. */
 	
+	std::unique_lock<std::mutex> lock(mutex_);
+
 	pluginId_.set(id);
 
 	const juce::PluginDescription* pd = findPluginDescription_(fid);
 	if (pd == nullptr) {
 		u::log::print("[pluginManager::makePlugin] no plugin found with fid=%s!\n", fid.c_str());
-		missingPlugins_ = true;
-		unknownPluginList_.push_back(fid);
-		return std::make_unique<Plugin>(pluginId_.get(id), fid); // Invalid plug-in
+		return makeInvalid_(fid, id); // Invalid plug-in
 	}
 
-	juce::AudioPluginInstance* pi = pluginFormat_.createInstanceFromDescription(*pd, samplerate_, buffersize_);
-	if (pi == nullptr) {
-		u::log::print("[pluginManager::makePlugin] unable to create instance with fid=%s!\n", fid.c_str());
-		missingPlugins_ = true;
-		unknownPluginList_.push_back(fid);
-		return std::make_unique<Plugin>(pluginId_.get(id), fid); // Invalid plug-in
-	}
-	u::log::print("[pluginManager::makePlugin] plugin instance with fid=%s created\n", fid.c_str());
+	/* Instance creation is the slow part: leave the lock, so that other threads
+	can create their own plug-ins in the meantime. */
 
-	return std::make_unique<Plugin>(pluginId_.get(id), pi, samplerate_, buffersize_);
+	lock.unlock();
+	return wrap_(pluginFormat_.createInstanceFromDescription(*pd, samplerate_, buffersize_), fid, id);
 }
 
 
@@ -281,26 +596,91 @@ const patch::Plugin serializePlugin(const Plugin& p)
 std::unique_ptr<Plugin> deserializePlugin(const patch::Plugin& p)
 {
 	std::unique_ptr<Plugin> plugin = makePlugin(p.path, p.id);
-	if (!plugin->valid)
-		return plugin; // Return invalid version
-	
-	/* Fill plug-in parameters. */
+	restore_(*plugin, p);
+	return plugin;
+}
 
-	plugin->setBypass(p.bypass);
-	for (unsigned j=0; j<p.params.size(); j++)
-		plugin->setParameter(j, p.params.at(j));
 
-	/* Fill plug-in MidiIn parameters. Don't fill Channel::midiInParam if 
-	Plugin::midiInParams are zero: it would wipe out the current default 0x0
-	values. */
-	
-	if (!p.midiInParams.empty()) {
-		plugin->midiInParams.clear();
-		for (uint32_t midiInParam : p.midiInParams)
-			plugin->midiInParams.emplace_back(midiInParam);
+/* -------------------------------------------------------------------------- */
+
+
+void deserializePlugins(const std::vector<patch::Plugin>& plugins, 
+	std::function<void(std::unique_ptr<Plugin>)> cb)
+{
+	/* Plug-ins are created and restored by a pool of worker threads. Formats 
+	that need an unblocked message thread during creation can't be created 
+	there, nor on a blocked message thread: they go through 
+	createPluginInstanceAsync(), whose callback runs on the message thread while
+	the loop below keeps it alive. */
+
+	std::vector<const patch::Plugin*> pooled;
+
+	std::mutex                           readyMutex;
+	std::vector<std::unique_ptr<Plugin>> ready;
+	std::atomic<size_t>                  next(0);
+	size_t                               done = 0;
+
+	for (const patch::Plugin& p : plugins) {
+		const juce::PluginDescription* pd = findPluginDescription_(p.path);
+		if (pd == nullptr || !pluginFormat_.requiresUnblockedMessageThreadDuringCreation(*pd)) {
+			pooled.push_back(&p);
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			pluginId_.set(p.id);
+		}
+		const patch::Plugin* pp = &p;
+		pluginFormat_.createPluginInstanceAsync(*pd, samplerate_, buffersize_, 
+			[&cb, &done, pp](juce::AudioPluginInstance* pi, const juce::String& /*error*/)
+		{
+			std::unique_ptr<Plugin> plugin = wrap_(pi, pp->path, pp->id);
+			restore_(*plugin, *pp);
+			cb(std::move(plugin));
+			done++;
+		});
 	}
 
-	return plugin;
+	auto work = [&]()
+	{
+		size_t i;
+		while ((i = next++) < pooled.size()) {
+			std::unique_ptr<Plugin> p = deserializePlugin(*pooled[i]);
+			std::lock_guard<std::mutex> lock(readyMutex);
+			ready.push_back(std::move(p));
+		}
+	};
+
+	size_t workers = std::min<size_t>(pooled.size(), std::max(1u, std::thread::hardware_concurrency()));
+
+	std::vector<std::thread> pool;
+	for (size_t i = 0; i < workers; i++)
+		pool.emplace_back(work);
+
+	u::log::print("[pluginManager::deserializePlugins] %lu plugin(s) on %lu worker(s), %lu on message thread\n",
+		pooled.size(), workers, plugins.size() - pooled.size());
+
+	/* Hand over plug-ins to the caller as soon as they are ready. Meanwhile keep
+	the message loop alive: it completes the asynchronous creations, and 
+	plug-ins being created in the workers might post calls to the message 
+	thread and wait for them. */
+
+	while (done < plugins.size()) {
+		std::vector<std::unique_ptr<Plugin>> batch;
+		{
+			std::lock_guard<std::mutex> lock(readyMutex);
+			batch.swap(ready);
+		}
+		for (std::unique_ptr<Plugin>& p : batch) {
+			cb(std::move(p));
+			done++;
+		}
+		if (done < plugins.size())
+			juce::MessageManager::getInstance()->runDispatchLoopUntil(G_PLUGIN_LOAD_POLL_RATE);
+	}
+
+	for (std::thread& t : pool)
+		t.join();
 }
 
 
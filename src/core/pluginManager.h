@@ -63,13 +63,24 @@ void init(int samplerate, int buffersize);
 
 /* scanDirs
 Parses plugin directories (semicolon-separated) and store list in 
-knownPluginList. The callback is called on each plugin found. Used to update the 
-main window from the GUI thread. */
+knownPluginList. Binaries are scanned in parallel by child processes, so that a 
+crashing or hanging plug-in ends up in the blacklist instead of taking Giada 
+down. Only new or modified binaries are scanned: the others come from the scan
+cache. The callback is called periodically with the progress. Used to update 
+the main window from the GUI thread. */
 
 int scanDirs(const std::string& paths, const std::function<void(float)>& cb);
 
+/* scanFile
+Entry point of the child process spawned by scanDirs: scans the binary 'path'
+and writes the descriptions found into the XML file 'outPath'. Returns the 
+process exit code. */
+
+int scanFile(const std::string& path, const std::string& outPath);
+
 /* (save|load)List
-(Save|Load) knownPluginList (in|from) an XML file. */
+(Save|Load) knownPluginList (in|from) an XML file. The scan cache is stored
+next to it. */
 
 int saveList(const std::string& path);
 int loadList(const std::string& path);
@@ -94,6 +105,16 @@ Transforms patch data into a Plugin object and vice versa. */
 const patch::Plugin     serializePlugin(const Plugin& p);
 std::unique_ptr<Plugin> deserializePlugin(const patch::Plugin& p);
 
+/* deserializePlugins
+Creates multiple plug-ins from patch data in parallel, on a pool of worker 
+threads. Formats that need an unblocked message thread during creation are 
+instantiated asynchronously on the calling thread, which must be the message 
+one. Callback 'cb' is invoked on the calling thread for each plug-in, as soon 
+as it is ready. */
+
+void deserializePlugins(const std::vector<patch::Plugin>& plugins, 
+	std::function<void(std::unique_ptr<Plugin>)> cb);
+
 /* getAvailablePluginInfo
 Returns the available plugin information (name, type, ...) given a plug-in
 index. */
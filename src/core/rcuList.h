@@ -31,9 +31,12 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
 #include <thread>
 #include <atomic>
 #include <iterator>
+#include <utility>
+#include <vector>
 
 
 namespace giada {
@@ -69,10 +72,12 @@ public:
 	{
 		std::unique_ptr<T> data;
 		std::atomic<Node*> next;
+		std::uint64_t      version;
 
-		Node(std::unique_ptr<T> data, Node* next=nullptr)
-		: data(std::move(data)), 
-		  next(next) 
+		Node(std::unique_ptr<T> data, Node* next=nullptr, std::uint64_t version=0)
+		: data   (std::move(data)), 
+		  next   (next),
+		  version(version)
 		{}
 	};
 
@@ -114,6 +119,14 @@ public:
 				m_curr = m_curr->next;
 			return *this;
 		}
+
+		/* getVersion
+		Returns the version of the current node. See RCUList::getVersion(). */
+
+		std::uint64_t getVersion() const
+		{
+			return m_curr->version;
+		}
 	
 	private:
 	
@@ -125,6 +138,7 @@ public:
 
 	RCUList()
 		: changed  (false),
+		  m_version(0),
 		  m_grace  (0), 
 		  m_size   (0), 
 		  m_writing(false),
@@ -231,9 +245,11 @@ public:
 	Exchanges data contained in node 'i' with new data 'data'. New data must
 	always come from a call to clone(). There is a natural protection against 
 	multiple calls to swap() made by the same thread: the caller is blocked by 
-	the spinlock below: no progress is made until m_readers[oldgrace] > 0. */
+	the spinlock below: no progress is made until m_readers[oldgrace] > 0. 
+	Pass 'keepVersion' = true to carry over the version of the old node: useful
+	for runtime-only changes that version readers must not notice. */
 
-	void swap(std::unique_ptr<T> data, size_t i=0)
+	void swap(std::unique_ptr<T> data, size_t i=0, bool keepVersion=false)
 	{
 		/* Never start two overlapping writing sessions. */
 
@@ -258,7 +274,7 @@ public:
 		
 		/* Prepare a new node holding the new data in input. */
 
-		Node* n = new Node(std::move(data), next);
+		Node* n = new Node(std::move(data), next, keepVersion ? curr->version : ++m_version);
 	
 		/* Make the previous node point to the new one just created. New
 		readers will read the new one from now on. The only write operation 
@@ -288,6 +304,62 @@ public:
 		changed.store(true);
 	}
 
+	/* swap (batch)
+	Same as above, for many nodes at once. Each pair holds a node index and its
+	new data, indexes in ascending order. All nodes are published before the 
+	grace period flips, so that the caller waits for the readers only once for
+	the whole batch. */
+
+	void swap(std::vector<std::pair<size_t, std::unique_ptr<T>>> batch)
+	{
+		/* Never start two overlapping writing sessions. */
+
+		if (m_writing.load() == true || batch.empty())
+			return;
+
+		/* Begin of writing session. */
+
+		m_writing.store(true);
+
+		/* Replace the nodes one by one. getNode() already returns the new nodes
+		for the indexes replaced so far. */
+
+		std::vector<Node*> old;
+		for (auto& [i, data] : batch) {
+			Node* curr = getNode(i);
+			Node* prev = curr == m_head.load() ? nullptr : getNode(i - 1);
+			Node* next = curr == m_tail.load() ? nullptr : getNode(i + 1);
+			Node* n    = new Node(std::move(data), next, ++m_version);
+
+			if (prev != nullptr)
+				prev->next.store(n);
+			else
+				m_head.store(n);
+
+			if (next == nullptr)
+				m_tail.store(n);
+
+			old.push_back(curr);
+		}
+
+		/* Flip the current grace bit and wait until no readers from the previous 
+		grace period are reading the list: only they can still see the old 
+		nodes. */
+
+		std::int8_t oldgrace = m_grace.fetch_xor(1);
+
+		while (m_readers[oldgrace] > 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+		for (Node* n : old)
+			delete n;
+
+		/* End of writing session. */
+
+		m_writing.store(false);
+		changed.store(true);
+	}
+
 	/* push
 	Adds a new element to the list containing 'data'. */
 
@@ -304,7 +376,7 @@ public:
 		
 		/* Create new node. */
 
-		Node* n = new Node(std::move(data));
+		Node* n = new Node(std::move(data), nullptr, ++m_version);
 		
 		/* Update the current tail->next pointer to this node, if a tail exists.
 		I.e., grab the current last node and append it the new one. */
@@ -391,6 +463,7 @@ public:
 		
 		/* End of writing session. Data has changed, set the flag. */
 
+		m_version++;
 		m_writing.store(false);
 		changed.store(true);
 	}
@@ -442,6 +515,7 @@ public:
 
 		/* End of writing session. Data has changed, set the flag. */
 
+		m_version++;
 		m_writing.store(false);
 		changed.store(true);
 	}
@@ -454,6 +528,17 @@ public:
 		return m_size.load();
 	}
 
+	/* getVersion
+	Returns a counter increased on each write (swap, push, pop or clear). Each 
+	node also stores the list version at the time it was written, readable 
+	through Iterator::getVersion(): compare versions to find out what has changed
+	since the last read, without comparing the data itself. */
+
+	std::uint64_t getVersion() const
+	{
+		return m_version.load();
+	}
+
 	/* changed
 	Tells whether the list has been altered with a swap, a push or a pop. */
 
@@ -480,6 +565,7 @@ private:
 		return curr;
 	}
 
+	std::atomic<std::uint64_t>      m_version;
 	std::array<std::atomic<int>, 2> m_readers;
 	std::atomic<std::int8_t>        m_grace;
 	std::atomic<size_t>             m_size;
@@ -34,6 +34,7 @@
 #include "core/conf.h"
 #include "core/mixer.h"
 #include "core/mixerHandler.h"
+#include "core/inputRec.h"
 #include "core/midiDispatcher.h"
 #include "core/recorder.h"
 #include "core/recorderHandler.h"
@@ -84,7 +85,7 @@ bool startInputRec_()
 {
 	if (!kernelAudio::isReady() || !mh::hasRecordableSampleChannels())
 		return false;
-	mixer::startInputRec();
+	inputRec::start(clock::getCurrentFrame());
 	mh::startSequencer();
 	return true;
 }
@@ -191,7 +192,7 @@ bool startInputRec(RecTriggerMode mode)
 			return false;
 		clock::setStatus(ClockStatus::WAITING);
 		clock::rewind();
-		mixer::setSignalCallback(startInputRec_);
+		mixer::armSignal(true);
 		setRecordingInput_(true);
 		return true;
 	}
@@ -205,15 +206,17 @@ void stopInputRec()
 {
 	setRecordingInput_(false);
 
-	mixer::stopInputRec();
-	
+	/* Disarm the signal trigger first, then catch up with a trigger that might
+	have fired in the meantime. */
+
+	mixer::armSignal(false);
+	refresh();
+
 	/* If you stop the Input Recorder in SIGNAL mode before any actual 
 	recording: just clean up everything and return. */
 
-	if (clock::getStatus() == ClockStatus::WAITING) {
+	if (clock::isWaiting())
 		clock::setStatus(ClockStatus::STOPPED);
-		mixer::setSignalCallback(nullptr);
-	}
 	else
 		mh::finalizeInputRec();
 }
@@ -222,6 +225,19 @@ void stopInputRec()
 /* -------------------------------------------------------------------------- */
 
 
+void refresh()
+{
+	/* The audio thread has already started the take and the clock: just make 
+	the RUNNING status official. */
+
+	if (mixer::pollSignal())
+		mh::startSequencer();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool toggleInputRec(RecTriggerMode m)
 {
 	if (isRecordingInput()) {
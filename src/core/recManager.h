@@ -47,6 +47,12 @@ void toggleActionRec(RecTriggerMode m);
 bool startInputRec(RecTriggerMode m);
 void stopInputRec();
 bool toggleInputRec(RecTriggerMode m);
+
+/* refresh
+Completes signal-triggered recordings started by the audio thread. Call it 
+periodically from the main thread. */
+
+void refresh();
 }}} // giada::m::recManager
 
 #endif
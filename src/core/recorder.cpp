@@ -26,6 +26,8 @@
 
 
 #include <memory>
+#include <iterator>
+#include <unordered_map>
 #include <algorithm>
 #include <cassert>
 #include "utils/log.h"
@@ -59,6 +61,64 @@ Action* findAction_(ActionMap& src, ID id)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+
+/* update_
+Refreshes pointers and index after the ActionMap has changed. */
+
+void update_(model::Actions& a)
+{
+	updateMapPointers(a.map);
+	updateIndex(a.map, a.index);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* getView_
+Returns the frame-sorted actions of channel 'channelId' of type 'type', or all
+of them if 'type' == 0. Nullptr if none. Call it with the ActionsLock held. */
+
+const std::vector<const Action*>* getView_(ID channelId, int type=0)
+{
+	const ActionIndex& index = model::actions.get()->index;
+
+	auto ch = index.find(channelId);
+	if (ch == index.end())
+		return nullptr;
+	if (type == 0)
+		return &ch->second.all;
+
+	auto t = ch->second.byType.find(type);
+	if (t == ch->second.byType.end())
+		return nullptr;
+	return &t->second;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* lowerBound_, upperBound_
+Binary search for the first action on or after frame 'f' and strictly after 
+frame 'f' in a frame-sorted view. */
+
+std::vector<const Action*>::const_iterator lowerBound_(const std::vector<const Action*>& v, Frame f)
+{
+	return std::lower_bound(v.begin(), v.end(), f, 
+		[](const Action* a, Frame f) { return a->frame < f; });
+}
+
+
+std::vector<const Action*>::const_iterator upperBound_(const std::vector<const Action*>& v, Frame f)
+{
+	return std::upper_bound(v.begin(), v.end(), f, 
+		[](Frame f, const Action* a) { return f < a->frame; });
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 /* optimize
@@ -83,7 +143,7 @@ void removeIf_(std::function<bool(const Action&)> f)
 			as.erase(std::remove_if(as.begin(), as.end(), f), as.end());
 		}
 		optimize_(a.map);
-		updateMapPointers(a.map);
+		update_(a);
 	});
 }
 } // {anonymous}
@@ -109,6 +169,7 @@ void clearAll()
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
 		a.map.clear();
+		a.index.clear();
 	});
 }
 
@@ -177,7 +238,7 @@ void updateKeyFrames(std::function<Frame(Frame old)> f)
 		}
 	}
 
-	updateMapPointers(ma->map);
+	update_(*ma);
 
 	model::actions.swap(std::move(ma));
 }
@@ -191,6 +252,7 @@ void updateEvent(ID id, MidiEvent e)
 	model::onSwap(model::actions, [&](model::Actions& a)
 	{
 		findAction_(a.map, id)->event = e;
+		updateIndex(a.map, a.index); // Event type might have changed
 	});
 }
 
@@ -227,14 +289,20 @@ void updateSiblings(ID id, ID prevId, ID nextId)
 
 
 bool hasActions(ID channelId, int type)
+{
+	return countActions(channelId, type) > 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int countActions(ID channelId, int type)
 {
 	model::ActionsLock lock(model::actions);
-	
-	for (const auto& kv : model::actions.get()->map)
-		for (const Action& a : kv.second)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
-				return true;
-	return false;
+
+	const std::vector<const Action*>* v = getView_(channelId, type);
+	return v != nullptr ? v->size() : 0;
 }
 
 
@@ -270,7 +338,7 @@ Action rec(ID channelId, Frame frame, MidiEvent event)
 	model::onSwap(model::actions, [&](model::Actions& mas)
 	{
 		mas.map[frame].push_back(a);
-		updateMapPointers(mas.map);
+		update_(mas);
 	});
 
 	return a;
@@ -300,7 +368,7 @@ void rec(std::vector<Action>& as)
 	{
 		for (const Action& a : as)
 			mas.map[a.frame].push_back(a);
-		updateMapPointers(mas.map);
+		update_(mas);
 	});
 }
 
@@ -320,7 +388,7 @@ void rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
 		a1->nextId = a2->id;
 		a2->prevId = a1->id;
 
-		updateMapPointers(mas.map);
+		update_(mas);
 	});
 }
 
@@ -341,17 +409,29 @@ const std::vector<Action>* getActionsOnFrame(Frame frame)
 /* -------------------------------------------------------------------------- */
 
 
-Action getClosestAction(ID channelId, Frame f, int type)
+Action getClosestActionBefore(ID channelId, Frame f, int type)
 {
-	Action out = {};
-	forEachAction([&](const Action& a)
-	{
-		if (a.event.getStatus() != type || a.channelId != channelId)
-			return;
-		if (!out.isValid() || (a.frame <= f && a.frame > out.frame))
-			out = a;
-	});
-	return out;
+	model::ActionsLock lock(model::actions);
+
+	const std::vector<const Action*>* v = getView_(channelId, type);
+	if (v == nullptr)
+		return {};
+
+	auto it = upperBound_(*v, f);
+	return it == v->begin() ? Action{} : **std::prev(it);
+}
+
+
+Action getClosestActionAfter(ID channelId, Frame f, int type)
+{
+	model::ActionsLock lock(model::actions);
+
+	const std::vector<const Action*>* v = getView_(channelId, type);
+	if (v == nullptr)
+		return {};
+
+	auto it = upperBound_(*v, f);
+	return it == v->end() ? Action{} : **it;
 }
 
 
@@ -360,12 +440,31 @@ Action getClosestAction(ID channelId, Frame f, int type)
 
 std::vector<Action> getActionsOnChannel(ID channelId)
 {
+	model::ActionsLock lock(model::actions);
+
 	std::vector<Action> out;
-	forEachAction([&](const Action& a)
-	{
-		if (a.channelId == channelId)
-			out.push_back(a);
-	});
+	const std::vector<const Action*>* v = getView_(channelId);
+	if (v != nullptr)
+		for (const Action* a : *v)
+			out.push_back(*a);
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::vector<Action> getActionsInRange(ID channelId, Frame a, Frame b, int type)
+{
+	model::ActionsLock lock(model::actions);
+
+	std::vector<Action> out;
+	const std::vector<const Action*>* v = getView_(channelId, type);
+	if (v == nullptr)
+		return out;
+
+	for (auto it = lowerBound_(*v, a); it != v->end() && (*it)->frame < b; ++it)
+		out.push_back(**it);
 	return out;
 }
 
@@ -375,12 +474,39 @@ std::vector<Action> getActionsOnChannel(ID channelId)
 
 void updateMapPointers(ActionMap& src)
 {
+	/* Lookup table by id first, to avoid a full scan for each pointer. */
+
+	std::unordered_map<ID, Action*> ids;
+	for (auto& kv : src)
+		for (Action& action : kv.second)
+			ids[action.id] = &action;
+
 	for (auto& kv : src) {
 		for (Action& action : kv.second) {
-			if (action.nextId != 0)
-				action.next = findAction_(src, action.nextId);
-			if (action.prevId != 0)
-				action.prev = findAction_(src, action.prevId);
+			if (action.nextId != 0) {
+				assert(ids.count(action.nextId) == 1);
+				action.next = ids[action.nextId];
+			}
+			if (action.prevId != 0) {
+				assert(ids.count(action.prevId) == 1);
+				action.prev = ids[action.prevId];
+			}
+		}
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void updateIndex(const ActionMap& src, ActionIndex& dst)
+{
+	dst.clear();
+	for (const auto& kv : src) {
+		for (const Action& action : kv.second) {
+			ChannelActions& ca = dst[action.channelId];
+			ca.all.push_back(&action);
+			ca.byType[action.event.getStatus()].push_back(&action);
 		}
 	}
 }
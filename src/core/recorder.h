@@ -30,6 +30,7 @@
 
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <functional>
 #include <memory>
@@ -46,6 +47,23 @@ namespace recorder
 {
 using ActionMap = std::map<Frame, std::vector<Action>>;
 
+/* ChannelActions
+Frame-sorted views of the actions of a channel, pointing into the ActionMap: 
+all of them and grouped by event type. */
+
+struct ChannelActions
+{
+	std::vector<const Action*> all;
+	std::unordered_map<int, std::vector<const Action*>> byType;
+};
+
+/* ActionIndex
+Per-channel views of an ActionMap, for queries that would otherwise scan all
+the recorded actions. Must be rebuilt with updateIndex() whenever the map
+changes. */
+
+using ActionIndex = std::unordered_map<ID, ChannelActions>;
+
 /* init
 Initializes the recorder: everything starts from here. */
 
@@ -98,6 +116,12 @@ Checks if the channel has at least one action recorded. */
 
 bool hasActions(ID channelId, int type=0);
 
+/* countActions
+Returns the number of actions recorded on a channel, of type 'type' or of any
+type if 'type' == 0. */
+
+int countActions(ID channelId, int type=0);
+
 /* makeAction
 Makes a new action given some data. */
 
@@ -138,10 +162,18 @@ Returns a vector of actions belonging to channel 'ch'. */
 
 std::vector<Action> getActionsOnChannel(ID channelId);
 
-/* getClosestAction
-Given a frame 'f' returns the closest action. */
+/* getActionsInRange
+Returns the actions belonging to channel 'channelId' in the [a, b) frame range,
+sorted by frame. Only actions of type 'type', or of any type if 'type' == 0. */
+
+std::vector<Action> getActionsInRange(ID channelId, Frame a, Frame b, int type=0);
+
+/* getClosestActionBefore, getClosestActionAfter
+Given a frame 'f' returns the closest action of type 'type' on or before 'f', 
+or strictly after 'f'. The returned action is invalid if there's none. */
 
-Action getClosestAction(ID channelId, Frame f, int type);
+Action getClosestActionBefore(ID channelId, Frame f, int type);
+Action getClosestActionAfter(ID channelId, Frame f, int type);
 
 /* updateMapPointers
 Updates all prev/next actions pointers into the action map. This is required
@@ -150,6 +182,12 @@ vector makes it reallocating the existing ones. Also needed in model::Data copy
 constructor. */
 
 void updateMapPointers(ActionMap& src); 
+
+/* updateIndex
+Rebuilds the per-channel index 'dst' from the ActionMap 'src'. Also needed in 
+model::Data copy constructor. */
+
+void updateIndex(const ActionMap& src, ActionIndex& dst);
 }}}; // giada::m::recorder::
 
 
@@ -29,6 +29,7 @@
 #include <cmath>
 #include <cassert>
 #include "utils/log.h"
+#include "utils/math.h"
 #include "utils/ver.h"
 #include "model/model.h"
 #include "recorder.h"
@@ -141,21 +142,23 @@ bool isBoundaryEnvelopeAction(const Action& a)
 /* -------------------------------------------------------------------------- */
 
 
-void updateBpm(float oldval, float newval, int oldquanto)
+void updateBpm(Frame oldFramesInLoop, Frame newFramesInLoop, int beats)
 {
+	if (oldFramesInLoop <= 0 || oldFramesInLoop == newFramesInLoop)
+		return;
+
+	/* Actions sitting on the musical grid (quantized ones, for example) move to 
+	the very same grid position in the new loop, with no rounding at all. Any 
+	other action is scaled along. */
+
+	const int divisions = beats * G_BEAT_SUBDIVISIONS;
+
 	recorder::updateKeyFrames([=](Frame old) 
 	{
-		/* The division here cannot be precise. A new frame can be 44099 and the 
-		quantizer set to 44100. That would mean two recs completely useless. So we 
-		compute a reject value ('scarto'): if it's lower than 6 frames the new frame 
-		is collapsed with a quantized frame. FIXME - maybe 6 frames are too low. */
-		Frame frame = (old / newval) * oldval;
-		if (frame != 0) {
-			Frame delta = oldquanto % frame;
-			if (delta > 0 && delta <= 6)
-				frame = frame + delta;
-		}
-		return frame;
+		if (u::math::isOnGrid(old, oldFramesInLoop, divisions))
+			return u::math::gridFrame(u::math::gridIndex(old, oldFramesInLoop, divisions), 
+				newFramesInLoop, divisions);
+		return static_cast<Frame>(std::llround(old * (newFramesInLoop / (double) oldFramesInLoop)));
 	});
 }
 
@@ -182,15 +185,12 @@ bool cloneActions(ID channelId, ID newChannelId)
 	bool cloned = false;
 	std::vector<Action> actions;
 
-	recorder::forEachAction([&](const Action& a) 
-	{
-		if (a.channelId != channelId)
-			return;
+	for (const Action& a : recorder::getActionsOnChannel(channelId)) {
 		Action clone(a);
 		clone.channelId = newChannelId;
 		actions.push_back(clone);
 		cloned = true;
-	});
+	}
 
 	recorder::rec(actions);
 
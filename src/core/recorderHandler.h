@@ -30,6 +30,7 @@
 
 
 #include <unordered_set>
+#include "types.h"
 #include "midiEvent.h"
 
 
@@ -48,9 +49,10 @@ void init();
 bool isBoundaryEnvelopeAction(const Action& a);
 
 /* updateBpm
-Changes actions position by calculating the new bpm value. */
+Moves actions to follow a loop of 'beats' beats whose length has changed from
+'oldFramesInLoop' to 'newFramesInLoop' frames, because of a new bpm value. */
 
-void updateBpm(float oldval, float newval, int oldquanto);
+void updateBpm(Frame oldFramesInLoop, Frame newFramesInLoop, int beats);
 
 /* updateSamplerate
 Changes actions position by taking in account the new samplerate. If 
@@ -0,0 +1,139 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_RING_BUFFER_H
+#define G_RING_BUFFER_H
+
+
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+
+
+namespace giada {
+namespace m
+{
+/* RingBuffer
+Single producer, single consumer lock-free FIFO of samples. Unlike Queue it 
+moves blocks of items at once and its capacity is set at runtime. Memory is 
+allocated only in the constructor. */
+
+template<typename T>
+class RingBuffer
+{
+public:
+
+	RingBuffer(size_t capacity) 
+	: m_data(capacity + 1), // One slot is always empty to tell full from empty
+	  m_head(0), 
+	  m_tail(0)
+	{
+	}
+
+
+	RingBuffer(const RingBuffer&) = delete;
+
+
+	/* write
+	Pushes up to 'count' items from 'data'. Returns the number of items actually
+	written. Producer only. */
+
+	size_t write(const T* data, size_t count)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		count = std::min(count, getWritable(m_head.load(std::memory_order_acquire), tail));
+		
+		size_t first = std::min(count, m_data.size() - tail);
+		std::copy(data, data + first, m_data.begin() + tail);
+		std::copy(data + first, data + count, m_data.begin());
+
+		m_tail.store((tail + count) % m_data.size(), std::memory_order_release);
+		return count;
+	}
+
+
+	/* read
+	Pops up to 'count' items into 'data'. Returns the number of items actually
+	read. Consumer only. */
+
+	size_t read(T* data, size_t count)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		count = std::min(count, getReadable(head, m_tail.load(std::memory_order_acquire)));
+
+		size_t first = std::min(count, m_data.size() - head);
+		std::copy(m_data.begin() + head, m_data.begin() + head + first, data);
+		std::copy(m_data.begin(), m_data.begin() + (count - first), data + first);
+
+		m_head.store((head + count) % m_data.size(), std::memory_order_release);
+		return count;
+	}
+
+
+	size_t countReadable() const
+	{
+		return getReadable(m_head.load(std::memory_order_acquire), 
+			m_tail.load(std::memory_order_acquire));
+	}
+
+
+	size_t countWritable() const
+	{
+		return getWritable(m_head.load(std::memory_order_acquire), 
+			m_tail.load(std::memory_order_acquire));
+	}
+
+
+	size_t getCapacity() const
+	{
+		return m_data.size() - 1;
+	}
+
+private:
+
+	size_t getReadable(size_t head, size_t tail) const
+	{
+		return tail >= head ? tail - head : m_data.size() - head + tail;
+	}
+
+
+	size_t getWritable(size_t head, size_t tail) const
+	{
+		return getCapacity() - getReadable(head, tail);
+	}
+
+
+	std::vector<T> m_data;
+	std::atomic<size_t> m_head;
+	std::atomic<size_t> m_tail;
+};
+}} // giada::m::
+
+
+#endif
@@ -0,0 +1,628 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <unordered_map>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sndfile.h>
+#include "utils/fs.h"
+#include "utils/log.h"
+#include "utils/math.h"
+#include "utils/string.h"
+#include "core/const.h"
+#include "sampleIndex.h"
+
+
+namespace giada {
+namespace m {
+namespace sampleIndex
+{
+namespace
+{
+using Index = std::vector<Entry>;
+
+constexpr char MAGIC_[4] = { 'G', 'S', 'I', '1' };
+
+/* index_
+Last complete index, sorted by path. Replaced as a whole by the indexer, so 
+that searches never wait for it. */
+
+std::shared_ptr<const Index> index_ = std::make_shared<Index>();
+std::mutex                   indexMutex_;
+
+std::string       path_ = "";
+std::thread       indexer_;
+std::atomic<bool> stop_(false);
+std::atomic<bool> running_(false);
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::shared_ptr<const Index> getIndex_()
+{
+	std::lock_guard<std::mutex> lock(indexMutex_);
+	return index_;
+}
+
+
+void setIndex_(std::shared_ptr<const Index> i)
+{
+	std::lock_guard<std::mutex> lock(indexMutex_);
+	index_ = i;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string toLower_(std::string s)
+{
+	std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+	return s;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* tokenize_
+Splits 's' into alphanumeric words. '#' is kept, for keys like 'C#m'. */
+
+std::vector<std::string> tokenize_(const std::string& s)
+{
+	std::vector<std::string> out;
+	std::string token;
+	for (char c : s) {
+		if (std::isalnum(static_cast<unsigned char>(c)) || c == '#')
+			token += c;
+		else
+		if (!token.empty()) {
+			out.push_back(token);
+			token.clear();
+		}
+	}
+	if (!token.empty())
+		out.push_back(token);
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* parseBpm_
+Returns the value of token 't' if it's a number in a sensible bpm range, 0.0f
+otherwise. */
+
+float parseBpm_(const std::string& t)
+{
+	if (t.empty() || t.size() > 6 || !std::all_of(t.begin(), t.end(), 
+		[](unsigned char c) { return std::isdigit(c) || c == '.'; }))
+		return 0.0f;
+	float bpm = std::atof(t.c_str());
+	return bpm >= G_MIN_BPM && bpm <= G_MAX_BPM ? bpm : 0.0f;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* parseKey_
+Returns the normalized key (e.g. 'C#m', 'Eb') in token 't', or an empty string.
+A single note name is accepted only if 'explicit_' is true, i.e. the token 
+follows the word 'key': it would be too ambiguous otherwise. */
+
+std::string parseKey_(const std::string& t, bool explicit_)
+{
+	if (t.empty() || t[0] < 'A' || t[0] > 'G')
+		return "";
+
+	std::string key(1, t[0]);
+	size_t i = 1;
+	if (i < t.size() && (t[i] == '#' || t[i] == 'b'))
+		key += t[i++];
+
+	std::string mode = toLower_(t.substr(i));
+	if (mode == "m" || mode == "min" || mode == "minor")
+		return key + "m";
+	if (mode == "maj" || mode == "major" || (mode.empty() && (key.size() > 1 || explicit_)))
+		return key;
+	return "";
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool stat_(const std::string& path, struct stat& s)
+{
+	return stat(path.c_str(), &s) == 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isAudioFile_(const std::string& path)
+{
+	static const std::vector<std::string> exts = 
+		{ "wav", "aif", "aiff", "flac", "ogg", "au", "caf", "w64" };
+	return std::find(exts.begin(), exts.end(), toLower_(u::fs::getExt(path))) != exts.end();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* walk_
+Appends to 'out' all audio files found in directory 'dir' and its 
+subdirectories. Hidden files and directories are skipped. */
+
+void walk_(const std::string& dir, std::vector<Entry>& out, int depth=0)
+{
+	if (stop_ || depth > G_SAMPLE_INDEX_MAX_DEPTH)
+		return;
+
+	DIR* d = opendir(dir.c_str());
+	if (d == nullptr)
+		return;
+
+	while (dirent* e = readdir(d)) {
+		if (e->d_name[0] == '.')
+			continue;
+		std::string path = dir + G_SLASH + e->d_name;
+		struct stat s;
+		if (!stat_(path, s))
+			continue;
+		if (S_ISDIR(s.st_mode))
+			walk_(path, out, depth + 1);
+		else
+		if (isAudioFile_(path)) {
+			Entry entry;
+			entry.path = path;
+			entry.size = s.st_size;
+			entry.time = s.st_mtime;
+			out.push_back(entry);
+		}
+	}
+	closedir(d);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* readEntry_
+Fills metadata of Entry 'e' from its audio file. Returns false if the file 
+can't be read. */
+
+bool readEntry_(Entry& e)
+{
+	SF_INFO  header;
+	SNDFILE* file = sf_open(e.path.c_str(), SFM_READ, &header);
+	if (file == nullptr)
+		return false;
+
+	e.frames   = header.frames;
+	e.rate     = header.samplerate;
+	e.channels = header.channels;
+
+	for (int str : { SF_STR_TITLE, SF_STR_COMMENT }) {
+		const char* tag = sf_get_string(file, str);
+		if (tag != nullptr)
+			parseTags(tag, e);
+	}
+	parseTags(u::fs::basename(e.path), e);
+
+	/* Loudness: RMS level of the whole file. */
+
+	std::vector<float> buffer(G_SAMPLE_INDEX_READ_SIZE * header.channels);
+	double     sum   = 0.0;
+	sf_count_t count = 0;
+	sf_count_t read;
+	while (!stop_ && (read = sf_readf_float(file, buffer.data(), G_SAMPLE_INDEX_READ_SIZE)) > 0) {
+		for (sf_count_t i = 0; i < read * header.channels; i++)
+			sum += buffer[i] * buffer[i];
+		count += read * header.channels;
+	}
+	e.loudness = count > 0 && sum > 0.0 ? u::math::linearToDB(std::sqrt(sum / count)) : -G_MIN_DB_SCALE;
+
+	sf_close(file);
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+template<typename T>
+void writeValue_(std::ofstream& f, T v)
+{
+	f.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+
+template<typename T>
+bool readValue_(std::ifstream& f, T& v)
+{
+	return static_cast<bool>(f.read(reinterpret_cast<char*>(&v), sizeof(T)));
+}
+
+
+void writeString_(std::ofstream& f, const std::string& s)
+{
+	writeValue_<uint16_t>(f, s.size());
+	f.write(s.data(), s.size());
+}
+
+
+bool readString_(std::ifstream& f, std::string& s)
+{
+	uint16_t size;
+	if (!readValue_(f, size))
+		return false;
+	s.resize(size);
+	return static_cast<bool>(f.read(&s[0], size));
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* read_, write_
+Load and store the index file. Entries are stored field by field. Data is 
+written to a temporary file first and then renamed, so that a crash never 
+leaves a truncated index around. */
+
+bool read_(Index& index)
+{
+	std::ifstream f(path_, std::ios::binary);
+	char     magic[4];
+	uint32_t count;
+	if (!f.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC_, sizeof(MAGIC_)) != 0 || 
+	    !readValue_(f, count))
+		return false;
+
+	index.resize(count);
+	for (Entry& e : index) {
+		if (!readString_(f, e.path)  || !readValue_(f, e.size)     || !readValue_(f, e.time) || 
+		    !readValue_(f, e.frames) || !readValue_(f, e.rate)     || !readValue_(f, e.channels) ||
+		    !readValue_(f, e.bpm)    || !readString_(f, e.key)     || !readValue_(f, e.loudness))
+			return false;
+	}
+	return true;
+}
+
+
+void write_(const Index& index)
+{
+	if (path_ == "")
+		return;
+
+	std::string tmpPath = path_ + ".tmp";
+
+	std::ofstream f(tmpPath, std::ios::binary);
+	f.write(MAGIC_, sizeof(MAGIC_));
+	writeValue_<uint32_t>(f, index.size());
+	for (const Entry& e : index) {
+		writeString_(f, e.path);
+		writeValue_(f, e.size);
+		writeValue_(f, e.time);
+		writeValue_(f, e.frames);
+		writeValue_(f, e.rate);
+		writeValue_(f, e.channels);
+		writeValue_(f, e.bpm);
+		writeString_(f, e.key);
+		writeValue_(f, e.loudness);
+	}
+	f.close();
+
+	if (f.fail() || std::rename(tmpPath.c_str(), path_.c_str()) != 0) {
+		u::log::print("[sampleIndex::write_] unable to store %s\n", path_.c_str());
+		std::remove(tmpPath.c_str());
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* run_
+Indexer body: walks all roots, reads metadata of new or changed files with a 
+pool of worker threads and publishes the new index. */
+
+void run_(std::vector<std::string> roots)
+{
+	Index files;
+	for (const std::string& root : roots)
+		walk_(root, files);
+
+	/* Reuse metadata of files that haven't changed since the last time. */
+
+	std::shared_ptr<const Index>                  old = getIndex_();
+	std::unordered_map<std::string, const Entry*> known;
+	for (const Entry& e : *old)
+		known[e.path] = &e;
+
+	std::vector<size_t> todo;
+	for (size_t i = 0; i < files.size(); i++) {
+		auto it = known.find(files[i].path);
+		if (it != known.end() && it->second->size == files[i].size && it->second->time == files[i].time)
+			files[i] = *it->second;
+		else
+			todo.push_back(i);
+	}
+
+	u::log::print("[sampleIndex] %zu files found, %zu to scan\n", files.size(), todo.size());
+
+	std::vector<char> valid(files.size(), true);
+	std::atomic<size_t> next(0);
+
+	auto work = [&]()
+	{
+		size_t i;
+		while (!stop_ && (i = next++) < todo.size())
+			valid[todo[i]] = readEntry_(files[todo[i]]);
+	};
+
+	size_t workers = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::thread> pool;
+	for (size_t i = 1; i < workers; i++)
+		pool.emplace_back(work);
+	work(); // The indexer thread is part of the pool as well
+	for (std::thread& t : pool)
+		t.join();
+
+	if (stop_)
+		return;
+
+	auto index = std::make_shared<Index>();
+	for (size_t i = 0; i < files.size(); i++)
+		if (valid[i])
+			index->push_back(std::move(files[i]));
+	std::sort(index->begin(), index->end(), [](const Entry& a, const Entry& b) 
+	{ 
+		return a.path < b.path; 
+	});
+
+	write_(*index);
+	setIndex_(index);
+
+	u::log::print("[sampleIndex] %zu files indexed\n", index->size());
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+float Entry::getDuration() const
+{
+	return rate > 0 ? frames / static_cast<float>(rate) : 0.0f;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void init(const std::string& path)
+{
+	path_ = path;
+
+	auto index = std::make_shared<Index>();
+	if (read_(*index))
+		setIndex_(index);
+	else
+		u::log::print("[sampleIndex::init] no valid index in %s\n", path.c_str());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void start(const std::string& roots)
+{
+	stop();
+
+	std::vector<std::string> dirs;
+	for (const std::string& dir : u::string::split(roots, ";"))
+		if (u::string::trim(dir) != "")
+			dirs.push_back(u::string::trim(dir));
+	if (dirs.empty())
+		return;
+
+	stop_    = false;
+	running_ = true;
+	indexer_ = std::thread([dirs]()
+	{
+		run_(dirs);
+		running_ = false;
+	});
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void stop()
+{
+	stop_ = true;
+	if (indexer_.joinable())
+		indexer_.join();
+	running_ = false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool isIndexing()
+{
+	return running_;
+}
+
+
+size_t count()
+{
+	return getIndex_()->size();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::vector<Entry> search(const std::string& query, SortBy sort, size_t max)
+{
+	std::shared_ptr<const Index> index = getIndex_();
+	Query q = parseQuery(query);
+
+	std::vector<Entry> out;
+	for (const Entry& e : *index)
+		if (matches(e, q))
+			out.push_back(e);
+
+	auto compare = [sort](const Entry& a, const Entry& b)
+	{
+		switch (sort) {
+			case SortBy::DURATION: return a.getDuration() < b.getDuration();
+			case SortBy::BPM:      return a.bpm < b.bpm;
+			case SortBy::KEY:      return a.key < b.key;
+			case SortBy::LOUDNESS: return a.loudness > b.loudness;
+			default:               return toLower_(u::fs::basename(a.path)) < toLower_(u::fs::basename(b.path));
+		}
+	};
+
+	/* Sort only what is returned. */
+
+	if (out.size() > max) {
+		std::partial_sort(out.begin(), out.begin() + max, out.end(), compare);
+		out.resize(max);
+	}
+	else
+		std::sort(out.begin(), out.end(), compare);
+
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+Query parseQuery(const std::string& s)
+{
+	Query q;
+	for (const std::string& word : u::string::split(s, " ")) {
+		std::string w = toLower_(u::string::trim(word));
+		if (w.empty())
+			continue;
+		if (w.compare(0, 4, "bpm:") == 0)
+			q.bpm = std::atof(w.c_str() + 4);
+		else
+		if (w.compare(0, 4, "key:") == 0) {
+			std::string key = w.substr(4);
+			if (!key.empty())
+				key[0] = std::toupper(key[0]);
+			q.key = parseKey_(key, /*explicit=*/true);
+		}
+		else
+		if (w.compare(0, 3, "ch:") == 0)
+			q.channels = std::atoi(w.c_str() + 3);
+		else
+		if (w.compare(0, 5, "rate:") == 0)
+			q.rate = std::atoi(w.c_str() + 5);
+		else
+		if (w.compare(0, 4, "dur<") == 0)
+			q.maxDuration = std::atof(w.c_str() + 4);
+		else
+		if (w.compare(0, 4, "dur>") == 0)
+			q.minDuration = std::atof(w.c_str() + 4);
+		else
+			q.words.push_back(w);
+	}
+	return q;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool matches(const Entry& e, const Query& q)
+{
+	if (q.bpm != 0.0f && std::fabs(e.bpm - q.bpm) >= 0.5f)
+		return false;
+	if (q.key != "" && e.key != q.key)
+		return false;
+	if (q.channels != 0 && e.channels != q.channels)
+		return false;
+	if (q.rate != 0 && e.rate != q.rate)
+		return false;
+	if (q.minDuration != 0.0f && e.getDuration() <= q.minDuration)
+		return false;
+	if (q.maxDuration != 0.0f && e.getDuration() >= q.maxDuration)
+		return false;
+
+	if (q.words.empty())
+		return true;
+	std::string name = toLower_(u::fs::basename(e.path));
+	for (const std::string& w : q.words)
+		if (name.find(w) == std::string::npos)
+			return false;
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void parseTags(const std::string& s, Entry& e)
+{
+	std::vector<std::string> tokens = tokenize_(s);
+
+	for (size_t i = 0; i < tokens.size(); i++) {
+		const std::string  t    = tokens[i];
+		const std::string  low  = toLower_(t);
+		const std::string* prev = i > 0 ? &tokens[i - 1] : nullptr;
+
+		if (e.bpm == 0.0f) {
+			if (low.size() > 3 && low.compare(low.size() - 3, 3, "bpm") == 0)
+				e.bpm = parseBpm_(low.substr(0, low.size() - 3));
+			else
+			if (low == "bpm" && prev != nullptr)
+				e.bpm = parseBpm_(*prev);
+		}
+		if (e.key == "")
+			e.key = parseKey_(t, prev != nullptr && toLower_(*prev) == "key");
+	}
+}
+}}}; // giada::m::sampleIndex::
@@ -0,0 +1,125 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_SAMPLE_INDEX_H
+#define G_SAMPLE_INDEX_H
+
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m {
+namespace sampleIndex
+{
+/* Entry
+Metadata of an audio file in the sample library. */
+
+struct Entry
+{
+	std::string path;
+	uint64_t    size     = 0;     // File size, in bytes
+	int64_t     time     = 0;     // File modification time
+	Frame       frames   = 0;
+	int         rate     = 0;
+	int         channels = 0;
+	float       bpm      = 0.0f;  // 0.0f if unknown
+	std::string key;              // Empty if unknown
+	float       loudness = 0.0f;  // RMS level, in dBFS
+
+	float getDuration() const;
+};
+
+enum class SortBy { NAME, DURATION, BPM, KEY, LOUDNESS };
+
+/* Query
+Parsed search string. Free words must all appear in the file name; 'bpm:N', 
+'key:K', 'ch:N' and 'rate:N' filter by metadata; 'dur<N' and 'dur>N' by 
+duration in seconds. */
+
+struct Query
+{
+	std::vector<std::string> words;
+	float       bpm         = 0.0f;
+	std::string key;
+	int         channels    = 0;
+	int         rate        = 0;
+	float       minDuration = 0.0f;
+	float       maxDuration = 0.0f;
+};
+
+/* init
+Loads the index stored in file 'path', if any. The index will be saved there
+by the indexer. */
+
+void init(const std::string& path);
+
+/* start
+Starts indexing the sample library made of the ';'-separated directories in 
+'roots', in background. Files already in the index are scanned again only if 
+their size or modification time have changed. A running indexer is stopped 
+first. */
+
+void start(const std::string& roots);
+
+/* stop
+Stops the indexer, if running, and waits for it. */
+
+void stop();
+
+bool isIndexing();
+
+/* count
+Returns how many files are in the index. */
+
+size_t count();
+
+/* search
+Returns at most 'max' entries matching 'query', sorted by 'sort'. Safe to call
+while indexing: the last complete index is used. */
+
+std::vector<Entry> search(const std::string& query, SortBy sort, size_t max);
+
+/* parseQuery, matches
+Search helpers. */
+
+Query parseQuery(const std::string& s);
+bool matches(const Entry& e, const Query& q);
+
+/* parseTags
+Fills bpm and key of Entry 'e' from a file name or a text tag, e.g. 
+'loop_120bpm_Am.wav'. Fields already set are left untouched. */
+
+void parseTags(const std::string& s, Entry& e);
+}}}; // giada::m::sampleIndex::
+
+
+#endif
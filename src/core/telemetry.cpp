@@ -0,0 +1,85 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/tripleBuffer.h"
+#include "core/telemetry.h"
+
+
+namespace giada {
+namespace m {
+namespace telemetry
+{
+namespace
+{
+TripleBuffer<Snapshot> buffer_;
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+Snapshot& getWriteSnapshot()
+{
+	return buffer_.getWriteBuffer();
+}
+
+
+void publish()
+{
+	buffer_.publish();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void fetch()
+{
+	buffer_.fetch();
+}
+
+
+const Snapshot& get()
+{
+	return buffer_.get();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const Channel* getChannel(ID id)
+{
+	const Snapshot& s = buffer_.get();
+	for (size_t i = 0; i < s.countChannels; i++)
+		if (s.channels[i].id == id)
+			return &s.channels[i];
+	return nullptr;
+}
+}}} // giada::m::telemetry::
@@ -0,0 +1,109 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_TELEMETRY_H
+#define G_TELEMETRY_H
+
+
+#include <array>
+#include <cstddef>
+#include "core/types.h"
+#include "core/const.h"
+
+
+namespace giada {
+namespace m {
+namespace telemetry
+{
+/* Channel
+Runtime state of a channel, as seen by the audio thread at the end of a block. */
+
+struct Channel
+{
+	ID            id;
+	ChannelStatus playStatus;
+	ChannelStatus recStatus;
+	Frame         position;       // Relative to 'begin', -1 if not playing
+	Frame         length;         // end - begin
+	Frame         trackerPreview;
+	bool          armed;
+	bool          mute;
+	bool          solo;
+	bool          hasData;
+	bool          hasActions;
+	bool          readActions;
+	float         peak;           // Post-fader
+	float         rms;            // Post-fader
+	float         stackPeak;      // Plug-in stack output, pre-fader
+};
+
+/* Snapshot
+Everything the UI needs to animate meters, play heads and status widgets, 
+published once per audio block. */
+
+struct Snapshot
+{
+	std::array<Channel, G_MAX_TELEMETRY_CHANNELS> channels;
+	size_t countChannels = 0;
+
+	float peakOut = 0.0f;
+	float rmsOut  = 0.0f;
+	float peakIn  = 0.0f;
+	float rmsIn   = 0.0f;
+
+	ClockStatus clockStatus  = ClockStatus::STOPPED;
+	Frame       currentFrame = 0;
+	int         currentBeat  = 0;
+};
+
+/* getWriteSnapshot, publish
+Audio thread only. Fill the snapshot returned by getWriteSnapshot(), then make 
+it available to the UI with publish(). */
+
+Snapshot& getWriteSnapshot();
+void publish();
+
+/* fetch
+UI thread only. Grabs the latest snapshot published by the audio thread. Call it
+once per refresh cycle, before reading. */
+
+void fetch();
+
+/* get
+UI thread only. Returns the last fetched snapshot. */
+
+const Snapshot& get();
+
+/* getChannel
+UI thread only. Returns the state of channel 'id' in the last fetched snapshot,
+or nullptr if not available. */
+
+const Channel* getChannel(ID id);
+}}} // giada::m::telemetry::
+
+
+#endif
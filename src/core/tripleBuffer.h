@@ -0,0 +1,117 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_TRIPLE_BUFFER_H
+#define G_TRIPLE_BUFFER_H
+
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+namespace giada {
+namespace m
+{
+/* TripleBuffer
+Single producer, single consumer lock-free exchange of the latest value of 
+something. The producer always writes into its own buffer and publishes it; the
+consumer always reads a complete, consistent buffer. Nobody waits for nobody: 
+intermediate values are dropped if the consumer is slower than the producer. */
+
+template<typename T>
+class TripleBuffer
+{
+public:
+
+	TripleBuffer() : m_middle(1), m_write(0), m_read(2)
+	{
+	}
+
+
+	TripleBuffer(const TripleBuffer&) = delete;
+
+
+	/* getWriteBuffer
+	Returns the buffer the producer is allowed to fill. Producer only. */
+
+	T& getWriteBuffer()
+	{
+		return m_buffers[m_write];
+	}
+
+
+	/* publish
+	Makes the write buffer available to the consumer. Producer only. */
+
+	void publish()
+	{
+		m_write = m_middle.exchange(static_cast<std::uint8_t>(m_write | DIRTY)) & INDEX;
+	}
+
+
+	/* fetch
+	Grabs the latest published buffer, if any. Returns false if nothing new has
+	been published since the last fetch. Consumer only. */
+
+	bool fetch()
+	{
+		if ((m_middle.load() & DIRTY) == 0)
+			return false;
+		m_read = m_middle.exchange(m_read) & INDEX;
+		return true;
+	}
+
+
+	/* get
+	Returns the last fetched buffer. Consumer only. */
+
+	const T& get() const
+	{
+		return m_buffers[m_read];
+	}
+
+private:
+
+	static constexpr std::uint8_t INDEX = 0x3;
+	static constexpr std::uint8_t DIRTY = 0x4;
+
+	std::array<T, 3> m_buffers;
+
+	/* m_middle
+	Index of the buffer in between producer and consumer, plus a flag that
+	tells whether it contains unread data. */
+
+	std::atomic<std::uint8_t> m_middle;
+
+	std::uint8_t m_write;
+	std::uint8_t m_read;
+};
+}} // giada::m::
+
+
+#endif
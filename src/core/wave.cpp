@@ -31,6 +31,7 @@
 #include "utils/log.h"
 #include "utils/string.h"
 #include "const.h"
+#include "wavePeaks.h"
 #include "wave.h"
 
 
@@ -39,6 +40,7 @@ namespace m
 {
 Wave::Wave(ID id)
 : id       (id),
+  peaks    (std::make_shared<WavePeaks>(id)),
   m_rate   (0),
   m_bits   (0),
   m_logical(false),
@@ -61,6 +63,7 @@ float* Wave::operator [](int offset) const
 
 Wave::Wave(const Wave& other)
 : id        (other.id), 
+  peaks     (other.peaks),
   m_rate    (other.m_rate),
   m_bits    (other.m_bits),	
   m_logical (false),
@@ -136,6 +139,7 @@ float* Wave::getFrame(int f) const
 
 
 void Wave::setRate(int v)     { m_rate = v; }
+void Wave::setBits(int v)     { m_bits = v; }
 void Wave::setLogical(bool l) { m_logical = l; }
 void Wave::setEdited(bool e)  { m_edited = e; }
 
@@ -30,6 +30,7 @@
 
 
 #include <string>
+#include <memory>
 #include "core/audioBuffer.h"
 #include "core/types.h"
 
@@ -37,6 +38,7 @@
 namespace giada {
 namespace m 
 {
+class WavePeaks;
 class Wave
 {
 public:
@@ -69,6 +71,7 @@ public:
 	void setPath(const std::string& p, int id=-1);
 
 	void setRate(int v);
+	void setBits(int v);
 	void setLogical(bool l);
 	void setEdited(bool e);
 
@@ -88,6 +91,13 @@ public:
 
 	ID id;
 
+	/* peaks
+	Multi-resolution peak cache for drawing. Shared between copies of the same
+	Wave, so that it survives swaps in the model: call peaks->invalidate() after
+	editing the audio data. */
+
+	std::shared_ptr<WavePeaks> peaks;
+
 private:
 
 	AudioBuffer buffer;
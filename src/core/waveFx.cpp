@@ -28,10 +28,12 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <limits>
 #include "core/model/model.h"
 #include "utils/log.h"
 #include "const.h"
 #include "wave.h"
+#include "wavePeaks.h"
 #include "waveFx.h"
 
 
@@ -63,6 +65,22 @@ float getPeak_(const Wave& w, int a, int b)
 	}
 	return peak;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+/* invalidatePeaks_
+Marks the range [a, b) of the peak cache as dirty. Must be called after the 
+edited Wave has been swapped into the model, so that the background worker 
+never computes peaks from stale data. */
+
+void invalidatePeaks_(ID waveId, int a, int b=std::numeric_limits<int>::max())
+{
+	model::WavesLock lock(model::waves);
+	const Wave* w = model::find(model::waves, waveId);
+	if (w != nullptr)
+		w->peaks->invalidate(w->getSize(), a, b);
+}
 }; // {anonymous}
 
 
@@ -85,6 +103,7 @@ void normalizeHard(ID waveId, int a, int b)
 		}
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a, b);
 }
 
 
@@ -123,6 +142,7 @@ void silence(ID waveId, int a, int b)
 				w[i][j] = 0.0f;
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a, b);
 }
 
 
@@ -157,6 +177,7 @@ void cut(ID waveId, int a, int b)
 		w.moveData(newData);
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a);
 }
 
 
@@ -184,6 +205,7 @@ void trim(ID waveId, int a, int b)
 		w.moveData(newData);
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, 0);
 }
 
 
@@ -209,6 +231,7 @@ void paste(const Wave& src, ID waveId, int a)
 		des.moveData(newData);
 		des.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a);
 }
 
 
@@ -233,6 +256,7 @@ void fade(ID waveId, int a, int b, int type)
 		
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a, b + 1);
 }
 
 
@@ -270,6 +294,7 @@ void shift(ID waveId, int offset)
 		std::rotate(begin, end - (offset * w.getChannels()), end);
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, 0);
 }
 
 
@@ -288,6 +313,7 @@ void reverse(ID waveId, int a, int b)
 
 		w.setEdited(true);
 	});
+	invalidatePeaks_(waveId, a, b);
 }
 
 }}}; // giada::m::wfx::
@@ -26,6 +26,15 @@
 
 
 #include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
 #include <sndfile.h>
 #include <samplerate.h>
 #include "utils/log.h"
@@ -46,6 +55,16 @@ namespace
 {
 IdManager waveId_;
 
+/* resampleCachePath_
+Directory where resampled data is stored. Empty string means no cache. */
+
+std::string resampleCachePath_ = "";
+
+/* resampleCacheMaxSize_
+Size limit of the cache, in bytes. */
+
+long long resampleCacheMaxSize_ = 0;
+
 
 /* -------------------------------------------------------------------------- */
 
@@ -68,6 +87,193 @@ int getBits_(const SF_INFO& header)
 		return 64;
 	return 0;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int gcd_(int a, int b)
+{
+	return b == 0 ? a : gcd_(b, a % b);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* makeCachePath_
+Returns the path of the cached resampled version of Wave 'w'. The file name
+is made of the audio hash, the number of channels, the source and the target 
+rate and the resampling quality. */
+
+std::string makeCachePath_(const Wave& w, int quality, int samplerate)
+{
+	char name[128];
+	snprintf(name, sizeof(name), "%016llx-%d-%d-%d-%d.wav", 
+		static_cast<unsigned long long>(getHash(w)), w.getChannels(), w.getRate(), 
+		samplerate, quality);
+	return resampleCachePath_ + G_SLASH + name;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* readCache_
+Fills 'out' with resampled data from the cache file 'path', if any. Returns 
+false if the file is missing or doesn't match what is expected. */
+
+bool readCache_(const std::string& path, AudioBuffer& out, int channels, int samplerate)
+{
+	SF_INFO  header;
+	SNDFILE* file = sf_open(path.c_str(), SFM_READ, &header);
+	if (file == nullptr)
+		return false;
+
+	bool ok = header.channels == channels && header.samplerate == samplerate && 
+	          header.frames > 0;
+	if (ok) {
+		out.alloc(header.frames, channels);
+		ok = sf_readf_float(file, out[0], header.frames) == header.frames;
+	}
+
+	sf_close(file);
+	return ok;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* writeCache_
+Stores resampled data 'in' into the cache file 'path'. Data is written to a 
+temporary file first and then renamed, so that a crash or a concurrent Giada 
+instance never leave a truncated cache entry around. */
+
+void writeCache_(const std::string& path, const AudioBuffer& in, int samplerate)
+{
+	std::string tmpPath = path + ".tmp";
+
+	SF_INFO header;
+	header.samplerate = samplerate;
+	header.channels   = in.countChannels();
+	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+
+	SNDFILE* file = sf_open(tmpPath.c_str(), SFM_WRITE, &header);
+	if (file == nullptr) {
+		u::log::print("[waveManager::writeCache_] unable to write %s\n", tmpPath.c_str());
+		return;
+	}
+
+	bool ok = sf_writef_float(file, in[0], in.countFrames()) == in.countFrames();
+	sf_close(file);
+
+	if (!ok || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+		u::log::print("[waveManager::writeCache_] unable to store %s\n", path.c_str());
+		std::remove(tmpPath.c_str());
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* trimCache_
+Deletes the least recently used cache entries until the cache fits in 
+resampleCacheMaxSize_. Entries are ordered by modification time, which is 
+refreshed on every cache hit. The entry at 'keep', just written, is spared. */
+
+void trimCache_(const std::string& keep)
+{
+	struct Entry
+	{
+		std::string path;
+		long long   size;
+		time_t      time;
+	};
+
+	std::vector<Entry> entries;
+	long long          total = 0;
+
+	DIR* d = opendir(resampleCachePath_.c_str());
+	if (d == nullptr)
+		return;
+	while (dirent* e = readdir(d)) {
+		if (e->d_name[0] == '.')
+			continue;
+		std::string path = resampleCachePath_ + G_SLASH + e->d_name;
+		struct stat s;
+		if (stat(path.c_str(), &s) != 0 || !S_ISREG(s.st_mode))
+			continue;
+		total += s.st_size;
+		if (path != keep)
+			entries.push_back({ path, static_cast<long long>(s.st_size), s.st_mtime });
+	}
+	closedir(d);
+
+	if (total <= resampleCacheMaxSize_)
+		return;
+
+	std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+	{
+		return a.time < b.time;
+	});
+
+	for (const Entry& e : entries) {
+		if (total <= resampleCacheMaxSize_)
+			break;
+		if (std::remove(e.path.c_str()) == 0) {
+			u::log::print("[waveManager::trimCache_] evicted %s\n", e.path.c_str());
+			total -= e.size;
+		}
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+/* resampleChunk_
+Converts input frames [a, b) of Wave 'src' into 'dst'. Each chunk starts on a 
+frame where input and output grids line up (multiple of 'inStep'), so that the 
+output can be written at the exact position a single-pass conversion would 
+produce. Up to G_RESAMPLE_CHUNK_PAD extra frames on both sides are fed to the 
+converter and then discarded, giving the filter the same context it would see 
+in a single pass. */
+
+int resampleChunk_(const Wave& src, AudioBuffer& dst, int a, int b, int quality, 
+	double ratio, int inStep, int outStep)
+{
+	int pad       = ((G_RESAMPLE_CHUNK_PAD + inStep - 1) / inStep) * inStep;
+	int padA      = std::min(a, pad);
+	int inBegin   = a - padA;
+	int inEnd     = std::min(src.getSize(), b + pad);
+	int channels  = src.getChannels();
+	int outFrames = ceil((inEnd - inBegin) * ratio);
+
+	std::vector<float> out(outFrames * channels);
+
+	SRC_DATA src_data;
+	src_data.data_in       = src.getFrame(inBegin);
+	src_data.input_frames  = inEnd - inBegin;
+	src_data.data_out      = out.data();
+	src_data.output_frames = outFrames;
+	src_data.src_ratio     = ratio;
+
+	int ret = src_simple(&src_data, quality, channels);
+	if (ret != 0) {
+		u::log::print("[waveManager::resampleChunk_] resampling error: %s\n", src_strerror(ret));
+		return G_RES_ERR_PROCESSING;
+	}
+
+	/* Skip the output produced by the leading padding, then copy what belongs
+	to this chunk only. The last chunk takes whatever is left in 'dst'. */
+
+	int skip     = (padA / inStep) * outStep;
+	int outBegin = (a / inStep) * outStep;
+	int outEnd   = b == src.getSize() ? dst.countFrames() : (b / inStep) * outStep;
+	int count    = std::min<int>(outEnd - outBegin, src_data.output_frames_gen - skip);
+
+	if (count > 0)
+		dst.copyData(out.data() + (skip * channels), count, outBegin);
+
+	return G_RES_OK;
+}
 }; // {anonymous}
 
 
@@ -146,6 +352,26 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
 /* -------------------------------------------------------------------------- */
 
 
+std::unique_ptr<Wave> createFromBuffer(AudioBuffer& b, int samplerate, 
+	const std::string& name)
+{
+	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.get());
+	wave->moveData(b);
+	wave->setRate(samplerate);
+	wave->setBits(G_DEFAULT_BIT_DEPTH);
+	wave->setPath(name);
+	wave->setLogical(true);
+
+	u::log::print("[waveManager::createFromBuffer] new Wave created, %d frames\n", 
+		wave->getSize());
+
+	return wave;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 {
 	int channels = src.getChannels();
@@ -180,27 +406,109 @@ const patch::Wave serializeWave(const Wave& w)
 /* -------------------------------------------------------------------------- */
 
 
-int resample(Wave& w, int quality, int samplerate)
+uint64_t getHash(const Wave& w)
 {
-	float ratio = samplerate / (float) w.getRate();
-	int newSizeFrames = ceil(w.getSize() * ratio);
+	uint64_t h = 0xcbf29ce484222325;
+	if (w.getSize() == 0)
+		return h;
+
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(w.getFrame(0));
+	size_t               size = w.getSize() * w.getChannels() * sizeof(float);
+
+	for (size_t i = 0; i < size; i++) {
+		h ^= data[i];
+		h *= 0x100000001b3;
+	}
+	return h;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void setResampleCachePath(const std::string& path, int maxSize)
+{
+	resampleCachePath_    = path;
+	resampleCacheMaxSize_ = maxSize * 1024LL * 1024LL;
+
+	if (path == "" || u::fs::dirExists(path))
+		return;
+	if (!u::fs::mkdir(path)) {
+		u::log::print("[waveManager::setResampleCachePath] unable to create %s, cache disabled\n", 
+			path.c_str());
+		resampleCachePath_ = "";
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+int resample(Wave& w, int quality, int samplerate, int chunkSize)
+{
+	if (w.getSize() == 0)
+		return G_RES_ERR_NO_DATA;
+
+	double ratio         = samplerate / static_cast<double>(w.getRate());
+	int    newSizeFrames = ceil(w.getSize() * ratio);
+
+	/* Look for a previously resampled version of the same audio data first. */
+
+	std::string cachePath = resampleCachePath_ != "" ? makeCachePath_(w, quality, samplerate) : "";
 
 	AudioBuffer newData;
-	newData.alloc(newSizeFrames, w.getChannels());
 
-	SRC_DATA src_data;
-	src_data.data_in       = w.getFrame(0);
-	src_data.input_frames  = w.getSize();
-	src_data.data_out      = newData[0];
-	src_data.output_frames = newSizeFrames;
-	src_data.src_ratio     = ratio;
+	if (cachePath != "" && readCache_(cachePath, newData, w.getChannels(), samplerate)) {
+		u::log::print("[waveManager::resample] cache hit: %s\n", cachePath.c_str());
+		utime(cachePath.c_str(), nullptr); // Most recently used
+		w.moveData(newData);
+		w.setRate(samplerate);
+		return G_RES_OK;
+	}
 
-	u::log::print("[waveManager::resample] resampling: new size=%d frames\n", newSizeFrames);
+	newData.alloc(newSizeFrames, w.getChannels());
 
-	int ret = src_simple(&src_data, quality, w.getChannels());
-	if (ret != 0) {
-		u::log::print("[waveManager::resample] resampling error: %s\n", src_strerror(ret));
-		return G_RES_ERR_PROCESSING;
+	/* Chunk boundaries must fall on frames where the input and output grids 
+	meet, i.e. multiples of inStep = inRate / gcd(inRate, outRate). */
+
+	int gcd       = gcd_(w.getRate(), samplerate);
+	int inStep    = w.getRate() / gcd;
+	int outStep   = samplerate / gcd;
+	chunkSize     = std::max(1, chunkSize / inStep) * inStep;
+	int chunks    = (w.getSize() + chunkSize - 1) / chunkSize;
+	int workers   = std::max(1, std::min<int>(chunks, std::thread::hardware_concurrency()));
+
+	u::log::print("[waveManager::resample] resampling: new size=%d frames, %d chunks, %d workers\n", 
+		newSizeFrames, chunks, workers);
+
+	std::atomic<int> nextChunk(0);
+	std::atomic<int> status(G_RES_OK);
+
+	auto work = [&]()
+	{
+		int i;
+		while ((i = nextChunk++) < chunks && status == G_RES_OK) {
+			int a   = i * chunkSize;
+			int b   = std::min(w.getSize(), a + chunkSize);
+			int res = resampleChunk_(w, newData, a, b, quality, ratio, inStep, outStep);
+			if (res != G_RES_OK)
+				status = res;
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 1; i < workers; i++)
+		pool.emplace_back(work);
+	work(); // The calling thread is part of the pool as well
+	for (std::thread& t : pool)
+		t.join();
+
+	if (status != G_RES_OK)
+		return status;
+
+	if (cachePath != "") {
+		writeCache_(cachePath, newData, samplerate);
+		trimCache_(cachePath);
 	}
 
 	w.moveData(newData);
@@ -31,13 +31,16 @@
 
 #include <string>
 #include <memory>
+#include <cstdint>
 #include "core/types.h"
+#include "core/const.h"
 
 
 namespace giada {
 namespace m 
 {
 class Wave;
+class AudioBuffer;
 namespace patch
 {
 class Wave;
@@ -66,6 +69,13 @@ Creates a new silent Wave object. */
 std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate, 
     const std::string& name);
 
+/* createFromBuffer
+Creates a new memory-only Wave that takes ownership of the data in 'b', which
+becomes empty. No audio data is copied. */
+
+std::unique_ptr<Wave> createFromBuffer(AudioBuffer& b, int samplerate, 
+    const std::string& name);
+
 /* createFromWave
 Creates a new Wave from an existing one, copying the data in range a - b. */
 
@@ -77,7 +87,27 @@ Creates a new Wave given the patch raw data and vice versa. */
 std::unique_ptr<Wave> deserializeWave(const patch::Wave& w);
 const patch::Wave     serializeWave(const Wave& w);
 
-int resample(Wave& w, int quality, int samplerate); 
+/* getHash
+64-bit FNV-1a hash of the raw audio data held by Wave 'w'. */
+
+uint64_t getHash(const Wave& w);
+
+/* setResampleCachePath
+Enables the on-disk cache of resampled Waves in directory 'path', creating it 
+if necessary. An empty string disables the cache. The cache never grows beyond
+'maxSize' megabytes: the least recently used entries are deleted first. */
+
+void setResampleCachePath(const std::string& path, 
+	int maxSize=G_RESAMPLE_CACHE_MAX_SIZE);
+
+/* resample
+Converts Wave 'w' to 'samplerate'. Data is split into chunks of 'chunkSize' 
+frames, converted in parallel by a pool of worker threads. If the cache is 
+enabled the result is read from (or stored into) it, keyed by audio hash, 
+target rate and quality. */
+
+int resample(Wave& w, int quality, int samplerate, 
+	int chunkSize=G_RESAMPLE_CHUNK_SIZE); 
 
 /* save
 Writes Wave data to file 'path'. Only 'wav' format is supported for now. */
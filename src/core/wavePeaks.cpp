@@ -0,0 +1,432 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#include <algorithm>
+#include <string>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include "core/model/model.h"
+#include "core/wave.h"
+#include "core/peakCache.h"
+#include "wavePeaks.h"
+
+
+namespace giada {
+namespace m
+{
+namespace
+{
+/* CHUNK_SIZE_
+How many frames the worker computes for each lock on the model. */
+
+constexpr Frame CHUNK_SIZE_ = WavePeaks::LEVELS.back() * 64;
+
+
+/* Worker_
+The background thread shared by all WavePeaks, along with its queue. Stopped 
+and joined on exit. */
+
+struct Worker_
+{
+	~Worker_()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		cond.notify_one();
+		if (thread.joinable())
+			thread.join();
+	}
+
+	std::mutex                           mutex;
+	std::condition_variable              cond;
+	std::deque<std::weak_ptr<WavePeaks>> queue;
+	std::thread                          thread;
+	bool                                 stop = false;
+};
+
+Worker_ worker_;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void merge_(WavePeaks::Peak& p, WavePeaks::Peak q)
+{
+	p.min = std::min(p.min, q.min);
+	p.max = std::max(p.max, q.max);
+}
+} // {anonymous}
+
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+
+constexpr std::array<Frame, 4> WavePeaks::LEVELS;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::resize(Levels& levels, Frame size)
+{
+	for (size_t l = 0; l < LEVELS.size(); l++)
+		levels[l].resize((size + LEVELS[l] - 1) / LEVELS[l], { 0.0f, 0.0f });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::build(const Wave& w, Frame a, Frame b, Levels& levels)
+{
+	const Frame size = w.getSize();
+
+	/* Align the range to the coarsest level, so that each level can be derived
+	entirely from the previous one. */
+
+	const Frame top = LEVELS.back();
+
+	a = (a / top) * top;
+	b = std::min(((b + top - 1) / top) * top, size);
+
+	/* Finest level: scan the original frames, averaging channels. */
+
+	for (Frame i = a / LEVELS[0]; i * LEVELS[0] < b; i++) {
+		Peak  p   = { 0.0f, 0.0f };
+		Frame end = std::min((i + 1) * LEVELS[0], size);
+		for (Frame k = i * LEVELS[0]; k < end; k++) {
+			const float* frame = w.getFrame(k);
+			float avg = 0.0f;
+			for (int j = 0; j < w.getChannels(); j++)
+				avg += frame[j];
+			avg /= w.getChannels();
+			merge_(p, { avg, avg });
+		}
+		levels[0][i] = p;
+	}
+
+	/* Coarser levels: merge blocks of the previous one. */
+
+	for (size_t l = 1; l < LEVELS.size(); l++) {
+		const std::vector<Peak>& prev  = levels[l - 1];
+		const Frame              ratio = LEVELS[l] / LEVELS[l - 1];
+		for (Frame i = a / LEVELS[l]; i * LEVELS[l] < b; i++) {
+			Peak  p   = { 0.0f, 0.0f };
+			Frame end = std::min<Frame>((i + 1) * ratio, prev.size());
+			for (Frame k = i * ratio; k < end; k++)
+				merge_(p, prev[k]);
+			levels[l][i] = p;
+		}
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WavePeaks::find(const Levels& levels, Frame a, Frame b, Peak& out)
+{
+	int level = -1;
+	for (size_t l = 0; l < LEVELS.size(); l++)
+		if (LEVELS[l] <= b - a)
+			level = l;
+	if (level == -1)
+		return false;
+
+	const std::vector<Peak>& blocks = levels[level];
+	const Frame              size   = LEVELS[level];
+
+	out = { 0.0f, 0.0f };
+	for (Frame i = a / size; i <= (b - 1) / size && i < static_cast<Frame>(blocks.size()); i++)
+		merge_(out, blocks[i]);
+	return true;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+WavePeaks::WavePeaks(ID waveId)
+: m_waveId   (waveId),
+  m_size     (0),
+  m_dirtyA   (0),
+  m_dirtyB   (0),
+  m_pristine (true),
+  m_stored   (false),
+  m_requested(false),
+  m_loaded   (false),
+  m_queued   (false),
+  m_version  (0)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::request(Frame size)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_requested)
+			return;
+		m_size = size;
+		resize(m_levels, size);
+		m_dirtyA    = 0;
+		m_dirtyB    = size;
+		m_requested = true;
+	}
+	schedule_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::invalidate(Frame size, Frame a, Frame b)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_requested)
+			return;
+
+		m_size = size;
+		resize(m_levels, size);
+		m_pristine = false;
+
+		a = std::max<Frame>(a, 0);
+		b = std::min(b, size);
+
+		if (m_dirtyA >= m_dirtyB) {
+			m_dirtyA = a;
+			m_dirtyB = b;
+		}
+		else {
+			m_dirtyA = std::min(m_dirtyA, a);
+			m_dirtyB = std::min(std::max(m_dirtyB, b), size);
+		}
+	}
+	schedule_();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WavePeaks::get(Frame a, Frame b, Peak& out) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return find(m_levels, a, b, out);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WavePeaks::isReady() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_dirtyA >= m_dirtyB;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::uint64_t WavePeaks::getVersion() const
+{
+	return m_version.load();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::work_()
+{
+	while (true) {
+		std::shared_ptr<WavePeaks> p;
+		{
+			std::unique_lock<std::mutex> lock(worker_.mutex);
+			worker_.cond.wait(lock, [] { return worker_.stop || !worker_.queue.empty(); });
+			if (worker_.stop)
+				return;
+			p = worker_.queue.front().lock();
+			worker_.queue.pop_front();
+			if (p == nullptr) // Wave deleted in the meantime
+				continue;
+			p->m_queued = false;
+		}
+
+		/* One step at a time, then back to the end of the queue: a big Wave 
+		doesn't hold up the others. */
+
+		if (p->step_())
+			p->schedule_();
+	}
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::schedule_()
+{
+	{
+		std::lock_guard<std::mutex> lock(worker_.mutex);
+		if (m_queued)
+			return;
+		if (!worker_.thread.joinable())
+			worker_.thread = std::thread(&WavePeaks::work_);
+		worker_.queue.push_back(shared_from_this());
+		m_queued = true;
+	}
+	worker_.cond.notify_one();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool WavePeaks::step_()
+{
+	bool loaded;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		loaded   = m_loaded;
+		m_loaded = true;
+	}
+	if (!loaded)
+		load_();
+
+	Frame a, b;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_dirtyA >= m_dirtyB)
+			return false;
+		a = m_dirtyA;
+		b = std::min(m_dirtyA + CHUNK_SIZE_, m_dirtyB);
+		m_dirtyA = b;
+	}
+
+	/* Lock the model for one chunk at a time: an edit swapping the Wave 
+	would otherwise wait for the whole build to complete. */
+
+	{
+		model::WavesLock wl(model::waves);
+		const Wave* w = model::find(model::waves, m_waveId);
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		/* A size mismatch means the Wave has been edited in the meantime: a 
+		new invalidate() call will follow. */
+
+		if (w != nullptr && w->getSize() == m_size)
+			build(*w, a, b, m_levels);
+	}
+
+	if (!isReady())
+		return true;
+	m_version++;
+	store_();
+	return false;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::load_()
+{
+	std::string path;
+	Frame       size;
+	{
+		model::WavesLock lock(model::waves);
+		const Wave* w = model::find(model::waves, m_waveId);
+		if (w == nullptr || w->isLogical())
+			return;
+		path = w->getPath();
+		size = w->getSize();
+	}
+
+	/* Disk access happens without holding the model. */
+
+	Levels levels;
+	Frame  frames;
+	if (!peakCache::read(path, levels, frames) || frames != size)
+		return;
+	{
+		/* Discard peaks if the Wave has been edited in the meantime. */
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_pristine || frames != m_size)
+			return;
+		m_levels = std::move(levels);
+		m_dirtyA = 0;
+		m_dirtyB = 0;
+		m_stored = true;
+	}
+	m_version++;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void WavePeaks::store_()
+{
+	Levels levels;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_pristine || m_stored)
+			return;
+		levels   = m_levels;
+		m_stored = true;
+	}
+
+	/* Only copy what identifies the audio file under the lock: the file I/O 
+	happens outside it. */
+
+	std::string path;
+	Frame       frames;
+	{
+		model::WavesLock lock(model::waves);
+		const Wave* w = model::find(model::waves, m_waveId);
+		if (w == nullptr || w->isLogical() || w->isEdited())
+			return;
+		path   = w->getPath();
+		frames = w->getSize();
+	}
+	peakCache::write(path, frames, levels);
+}
+}} // giada::m::
@@ -0,0 +1,182 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+
+#ifndef G_WAVE_PEAKS_H
+#define G_WAVE_PEAKS_H
+
+
+#include <array>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include "core/types.h"
+
+
+namespace giada {
+namespace m
+{
+class Wave;
+
+/* WavePeaks
+Multi-resolution peak cache (a.k.a. waveform mipmaps) of a Wave. Each level 
+stores min/max of the channel average for blocks of LEVELS[i] frames, so that 
+drawing a waveform costs O(pixels) instead of O(frames). Levels are built in 
+background by a single worker thread shared by all Waves, which takes turns 
+between the WavePeaks waiting in its queue. Must be owned by a shared_ptr. */
+
+class WavePeaks : public std::enable_shared_from_this<WavePeaks>
+{
+public:
+
+	struct Peak
+	{
+		float min;
+		float max;
+	};
+
+	/* LEVELS
+	Block size of each level, in frames. Each level must be a multiple of the 
+	previous one. */
+
+	static constexpr std::array<Frame, 4> LEVELS = { 64, 256, 1024, 4096 };
+
+	using Levels = std::array<std::vector<Peak>, LEVELS.size()>;
+
+	/* resize
+	Resizes all 'levels' for a Wave of 'size' frames. */
+
+	static void resize(Levels& levels, Frame size);
+
+	/* build
+	Computes 'levels' for frames in range [a, b) of Wave 'w'. Levels must be 
+	already sized to 'w' with resize(). */
+
+	static void build(const Wave& w, Frame a, Frame b, Levels& levels);
+
+	/* find
+	Returns min/max for frames in range [a, b) of 'levels', using the coarsest 
+	level that fits the range. Returns false if the range is shorter than the 
+	finest level: in that case read frames straight from the Wave. */
+
+	static bool find(const Levels& levels, Frame a, Frame b, Peak& out);
+
+	WavePeaks(ID waveId);
+
+	/* request
+	Schedules a full build for a Wave of 'size' frames on the shared worker, if
+	not requested yet. The worker looks for a peak file in the on-disk cache 
+	first, and stores one when the build is complete. */
+
+	void request(Frame size);
+
+	/* invalidate
+	Marks frames in range [a, b) as dirty for a Wave that is now 'size' frames
+	long, and schedules them on the worker. Does nothing if peaks were never 
+	requested. Call it after the edited Wave has been swapped into the model. */
+
+	void invalidate(Frame size, Frame a, Frame b);
+
+	/* get
+	Same as find(), on the levels built so far. */
+
+	bool get(Frame a, Frame b, Peak& out) const;
+
+	/* isReady
+	True if there are no dirty ranges left to compute. */
+
+	bool isReady() const;
+
+	/* getVersion
+	Incremented each time the worker completes a pass. Useful to know when to
+	redraw a stale waveform. */
+
+	std::uint64_t getVersion() const;
+
+private:
+
+	/* work_
+	Worker loop, shared by all WavePeaks: pops a WavePeaks from the queue, runs 
+	one step_() on it and puts it back at the end of the queue if there is more
+	work to do. */
+
+	static void work_();
+
+	/* schedule_
+	Puts this WavePeaks in the worker queue, if not there already. Starts the 
+	worker on first use. */
+
+	void schedule_();
+
+	/* step_
+	Loads peaks from the on-disk cache on the first call, then computes one 
+	chunk of dirty frames under a lock on the model. Returns true if there are 
+	dirty frames left. */
+
+	bool step_();
+
+	/* load_, store_
+	Read and write peaks from/to the on-disk cache. See peakCache. */
+
+	void load_();
+	void store_();
+
+	ID m_waveId;
+
+	Levels m_levels;
+	Frame  m_size;
+
+	/* m_dirtyA, m_dirtyB
+	Range of frames still to compute. Empty if m_dirtyA >= m_dirtyB. */
+
+	Frame m_dirtyA;
+	Frame m_dirtyB;
+
+	/* m_pristine
+	True if the Wave hasn't been edited since the first request(): only then 
+	peaks can be read from, or written to, the on-disk cache. */
+
+	bool m_pristine;
+	bool m_stored;
+	bool m_requested;
+	bool m_loaded;
+
+	/* m_queued
+	Whether this WavePeaks is in the worker queue. Guarded by the queue 
+	mutex. */
+
+	bool m_queued;
+
+	mutable std::mutex         m_mutex;
+	std::atomic<std::uint64_t> m_version;
+};
+}} // giada::m::
+
+
+#endif
@@ -86,7 +86,12 @@ void recordNonFirstEnvelopeAction_(ID channelId, Frame frame, int value)
 {
 	namespace mr = m::recorder;
 
-	const m::Action a1 = mr::getClosestAction(channelId, frame, m::MidiEvent::ENVELOPE);
+	/* No point on or before 'frame' (shouldn't happen, the first point sits on 
+	frame 0): fall back to the first one. */
+
+	m::Action a1 = mr::getClosestActionBefore(channelId, frame, m::MidiEvent::ENVELOPE);
+	if (!a1.isValid())
+		a1 = mr::getClosestActionAfter(channelId, -1, m::MidiEvent::ENVELOPE);
 	const m::Action a3 = a1.next != nullptr ? *a1.next : m::Action{};
 
 	assert(a1.isValid());
@@ -341,9 +346,9 @@ void updateEnvelopeAction(ID channelId, const m::Action& a, Frame f, int value)
 /* -------------------------------------------------------------------------- */
 
 
-std::vector<m::Action> getActions(ID channelId)
+std::vector<m::Action> getActions(ID channelId, int type)
 {
-	return m::recorder::getActionsOnChannel(channelId);
+	return m::recorder::getActionsInRange(channelId, 0, m::clock::getFramesInSeq(), type);
 }
 
 
@@ -43,7 +43,12 @@ class MidiChannel;
 namespace c {
 namespace actionEditor 
 {
-std::vector<m::Action> getActions(ID channelId);
+/* getActions
+Returns the actions of channel 'channelId' within the sequencer, i.e. in the 
+range [0, framesInSeq). Only actions of type 'type', or of any type if 
+'type' == 0. */
+
+std::vector<m::Action> getActions(ID channelId, int type=0);
 
 /* MIDI actions.  */
 
@@ -214,6 +214,21 @@ void setInputMonitor(ID channelId, bool value)
 /* -------------------------------------------------------------------------- */
 
 
+void setOutBus(ID channelId, int bus)
+{
+	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& c) { c.outBus = bus; });
+}
+
+
+void setInBus(ID channelId, int bus)
+{
+	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& c) { c.inBus = bus; });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void cloneChannel(ID channelId)
 {
 	m::mh::cloneChannel(channelId);
@@ -270,13 +285,13 @@ void setPan(ID channelId, float val, bool gui)
 
 void setMute(ID channelId, bool value)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch) { ch.setMute(value); });
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch) { ch.setMute(value); });
 }
 
 
 void toggleMute(ID channelId)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch) { ch.setMute(!ch.mute); });
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch) { ch.setMute(!ch.mute); });
 }
 
 
@@ -299,14 +314,14 @@ void setSampleMode(ID channelId, ChannelMode m)
 
 void setSolo(ID channelId, bool value)
 {	
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch) { ch.setSolo(value); });
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch) { ch.setSolo(value); });
 	m::mh::updateSoloCount();
 }
 
 
 void toggleSolo(ID channelId)
 {	
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch) { ch.setSolo(!ch.solo); });
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch) { ch.setSolo(!ch.solo); });
 	m::mh::updateSoloCount();
 }
 
@@ -315,7 +330,7 @@ void toggleSolo(ID channelId)
 
 void start(ID channelId, int velocity, bool record)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		if (record && !ch.recordStart(m::clock::canQuantize()))
 			return;
@@ -329,7 +344,7 @@ void start(ID channelId, int velocity, bool record)
 
 void kill(ID channelId, bool record)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		if (record && !ch.recordKill())
 			return;
@@ -343,7 +358,7 @@ void kill(ID channelId, bool record)
 
 void stop(ID channelId)
 {	
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		ch.recordStop();
 		ch.stop();
@@ -373,7 +388,7 @@ void toggleReadingActions(ID channelId)
 	handle the case of when you press 'R', the channel goes into REC_WAITING and
 	then you press 'R' again to undo the status. */
 
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		if (!ch.hasActions)
 			return;
@@ -391,7 +406,7 @@ void toggleReadingActions(ID channelId)
 
 void startReadingActions(ID channelId)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		ch.startReadingActions(m::conf::conf.treatRecsAsLoops, m::conf::conf.recsStopOnChanHalt);
 	});
@@ -403,7 +418,7 @@ void startReadingActions(ID channelId)
 
 void stopReadingActions(ID channelId)
 {
-	m::model::onSwap(m::model::channels, channelId, [&](m::Channel& ch)
+	m::model::onSwapStatus(m::model::channels, channelId, [&](m::Channel& ch)
 	{
 		ch.stopReadingActions(m::clock::isRunning(), m::conf::conf.treatRecsAsLoops, 
 			m::conf::conf.recsStopOnChanHalt);
@@ -83,6 +83,8 @@ Sets several channel properties. */
 void setArm(ID channelId, bool value);
 void toggleArm(ID channelId);
 void setInputMonitor(ID channelId, bool value);
+void setOutBus(ID channelId, int bus);
+void setInBus(ID channelId, int bus);
 void setMute(ID channelId, bool value);
 void toggleMute(ID channelId);
 void setSolo(ID channelId, bool value);
@@ -64,7 +64,24 @@ namespace main
 {
 namespace
 {
-void setBpm_(float current, std::string s)
+/* refreshBpm_
+Updates the UI after a tempo change coming from a non-UI thread. Called by 
+Fl::awake() on the main thread, so that the caller never waits for the UI lock:
+it might be the one the main thread is joining. */
+
+void refreshBpm_(void* p)
+{
+	if (G_MainWin == nullptr)
+		return;
+	u::gui::refreshActionEditor();
+	G_MainWin->mainTimer->setBpm(m::clock::getBpm());
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void setBpm_(float current, std::string s, bool gui)
 {
 	if (current < G_MIN_BPM) {
 		current = G_MIN_BPM;
@@ -76,14 +93,16 @@ void setBpm_(float current, std::string s)
 		s = G_MAX_BPM_STR;		
 	}
 
-	float previous = m::clock::getBpm();
+	Frame previous = m::clock::getFramesInLoop();
 	m::clock::setBpm(current);
-	m::recorderHandler::updateBpm(previous, current, m::clock::getQuanto());
-	m::mixer::allocVirtualInput(m::clock::getFramesInLoop());
+	m::recorderHandler::updateBpm(previous, m::clock::getFramesInLoop(), m::clock::getBeats());
 
-	/* This function might get called by Jack callback BEFORE the UI is up
-	and running, that is when G_MainWin == nullptr. */
+	/* This function might get called by the Jack transport thread BEFORE the 
+	UI is up and running, that is when G_MainWin == nullptr. */
 	
+	if (!gui)
+		Fl::awake(refreshBpm_, nullptr);
+	else
 	if (G_MainWin != nullptr) {
 		u::gui::refreshActionEditor();
 		G_MainWin->mainTimer->setBpm(s.c_str());
@@ -109,17 +128,18 @@ void setBpm(const char* v1, const char* v2)
 	/* A value such as atof("120.1") will never be 120.1 but 120.0999999, because 
 	of the rounding error. So we pass the actual "wrong" value to mixer and we show 
 	the nice looking (but fake) one to the GUI. 
-	On Linux, let Jack handle the bpm change if it's on. */
+	On Linux, let Jack handle the bpm change if it's on, unless Giada is the 
+	timebase master: the new tempo is published from the clock. */
 
 	float       f = std::atof(v1) + (std::atof(v2)/10);
 	std::string s = std::string(v1) + "." + std::string(v2);
 
 #if defined(G_OS_LINUX) || defined(G_OS_FREEBSD)
-	if (m::kernelAudio::getAPI() == G_SYS_API_JACK)
+	if (m::kernelAudio::getAPI() == G_SYS_API_JACK && !m::kernelAudio::jackIsTimebaseMaster())
 		m::kernelAudio::jackSetBpm(f);
 	else
 #endif
-	setBpm_(f, s);
+	setBpm_(f, s, /*gui=*/true);
 }
 
 
@@ -137,7 +157,7 @@ void setBpm(float f)
 	float fracpart = std::round(std::modf(f, &intpart) * 10);
 	std::string s = std::to_string((int) intpart) + "." + std::to_string((int)fracpart);
 
-	setBpm_(f, s);
+	setBpm_(f, s, /*gui=*/false);
 }
 
 
@@ -152,7 +172,6 @@ void setBeats(int beats, int bars)
 		return;
 
 	m::clock::setBeats(beats, bars);
-	m::mixer::allocVirtualInput(m::clock::getFramesInLoop());
 
 	G_MainWin->mainTimer->setMeter(m::clock::getBeats(), m::clock::getBars());
 	u::gui::refreshActionEditor();  // in case the action editor is open
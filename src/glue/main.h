@@ -39,7 +39,8 @@ Sets bpm value from string to float. */
 void setBpm(const char* v1, const char* v2);
 
 /* setBpm (2)
-Sets bpm value. Usually called from the Jack callback or non-UI components. */
+Sets bpm value. Called from the Jack transport thread or non-UI components:
+locks the UI on its own. */
 
 void setBpm(float v);
 
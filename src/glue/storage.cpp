@@ -37,6 +37,7 @@
 #include "core/recorderHandler.h"
 #include "core/pluginManager.h"
 #include "core/pluginHost.h"
+#include "core/midiDispatcher.h"
 #include "core/plugin.h"
 #include "core/conf.h"
 #include "core/patch.h"
@@ -185,12 +186,12 @@ void loadProject(void* data)
 	m::init::reset();
 	m::model::load(m::patch::patch);
 	v::model::load(m::patch::patch);
+	m::midiDispatcher::rebuild();
 
 	/* Prepare the engine. Recorder has to recompute the actions positions if 
 	the current samplerate != patch samplerate. Clock needs to update frames
 	in sequencer. */
 
-	m::mixer::allocVirtualInput(m::clock::getFramesInLoop());
 	m::mh::updateSoloCount();
 	m::recorderHandler::updateSamplerate(m::conf::conf.samplerate, m::patch::patch.samplerate);
 	m::clock::recomputeFrames();
@@ -199,6 +200,14 @@ void loadProject(void* data)
 
 	m::mixer::enable();
 
+	/* Plug-ins are created after the mixer is back online: channels start
+	playing as soon as their own plug-ins are ready. */
+
+#ifdef WITH_VST
+	m::model::loadPlugins(m::patch::patch);
+	m::midiDispatcher::rebuild();
+#endif
+
 	/* Utilities and cosmetics. Save patchPath by taking the last dir of the 
 	broswer, in order to reuse it the next time. Also update UI. */
 
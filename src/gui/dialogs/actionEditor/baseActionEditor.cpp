@@ -46,9 +46,11 @@ namespace giada {
 namespace v
 {
 gdBaseActionEditor::gdBaseActionEditor(ID channelId)
-:	gdWindow (640, 284),
-	channelId(channelId),
-	ratio    (G_DEFAULT_ZOOM_RATIO)
+:	gdWindow        (640, 284),
+	channelId       (channelId),
+	ratio           (G_DEFAULT_ZOOM_RATIO),
+	m_channelVersion(m::model::getVersion(m::model::channels, channelId)),
+	m_actionsVersion(m::model::actions.getVersion())
 {
 	using namespace giada::m;
 
@@ -85,7 +87,24 @@ void gdBaseActionEditor::cb_zoomOut(Fl_Widget* w, void* p) { ((gdBaseActionEdito
 /* -------------------------------------------------------------------------- */
 
 
-std::vector<m::Action> gdBaseActionEditor::getActions() const
+void gdBaseActionEditor::reconcile()
+{
+	std::uint64_t channelVersion = m::model::getVersion(m::model::channels, channelId);
+	std::uint64_t actionsVersion = m::model::actions.getVersion();
+
+	if (channelVersion == m_channelVersion && actionsVersion == m_actionsVersion)
+		return;
+
+	m_channelVersion = channelVersion;
+	m_actionsVersion = actionsVersion;
+	rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const std::vector<m::Action>& gdBaseActionEditor::getActions() const
 {
 	return m_actions;
 }
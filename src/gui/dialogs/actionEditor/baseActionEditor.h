@@ -29,6 +29,7 @@
 #define GD_BASE_ACTION_EDITOR_H
 
 
+#include <cstdint>
 #include "core/types.h"
 #include "gui/dialogs/window.h"
 
@@ -57,10 +58,16 @@ public:
 
 	int handle(int e) override;
 
+	/* reconcile
+	Rebuilds the editor only if its channel or the recorded actions have 
+	changed. */
+
+	void reconcile() override;
+
 	Pixel frameToPixel(Frame f) const;
 	Frame pixelToFrame(Pixel p, bool snap=true) const;
 	int getActionType() const;
-	std::vector<m::Action> getActions() const;
+	const std::vector<m::Action>& getActions() const;
 
 	geChoice*   actionType;
 	geGridTool* gridTool;
@@ -99,6 +106,15 @@ protected:
 	void centerViewportOut();
 
 	void prepareWindow();
+
+private:
+
+	/* m_[channel|actions]Version
+	Versions of the model channel and actions at the time of the last 
+	reconcile. */
+
+	std::uint64_t m_channelVersion;
+	std::uint64_t m_actionsVersion;
 };
 }} // giada::v::
 
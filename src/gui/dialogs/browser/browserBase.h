@@ -63,6 +63,11 @@ public:
 	std::string getCurrentPath() const;
 	ID getChannelId() const;
 	void fireCallback() const;
+
+	/* onSelect
+	Called by the browser when the selected item changes. */
+
+	virtual void onSelect() {};
 	
 	/* setStatusBar
 	Increments status bar for progress tracking. */
@@ -25,10 +25,19 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <FL/Fl_Group.H>
+#include "core/const.h"
+#include "core/sampleIndex.h"
+#include "core/audition.h"
 #include "utils/fs.h"
+#include "utils/string.h"
 #include "gui/elems/browser.h"
+#include "gui/elems/wavePreview.h"
 #include "gui/elems/basics/button.h"
 #include "gui/elems/basics/input.h"
+#include "gui/elems/basics/progress.h"
+#include "gui/elems/basics/check.h"
+#include "gui/elems/basics/choice.h"
 #include "browserLoad.h"
 
 
@@ -36,11 +45,49 @@ namespace giada {
 namespace v
 {
 gdBrowserLoad::gdBrowserLoad(const std::string& title, const std::string& path, 
-	std::function<void(void*)> cb, ID channelId)
-: gdBrowserBase(title, path, cb, channelId)
+	std::function<void(void*)> cb, ID channelId, bool samples)
+: gdBrowserBase(title, path, cb, channelId),
+  m_search     (nullptr),
+  m_sort       (nullptr),
+  m_audition   (nullptr),
+  m_preview    (nullptr)
 {
 	where->size(groupTop->w()-updir->w()-8, 20);
 
+	if (samples) {
+		hiddenFiles->size(130, hiddenFiles->h());
+		m_audition = new geCheck(hiddenFiles->x()+hiddenFiles->w()+8, hiddenFiles->y(), 80, 20, "Audition");
+		m_sort     = new geChoice(groupTop->x()+groupTop->w()-100, hiddenFiles->y(), 100, 20);
+		m_search   = new geInput(m_audition->x()+m_audition->w()+8, hiddenFiles->y(), 
+			m_sort->x()-m_audition->x()-m_audition->w()-16, 20);
+		groupTop->add(m_audition);
+		groupTop->add(m_search);
+		groupTop->add(m_sort);
+
+		m_audition->value(true);
+		m_audition->callback(cb_audition, (void*) this);
+
+		m_search->tooltip("Search the sample library. Filters: bpm:120 key:Am ch:2 rate:44100 dur<4 dur>1");
+		m_search->when(FL_WHEN_CHANGED);
+		m_search->callback(cb_search, (void*) this);
+
+		/* Same order of m::sampleIndex::SortBy. */
+
+		m_sort->add("By name");
+		m_sort->add("By duration");
+		m_sort->add("By bpm");
+		m_sort->add("By key");
+		m_sort->add("By loudness");
+		m_sort->value(0);
+		m_sort->callback(cb_search, (void*) this);
+
+		/* Waveform preview from the peak cache, in place of the status bar: the
+		latter is used only when loading patches. */
+
+		m_preview = new geWavePreview(status->x(), status->y(), status->w(), status->h());
+		status->parent()->add(m_preview);
+	}
+
 	browser->callback(cb_down, (void*) this);
 
 	ok->label("Load");
@@ -57,8 +104,20 @@ gdBrowserLoad::gdBrowserLoad(const std::string& title, const std::string& path,
 /* -------------------------------------------------------------------------- */
 
 
+gdBrowserLoad::~gdBrowserLoad()
+{
+	if (m_audition != nullptr)
+		m::audition::stop();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void gdBrowserLoad::cb_load(Fl_Widget* v, void* p) { ((gdBrowserLoad*)p)->cb_load(); }
 void gdBrowserLoad::cb_down(Fl_Widget* v, void* p) { ((gdBrowserLoad*)p)->cb_down(); }
+void gdBrowserLoad::cb_search(Fl_Widget* v, void* p) { ((gdBrowserLoad*)p)->cb_search(); }
+void gdBrowserLoad::cb_audition(Fl_Widget* v, void* p) { ((gdBrowserLoad*)p)->cb_audition(); }
 
 
 /* -------------------------------------------------------------------------- */
@@ -84,4 +143,91 @@ void gdBrowserLoad::cb_down()
 	where->value(browser->getCurrentDir().c_str());
 }
 
+
+/* -------------------------------------------------------------------------- */
+
+
+void gdBrowserLoad::cb_search()
+{
+	std::string query = u::string::trim(m_search->value());
+
+	if (query.empty()) {
+		browser->loadDir(where->value());
+		return;
+	}
+
+	std::vector<m::sampleIndex::Entry> entries = m::sampleIndex::search(query, 
+		static_cast<m::sampleIndex::SortBy>(m_sort->value()), G_MAX_SEARCH_RESULTS);
+
+	std::vector<std::string> paths;
+	std::vector<std::string> labels;
+	for (const m::sampleIndex::Entry& e : entries) {
+		std::string label = u::fs::basename(e.path) + "  (" + u::string::fToString(e.getDuration(), 1) + " s";
+		if (e.bpm != 0.0f)
+			label += ", " + u::string::fToString(e.bpm, 1) + " bpm";
+		if (e.key != "")
+			label += ", " + e.key;
+		paths.push_back(e.path);
+		labels.push_back(label + ")");
+	}
+
+	if (entries.empty() && m::sampleIndex::isIndexing())
+		labels.push_back("(indexing the sample library, please wait...)");
+
+	browser->showResults(paths, labels);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void gdBrowserLoad::cb_audition()
+{
+	if (m_audition->value())
+		onSelect();
+	else
+		m::audition::stop();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void gdBrowserLoad::onSelect()
+{
+	if (m_audition == nullptr)
+		return;
+
+	std::string path = browser->getSelectedItem();
+	bool        file = !path.empty() && !u::fs::isDir(path);
+
+	if (file)
+		m_preview->load(path);
+	else
+		m_preview->clear();
+
+	if (!m_audition->value())
+		return;
+	if (!file) {
+		m::audition::stop();
+		return;
+	}
+	m::audition::play(path);
+
+	/* Prefetch the files around the selection, closest first: moving the 
+	selection with arrow keys will then play them at once. */
+
+	std::vector<std::string> paths;
+	for (int i = 1; i <= G_AUDITION_PREFETCH_LINES; i++) {
+		for (int line : { browser->value() + i, browser->value() - i }) {
+			if (line <= 0)
+				continue;
+			std::string item = browser->getItem(line);
+			if (!item.empty() && !u::fs::isDir(item))
+				paths.push_back(item);
+		}
+	}
+	m::audition::prefetch(paths);
+}
+
 }} // giada::v::
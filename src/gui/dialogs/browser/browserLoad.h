@@ -32,6 +32,9 @@
 #include "browserBase.h"
 
 
+class geChoice;
+
+
 namespace giada {
 namespace m 
 { 
@@ -39,19 +42,36 @@ class Channel;
 }
 namespace v
 {
+class geWavePreview;
 class gdBrowserLoad : public gdBrowserBase
 {
 public:
 
+    /* gdBrowserLoad
+    If 'samples' is true, shows a search bar over the sample library index and
+    auditions the selected files. */
+
     gdBrowserLoad(const std::string& title, const std::string& path, 
-        std::function<void(void*)> cb, ID channelId);
+        std::function<void(void*)> cb, ID channelId, bool samples=false);
+	~gdBrowserLoad();
+
+	void onSelect() override;
 
 private:
 
 	static void cb_load(Fl_Widget* w, void* p);
 	static void cb_down(Fl_Widget* v, void* p);
+	static void cb_search(Fl_Widget* v, void* p);
+	static void cb_audition(Fl_Widget* v, void* p);
 	void cb_load();
 	void cb_down();
+	void cb_search();
+	void cb_audition();
+
+	geInput*       m_search;
+	geChoice*      m_sort;
+	geCheck*       m_audition;
+	geWavePreview* m_preview;
 };
 }} // giada::v::
 
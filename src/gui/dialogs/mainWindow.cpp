@@ -148,6 +148,17 @@ void gdMainWindow::rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void gdMainWindow::reconcile()
+{
+	keyboard->reconcile();
+	mainIO->rebuild();
+	mainTimer->rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void gdMainWindow::clearKeyboard()
 {
 	keyboard->init();
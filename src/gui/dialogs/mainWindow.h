@@ -50,6 +50,7 @@ public:
 
 	void refresh() override;
     void rebuild() override;
+	void reconcile() override;
 
 	/* clearKeyboard
 	Resets Keyboard to initial state, with no columns. */
@@ -34,6 +34,7 @@
 #include "core/model/model.h"
 #include "core/const.h"
 #include "core/conf.h"
+#include "core/midiDispatcher.h"
 #ifdef WITH_VST
 #include "core/plugin.h"
 #endif
@@ -221,6 +222,7 @@ void gdMidiInputChannel::cb_enable()
 	{
 		c.midiIn = m_enable->value();
 	});
+	m::midiDispatcher::rebuild();
 
 	m_enable->value() ? m_channel->activate() : m_channel->deactivate();
 
@@ -251,5 +253,6 @@ void gdMidiInputChannel::cb_setChannel()
 		c.midiInFilter = m_channel->value() == 0 ? -1 : m_channel->value() - 1;
 		u::log::print("[gdMidiInputChannel] Set MIDI channel to %d\n", c.midiInFilter);
 	});
+	m::midiDispatcher::rebuild();
 }
 }} // giada::v::
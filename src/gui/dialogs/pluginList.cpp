@@ -57,7 +57,8 @@ namespace v
 {
 gdPluginList::gdPluginList(ID chanID)
 : gdWindow(m::conf::conf.pluginListX, m::conf::conf.pluginListY, 468, 204), 
-  m_channelId(chanID)
+  m_channelId     (chanID),
+  m_channelVersion(0)
 {
 	end();
 
@@ -110,6 +111,8 @@ void gdPluginList::rebuild()
 	list->clear();
 	list->scroll_to(0, 0);
 
+	m_channelVersion = m::model::getVersion(m::model::channels, m_channelId);
+
 	m::model::ChannelsLock l(m::model::channels);
 
 	const m::Channel& ch = m::model::get(m::model::channels, m_channelId);
@@ -126,6 +129,16 @@ void gdPluginList::rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void gdPluginList::reconcile()
+{
+	if (m::model::getVersion(m::model::channels, m_channelId) != m_channelVersion)
+		rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void gdPluginList::cb_addPlugin()
 {
 	int wx = m::conf::conf.pluginChooserX;
@@ -32,6 +32,7 @@
 #define GD_PLUGINLIST_H
 
 
+#include <cstdint>
 #include "core/pluginHost.h"
 #include "window.h"
 
@@ -53,6 +54,11 @@ public:
 
 	void rebuild() override;
 
+	/* reconcile
+	Rebuilds the list only if the channel has changed. */
+
+	void reconcile() override;
+
 	const gePluginElement& getNextElement(const gePluginElement& curr) const;
 	const gePluginElement& getPrevElement(const gePluginElement& curr) const;
 
@@ -65,6 +71,11 @@ private:
 	geLiquidScroll* list;	
 
 	ID m_channelId;
+
+	/* m_channelVersion
+	Version of the model channel at the time of the last rebuild. */
+
+	std::uint64_t m_channelVersion;
 };
 
 }} // giada::v::
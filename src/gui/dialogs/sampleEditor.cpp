@@ -67,8 +67,10 @@ namespace v
 gdSampleEditor::gdSampleEditor(ID channelId, ID waveId)
 : gdWindow   (m::conf::conf.sampleEditorX, m::conf::conf.sampleEditorY, 
 	          m::conf::conf.sampleEditorW, m::conf::conf.sampleEditorH),
-  m_channelId(channelId),
-  m_waveId   (waveId)
+  m_channelId     (channelId),
+  m_waveId        (waveId),
+  m_channelVersion(0),
+  m_waveVersion   (0)
 {
 	Fl_Group* upperBar = createUpperBar();
 	
@@ -116,6 +118,9 @@ gdSampleEditor::~gdSampleEditor()
 
 void gdSampleEditor::rebuild()
 {
+	m_channelVersion = m::model::getVersion(m::model::channels, m_channelId);
+	m_waveVersion    = m::model::getVersion(m::model::waves, m_waveId);
+
 	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
 	{
 		copy_label(c.name.c_str());
@@ -140,6 +145,17 @@ void gdSampleEditor::rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void gdSampleEditor::reconcile()
+{
+	if (m::model::getVersion(m::model::channels, m_channelId) != m_channelVersion ||
+	    m::model::getVersion(m::model::waves, m_waveId) != m_waveVersion)
+		rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void gdSampleEditor::refresh()
 {
 	waveTools->refresh();
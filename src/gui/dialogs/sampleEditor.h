@@ -29,6 +29,7 @@
 #define GD_EDITOR_H
 
 
+#include <cstdint>
 #include "core/types.h"
 #include "window.h"
 
@@ -69,6 +70,11 @@ public:
 	void rebuild() override;
 	void refresh() override;
 
+	/* reconcile
+	Rebuilds the editor only if its channel or its wave have changed. */
+
+	void reconcile() override;
+
 	void updateInfo(const m::Wave& w);
 	void setWaveId(ID id);
 
@@ -121,6 +127,12 @@ private:
 	
 	ID m_channelId;
 	ID m_waveId;
+
+	/* m_[channel|wave]Version
+	Versions of the model channel and wave at the time of the last rebuild. */
+
+	std::uint64_t m_channelVersion;
+	std::uint64_t m_waveVersion;
 };
 }} // giada::v::
 
@@ -59,6 +59,13 @@ public:
 	virtual void rebuild() {};
 	virtual void refresh() {};
 
+	/* reconcile
+	Called by the View Updater when the model has changed. Windows that know 
+	which model data they display should override it and rebuild only when that
+	data has actually changed. Defaults to a full rebuild. */
+
+	virtual void reconcile() { rebuild(); };
+
 	/* hasWindow
 	True if the window with id 'id' exists in the stack. */
 
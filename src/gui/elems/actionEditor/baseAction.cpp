@@ -35,15 +35,18 @@ namespace v
 {
 geBaseAction::geBaseAction(Pixel X, Pixel Y, Pixel W, Pixel H, bool resizable,
 	m::Action a1, m::Action a2)
-: Fl_Box     (X, Y, W, H),
-  m_resizable(resizable),
+: m_resizable(resizable),
   onRightEdge(false),
   onLeftEdge (false),
   hovered    (false),
   altered    (false),
   pick       (0),
   a1         (a1),
-  a2         (a2)
+  a2         (a2),
+  m_x        (X),
+  m_y        (Y),
+  m_w        (W),
+  m_h        (H)
 {
 	if (w() < MIN_WIDTH)
 		size(MIN_WIDTH, h());
@@ -53,42 +56,56 @@ geBaseAction::geBaseAction(Pixel X, Pixel Y, Pixel W, Pixel H, bool resizable,
 /* -------------------------------------------------------------------------- */
 
 
-int geBaseAction::handle(int e)
+void geBaseAction::position(Pixel x, Pixel y)
 {
-	switch (e) {
-		case FL_ENTER: {
-			hovered = true;
-			redraw();
-			return 1;
-		}
-		case FL_LEAVE: {
-			fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK);
-			hovered = false;
-			redraw();
-			return 1;
-		}
-		case FL_MOVE: {
-			if (m_resizable) {
-				onLeftEdge  = false;
-				onRightEdge = false;
-				if (Fl::event_x() >= x() && Fl::event_x() < x() + HANDLE_WIDTH) {
-					onLeftEdge = true;
-					fl_cursor(FL_CURSOR_WE, FL_WHITE, FL_BLACK);
-				}
-				else
-				if (Fl::event_x() >= x() + w() - HANDLE_WIDTH && 
-					  Fl::event_x() <= x() + w()) {
-					onRightEdge = true;
-					fl_cursor(FL_CURSOR_WE, FL_WHITE, FL_BLACK);
-				}
-				else
-					fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK);
-			}
-			return 1;
-		}
-		default:
-			return Fl_Widget::handle(e);
+	m_x = x;
+	m_y = y;
+}
+
+
+void geBaseAction::size(Pixel w, Pixel h)
+{
+	m_w = w;
+	m_h = h;
+}
+
+
+void geBaseAction::resize(Pixel x, Pixel y, Pixel w, Pixel h)
+{
+	position(x, y);
+	size(w, h);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool geBaseAction::contains(Pixel px, Pixel py) const
+{
+	return px >= m_x && px < m_x + m_w && py >= m_y && py < m_y + m_h;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geBaseAction::onMove(Pixel px)
+{
+	if (!m_resizable)
+		return;
+	onLeftEdge  = false;
+	onRightEdge = false;
+	if (px >= x() && px < x() + HANDLE_WIDTH) {
+		onLeftEdge = true;
+		fl_cursor(FL_CURSOR_WE, FL_WHITE, FL_BLACK);
+	}
+	else
+	if (px >= x() + w() - HANDLE_WIDTH && px <= x() + w()) {
+		onRightEdge = true;
+		fl_cursor(FL_CURSOR_WE, FL_WHITE, FL_BLACK);
 	}
+	else
+		fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK);
 }
 
 
@@ -29,7 +29,6 @@
 #define GE_BASE_ACTION_H
 
 
-#include <FL/Fl_Box.H>
 #include "core/recorder.h"
 #include "core/types.h"
 
@@ -41,7 +40,12 @@ struct Action;
 }
 namespace v
 {
-class geBaseAction : public Fl_Box
+/* geBaseAction
+An action drawn in an action editor. Not an FLTK widget: the editor owns, draws
+and hit-tests its actions itself, so that only the visible ones cost something.
+Coordinates are absolute, like the ones of a widget. */
+
+class geBaseAction
 {
 public:
 
@@ -50,8 +54,29 @@ public:
 
 	geBaseAction(Pixel x, Pixel y, Pixel w, Pixel h, bool resizable, 
 		m::Action a1, m::Action a2);
+	virtual ~geBaseAction() = default;
+
+	virtual void draw() = 0;
+
+	Pixel x() const { return m_x; }
+	Pixel y() const { return m_y; }
+	Pixel w() const { return m_w; }
+	Pixel h() const { return m_h; }
+
+	void position(Pixel x, Pixel y);
+	void size(Pixel w, Pixel h);
+	void resize(Pixel x, Pixel y, Pixel w, Pixel h);
+
+	/* contains
+	True if point 'px', 'py' falls within the action. */
 
-	int handle(int e) override;
+	bool contains(Pixel px, Pixel py) const;
+
+	/* onMove
+	Updates edges status and mouse cursor while the mouse at 'px' hovers the 
+	action. */
+
+	void onMove(Pixel px);
 
 	bool isOnEdges() const;
 
@@ -75,6 +100,13 @@ public:
 protected:
 	
 	bool m_resizable;
+
+private:
+
+	Pixel m_x;
+	Pixel m_y;
+	Pixel m_w;
+	Pixel m_h;
 };
 }} // giada::v::
 
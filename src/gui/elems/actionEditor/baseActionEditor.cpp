@@ -25,6 +25,7 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
 #include "core/const.h"
@@ -40,8 +41,10 @@ namespace v
 {
 geBaseActionEditor::geBaseActionEditor(Pixel x, Pixel y, Pixel w, Pixel h)
 :	Fl_Group(x, y, w, h),
-	m_base  (static_cast<gdBaseActionEditor*>(window())),
-	m_action(nullptr)
+	m_base   (static_cast<gdBaseActionEditor*>(window())),
+	m_action (nullptr),
+	m_hovered(nullptr),
+	m_maxW   (0)
 {
 }
 
@@ -51,11 +54,15 @@ geBaseActionEditor::geBaseActionEditor(Pixel x, Pixel y, Pixel w, Pixel h)
 
 geBaseAction* geBaseActionEditor::getActionAtCursor() const
 {
-	for (int i=0; i<children(); i++) {
-		geBaseAction* a = static_cast<geBaseAction*>(child(i));
-		if (a->hovered)
-			return a;
-	}
+	Pixel ex = Fl::event_x();
+	Pixel ey = Fl::event_y();
+
+	/* Walk backwards: the last drawn action is the one on top. */
+
+	std::pair<size_t, size_t> r = getRange(ex, ex);
+	for (size_t i = r.second; i-- > r.first; )
+		if (m_items[i]->contains(ex, ey))
+			return m_items[i].get();
 	return nullptr;
 }
 
@@ -63,6 +70,94 @@ geBaseAction* geBaseActionEditor::getActionAtCursor() const
 /* -------------------------------------------------------------------------- */
 
 
+void geBaseActionEditor::addAction(geBaseAction* a)
+{
+	m_maxW = std::max(m_maxW, a->w());
+	m_items.emplace_back(a);
+}
+
+
+void geBaseActionEditor::clearActions()
+{
+	m_items.clear();
+	m_action  = nullptr;
+	m_hovered = nullptr;
+	m_maxW    = 0;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::pair<size_t, size_t> geBaseActionEditor::getRange(Pixel a, Pixel b) const
+{
+	auto first = std::lower_bound(m_items.begin(), m_items.end(), a - m_maxW,
+		[](const std::unique_ptr<geBaseAction>& i, Pixel p) { return i->x() < p; });
+	auto last  = std::upper_bound(first, m_items.end(), b,
+		[](Pixel p, const std::unique_ptr<geBaseAction>& i) { return p < i->x(); });
+
+	return { first - m_items.begin(), last - m_items.begin() };
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::pair<size_t, size_t> geBaseActionEditor::getVisibleRange() const
+{
+	int cx, cy, cw, ch;
+	fl_clip_box(x(), y(), w(), h(), cx, cy, cw, ch);
+
+	std::pair<size_t, size_t> r = getRange(cx, cx + cw);
+	if (r.first > 0)
+		r.first--;
+	if (r.second < m_items.size())
+		r.second++;
+	return r;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geBaseActionEditor::drawActions() const
+{
+	int cx, cy, cw, ch;
+	fl_clip_box(x(), y(), w(), h(), cx, cy, cw, ch);
+
+	std::pair<size_t, size_t> r = getRange(cx, cx + cw);
+	for (size_t i = r.first; i < r.second; i++) {
+		geBaseAction* a = m_items[i].get();
+		if (a == m_action || a->y() + a->h() < cy || a->y() > cy + ch)
+			continue;
+		a->draw();
+	}
+	
+	/* The action being dragged might be anywhere now. */
+
+	if (m_action != nullptr)
+		m_action->draw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geBaseActionEditor::resize(int X, int Y, int W, int H)
+{
+	Pixel dx = X - x();
+	Pixel dy = Y - y();
+	Fl_Group::resize(X, Y, W, H);
+	if (dx == 0 && dy == 0)
+		return;
+	for (std::unique_ptr<geBaseAction>& a : m_items)
+		a->position(a->x() + dx, a->y() + dy);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void geBaseActionEditor::baseDraw(bool clear) const
 {
 	/* Clear the screen. */
@@ -102,9 +197,19 @@ void geBaseActionEditor::baseDraw(bool clear) const
 
 void geBaseActionEditor::drawVerticals(int steps) const
 {
-	/* Start drawing from steps, not from 0. The zero-th element is always 
-	graphically useless. */
-	for (Frame i=steps; i<m::clock::getFramesInLoop(); i+=steps) {
+	/* Draw only the lines within the clip area. Start drawing from steps, not 
+	from 0. The zero-th element is always graphically useless. */
+
+	int cx, cy, cw, ch;
+	fl_clip_box(x(), y(), w(), h(), cx, cy, cw, ch);
+
+	Frame first = (m_base->pixelToFrame(cx - x(), /*snap=*/false) / steps) * steps;
+	Frame last  = m_base->pixelToFrame(cx + cw - x(), /*snap=*/false) + steps;
+
+	first = std::max<Frame>(first, steps);
+	last  = std::min<Frame>(last, m::clock::getFramesInLoop());
+
+	for (Frame i=first; i<last; i+=steps) {
 		Pixel p = m_base->frameToPixel(i) + x();
 		fl_line(p, y()+1, p, y()+h()-2);
 	}	
@@ -123,6 +228,14 @@ int geBaseActionEditor::handle(int e)
 		case FL_RELEASE:
 			fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK); // Make sure cursor returns normal
 			return release();
+		case FL_ENTER:
+			return 1;  // Enables receiving FL_MOVE events
+		case FL_MOVE:
+			return move();
+		case FL_LEAVE:
+			fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK);
+			setHovered(nullptr);
+			return 1;
 		default:
 			return Fl_Group::handle(e);
 	}
@@ -132,6 +245,37 @@ int geBaseActionEditor::handle(int e)
 /* -------------------------------------------------------------------------- */
 
 
+int geBaseActionEditor::move()
+{
+	geBaseAction* a = getActionAtCursor();
+	setHovered(a);
+	if (a != nullptr)
+		a->onMove(Fl::event_x());
+	else
+		fl_cursor(FL_CURSOR_DEFAULT, FL_WHITE, FL_BLACK);
+	return 1;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geBaseActionEditor::setHovered(geBaseAction* a)
+{
+	if (a == m_hovered)
+		return;
+	if (m_hovered != nullptr)
+		m_hovered->hovered = false;
+	if (a != nullptr)
+		a->hovered = true;
+	m_hovered = a;
+	redraw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 int geBaseActionEditor::push()
 {
 	m_action = getActionAtCursor();
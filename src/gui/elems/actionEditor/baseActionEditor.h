@@ -30,14 +30,18 @@
 #define GE_BASE_ACTION_EDITOR_H
 
 
+#include <vector>
+#include <memory>
+#include <utility>
 #include <FL/Fl_Group.H>
+#include "core/types.h"
+#include "baseAction.h"
 
 
 namespace giada {
 namespace v
 {
 class gdBaseActionEditor;
-class geBaseAction;
 
 class geBaseActionEditor : public Fl_Group
 {
@@ -55,9 +59,13 @@ public:
 	
 	int handle(int e) override;
 
+	/* resize
+	Moves the actions along with the editor, as FLTK would do with children. */
+
+	void resize(int x, int y, int w, int h) override;
+
 	/* getActionAtCursor
-	Returns the action under the mouse. nullptr if nothing found. Why not using
-	Fl::belowmouse? It would require a boring dynamic_cast. */
+	Returns the action under the mouse. nullptr if nothing found. */
 
 	geBaseAction* getActionAtCursor() const;
 
@@ -70,11 +78,36 @@ protected:
 
 	geBaseAction* m_action;
 
+	/* m_items
+	Actions in this editor, sorted by x position (i.e. by frame). They are not
+	FLTK children: only the visible ones are drawn. */
+
+	std::vector<std::unique_ptr<geBaseAction>> m_items;
+
 	/* baseDraw
 	Draws basic things like borders and grids. Optional background clear. */
 
   void baseDraw(bool clear=true) const;
 
+	/* addAction, clearActions
+	Add an action (actions must be added in frame order) and remove them all. */
+
+	void addAction(geBaseAction* a);
+	void clearActions();
+
+	/* getVisibleRange
+	Returns the indexes [first, last) of the actions within the current clip 
+	area on the x-axis, plus the one before and the one after, if any: editors 
+	that connect actions with lines need them. */
+
+	std::pair<size_t, size_t> getVisibleRange() const;
+
+	/* drawActions
+	Draws the actions within the current clip area. The one being dragged is 
+	always drawn on top. */
+
+	void drawActions() const;
+
 	virtual void onAddAction()     = 0;
 	virtual void onDeleteAction()  = 0;
 	virtual void onMoveAction()    = 0;
@@ -82,12 +115,35 @@ protected:
 	virtual void onRefreshAction() = 0;
 
 private:
+
+	/* getRange
+	Returns the indexes [first, last) of the actions that might overlap the
+	[a, b] horizontal range. */
+
+	std::pair<size_t, size_t> getRange(Pixel a, Pixel b) const;
+
+	/* m_hovered
+	Action under the mouse, if any. */
+
+	geBaseAction* m_hovered;
+
+	/* m_maxW
+	Width of the widest action: an action can start before a range and still 
+	overlap it. */
+
+	Pixel m_maxW;
 	
 	/* drawVerticals
 	Draws generic vertical lines (beats, bars, grid lines...). */
 	
 	void drawVerticals(int steps) const;
 	
+	/* setHovered
+	Highlights action 'a' (nullptr for none) under the mouse. */
+
+	void setHovered(geBaseAction* a);
+
+	int move();
 	int push();
 	int drag();
 	int release();
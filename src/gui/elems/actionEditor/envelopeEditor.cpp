@@ -73,35 +73,34 @@ void geEnvelopeEditor::draw()
 	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
 	fl_draw(label(), x()+4, y(), w(), h(), (Fl_Align) (FL_ALIGN_LEFT));
 
-	if (children() == 0)
+	if (m_items.empty())
 		return;
 
 	Pixel side = geEnvelopePoint::SIDE / 2;
 
-	Pixel x1 = child(0)->x() + side;
-	Pixel y1 = child(0)->y() + side;
-	Pixel x2 = 0;
-	Pixel y2 = 0;
-
-	/* For each point: 
-		- paint the connecting line with the next one;
+	/* For each visible point, plus the ones right outside the visible area: 
 		- reposition it on the y axis, only if there's no point selected (dragged
-	    around). */
+	    around);
+		- paint the connecting line with the previous one. */
+
+	std::pair<size_t, size_t> r = getVisibleRange();
+
+	Pixel x1 = 0;
+	Pixel y1 = 0;
 
-	for (int i=0; i<children(); i++) {
-		geEnvelopePoint* p = static_cast<geEnvelopePoint*>(child(i));
+	for (size_t i = r.first; i < r.second; i++) {
+		geBaseAction* p = m_items[i].get();
 		if (m_action == nullptr)
 			p->position(p->x(), valueToY(p->a1.event.getVelocity()));
-		if (i > 0) {
-			x2 = p->x() + side;
-			y2 = p->y() + side;
+		Pixel x2 = p->x() + side;
+		Pixel y2 = p->y() + side;
+		if (i > r.first)
 			fl_line(x1, y1, x2, y2);
-			x1 = x2;
-			y1 = y2;
-		}
+		x1 = x2;
+		y1 = y2;
 	}
 
-	draw_children();
+	drawActions();
 }
 
 
@@ -116,16 +115,11 @@ void geEnvelopeEditor::rebuild()
 	/* Remove all existing actions and set a new width, according to the current
 	zoom level. */
 
-	clear();
+	clearActions();
 	size(m_base->fullWidth, h());
 
-	for (const m::Action& a : m_base->getActions()) {
-		if (a.event.getStatus() != m::MidiEvent::ENVELOPE)
-			continue;
-		add(new geEnvelopePoint(frameToX(a.frame), valueToY(a.event.getVelocity()), a)); 		
-	}
-
-	resizable(nullptr);
+	for (const m::Action& a : ca::getActions(m_base->channelId, m::MidiEvent::ENVELOPE))
+		addAction(new geEnvelopePoint(frameToX(a.frame), valueToY(a.event.getVelocity()), a));
 
 	redraw();
 }
@@ -136,13 +130,13 @@ void geEnvelopeEditor::rebuild()
 
 bool geEnvelopeEditor::isFirstPoint() const
 {
-	return find(m_action) == 0;
+	return !m_items.empty() && m_items.front().get() == m_action;
 }
 
 
 bool geEnvelopeEditor::isLastPoint() const
 {
-	return find(m_action) == children() - 1;
+	return !m_items.empty() && m_items.back().get() == m_action;
 }
 
 
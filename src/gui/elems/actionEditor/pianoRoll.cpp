@@ -188,7 +188,7 @@ void gePianoRoll::draw()
 #endif
 
 	baseDraw(false);
-	draw_children();
+	drawActions();
 }
 
 
@@ -362,7 +362,7 @@ void gePianoRoll::rebuild()
 	/* Remove all existing actions and set a new width, according to the current
 	zoom level. */
 
-	clear();
+	clearActions();
 	size(m_base->fullWidth, (MAX_KEYS + 1) * CELL_H);
 
 	for (const m::Action& a1 : m_base->getActions())
@@ -379,7 +379,7 @@ void gePianoRoll::rebuild()
 		Pixel ph = CELL_H;
 		Pixel pw = getPianoItemW(px, a1, a2);
 
-		add(new gePianoItem(px, py, pw, ph, a1, a2));
+		addAction(new gePianoItem(px, py, pw, ph, a1, a2));
 	}
 
 	drawSurface1();
@@ -80,7 +80,7 @@ void geSampleActionEditor::rebuild()
 	/* Remove all existing actions and set a new width, according to the current
 	zoom level. */
 
-	clear();
+	clearActions();
 	size(m_base->fullWidth, h());
 	
 	for (const m::Action& a1 : m_base->getActions()) {
@@ -97,9 +97,7 @@ void geSampleActionEditor::rebuild()
 		if (a2.isValid() && isSinglePressMode)
 			pw = m_base->frameToPixel(a2.frame - a1.frame);
 
-		geSampleAction* gsa = new geSampleAction(px, py, pw, ph, isSinglePressMode, a1, a2);
-		add(gsa);
-		resizable(gsa);
+		addAction(new geSampleAction(px, py, pw, ph, isSinglePressMode, a1, a2));
 	}
 
 	/* If channel is LOOP_ANY, deactivate it: a loop mode channel cannot hold 
@@ -130,7 +128,21 @@ void geSampleActionEditor::draw()
 	else
 		fl_draw("start/stop (disabled)", x()+4, y(), w(), h(), (Fl_Align) (FL_ALIGN_LEFT | FL_ALIGN_CENTER));
 
-	draw_children();
+	drawActions();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geSampleActionEditor::resize(int X, int Y, int W, int H)
+{
+	geBaseActionEditor::resize(X, Y, W, H);
+
+	/* Actions span the whole height of the editor. */
+
+	for (std::unique_ptr<geBaseAction>& a : m_items)
+		a->resize(a->x(), y() + 4, a->w(), h() - 8);
 }
 
 
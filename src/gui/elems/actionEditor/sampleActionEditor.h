@@ -50,6 +50,7 @@ public:
 	~geSampleActionEditor();
 
 	void draw() override;
+	void resize(int x, int y, int w, int h) override;
 
 	void rebuild() override;
 
@@ -72,13 +72,14 @@ void geVelocityEditor::draw()
 	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
 	fl_draw("Velocity", x()+4, y(), w(), h(), (Fl_Align) (FL_ALIGN_LEFT));
 
-	if (children() == 0)
+	if (m_items.empty())
 		return;
 
 	Pixel side = geEnvelopePoint::SIDE / 2;
 
-	for (int i=0; i<children(); i++) {
-		geEnvelopePoint* p = static_cast<geEnvelopePoint*>(child(i));
+	std::pair<size_t, size_t> r = getVisibleRange();
+	for (size_t i = r.first; i < r.second; i++) {
+		geBaseAction* p = m_items[i].get();
 		if (m_action == nullptr)
 			p->position(p->x(), valueToY(p->a1.event.getVelocity()));
 		Pixel x1 = p->x() + side;
@@ -87,7 +88,7 @@ void geVelocityEditor::draw()
 		fl_line(x1, y1, x1, y2);
 	}
 
-	draw_children();
+	drawActions();
 }
 
 
@@ -117,7 +118,7 @@ void geVelocityEditor::rebuild()
 	/* Remove all existing actions and set a new width, according to the current
 	zoom level. */
 
-	clear();
+	clearActions();
 	size(m_base->fullWidth, h());
 
 	for (const m::Action& action : m_base->getActions())
@@ -128,10 +129,9 @@ void geVelocityEditor::rebuild()
 		Pixel px = x() + m_base->frameToPixel(action.frame);
 		Pixel py = y() + valueToY(action.event.getVelocity());
 
-		add(new geEnvelopePoint(px, py, action));
+		addAction(new geEnvelopePoint(px, py, action));
 	}
 	
-	resizable(nullptr);
 	redraw();
 }
 
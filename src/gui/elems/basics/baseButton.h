@@ -46,11 +46,13 @@ public:
 	void label(const char* l);
 	const char* label();
 
+protected:
+
+	void trimLabel();
+
 private:
 
 	std::string initLabel;
-
-	void trimLabel();
 };
 
 
@@ -59,6 +59,8 @@ void geStatusButton::draw()
 
 void geStatusButton::setStatus(bool s)
 {
+	if (s == m_status)
+		return;
     m_status = s;
     redraw();
 }
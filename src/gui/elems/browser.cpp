@@ -38,7 +38,8 @@ namespace v
 {
 geBrowser::geBrowser(int x, int y, int w, int h)
 : Fl_File_Browser  (x, y, w, h),
-  m_showHiddenFiles(false)
+  m_showHiddenFiles(false),
+  m_showResults    (false)
 {
 	box(G_CUSTOM_BORDER_BOX);
 	textsize(G_GUI_FONT_SIZE_BASE);
@@ -76,7 +77,9 @@ void geBrowser::toggleHiddenFiles()
 
 void geBrowser::loadDir(const std::string& dir)
 {
-	m_currentDir = dir;
+	m_currentDir  = dir;
+	m_showResults = false;
+	m_results.clear();
 	load(m_currentDir.c_str());
 
 	/* Clean up unwanted elements. Hide "../" first, it just screws up things.
@@ -91,6 +94,20 @@ void geBrowser::loadDir(const std::string& dir)
 }
 
 
+/* -------------------------------------------------------------------------- */
+
+
+void geBrowser::showResults(const std::vector<std::string>& paths, 
+	const std::vector<std::string>& labels)
+{
+	clear();
+	m_showResults = true;
+	m_results     = paths;
+	for (const std::string& label : labels)
+		add(label.c_str());
+}
+
+
 /* -------------------------------------------------------------------------- */
 
 int geBrowser::handle(int e)
@@ -102,11 +119,15 @@ int geBrowser::handle(int e)
 			ret = 1;                	// enables receiving Keyboard events
 			break;
 		case FL_KEYDOWN:  // keyboard
-			if (Fl::event_key(FL_Down))
+			if (Fl::event_key(FL_Down)) {
 				select(value() + 1);
+				static_cast<v::gdBrowserBase*>(parent())->onSelect();
+			}
 			else
-			if (Fl::event_key(FL_Up))
+			if (Fl::event_key(FL_Up)) {
 				select(value() - 1);
+				static_cast<v::gdBrowserBase*>(parent())->onSelect();
+			}
 			else
 			if (Fl::event_key(FL_Enter))
 				static_cast<v::gdBrowserBase*>(parent())->fireCallback();
@@ -127,6 +148,7 @@ int geBrowser::handle(int e)
 				select(value() + 1);
 				select(value() - 1);
 			}
+			static_cast<v::gdBrowserBase*>(parent())->onSelect();
 			ret = 1;
 			break;
 	}
@@ -147,10 +169,26 @@ std::string geBrowser::getCurrentDir()
 
 std::string geBrowser::getSelectedItem(bool fullPath)
 {
+	return getItem(value(), fullPath);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+std::string geBrowser::getItem(int line, bool fullPath)
+{
+	if (m_showResults) {
+		if (line <= 0 || static_cast<size_t>(line) > m_results.size()) // Informative label
+			return "";
+		return fullPath ? m_results[line - 1] : text(line);
+	}
+	if (line > size())
+		return "";
 	if (!fullPath)     // no full path requested? return the selected text
-		return normalize(text(value()));
+		return normalize(text(line));
 	else
-	if (value() == 0)  // no rows selected? return current directory
+	if (line <= 0)     // no rows selected? return current directory
 		return normalize(m_currentDir);
 	else {
 #ifdef G_OS_WINDOWS
@@ -158,7 +196,7 @@ std::string geBrowser::getSelectedItem(bool fullPath)
 #else
 		std::string sep = G_SLASH_STR;
 #endif
-		return normalize(u::string::getRealPath(m_currentDir + sep + normalize(text(value()))));
+		return normalize(u::string::getRealPath(m_currentDir + sep + normalize(text(line))));
 	}
 }
 
@@ -32,6 +32,7 @@
 
 
 #include <string>
+#include <vector>
 #include <FL/Fl_File_Browser.H>
 
 
@@ -51,12 +52,25 @@ public:
 
 	void loadDir(const std::string& dir);
 
+	/* showResults
+	Replaces the directory content with a list of files, e.g. the result of a 
+	search. 'labels' are displayed, 'paths' returned by getSelectedItem(). Any
+	label past the end of 'paths' is informative only. */
+
+	void showResults(const std::vector<std::string>& paths, 
+		const std::vector<std::string>& labels);
+
 	/* getSelectedItem
 	Returns the full path or just the displayed name of the i-th selected item.
 	Always with the trailing slash! */
 
 	std::string getSelectedItem(bool fullPath=true);
 
+	/* getItem
+	Like getSelectedItem(), for the item at 'line'. */
+
+	std::string getItem(int line, bool fullPath=true);
+
 	std::string getCurrentDir();
 
 	void preselect(int position, int line);
@@ -72,6 +86,13 @@ private:
 
 	std::string m_currentDir;
 	bool m_showHiddenFiles;
+
+	/* m_showResults, m_results
+	Whether the browser is showing a list of files from showResults() instead
+	of a directory, and their full paths. */
+
+	bool                     m_showResults;
+	std::vector<std::string> m_results;
 };
 }} // giada::v::
 
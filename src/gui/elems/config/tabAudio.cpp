@@ -26,10 +26,12 @@
 
 
 #include <string>
+#include <algorithm>
 #include "deps/rtaudio/RtAudio.h"
 #include "core/const.h"
 #include "core/conf.h"
 #include "core/kernelAudio.h"
+#include "utils/math.h"
 #include "utils/string.h"
 #include "gui/dialogs/devInfo.h"
 #include "gui/elems/basics/box.h"
@@ -59,7 +61,11 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	channelsIn      = new geChoice(x()+114, y()+149, 55,  20, "Input channels");
 	recTriggerLevel = new geInput (x()+309, y()+149, 55,  20, "Rec threshold (dB)");
 	rsmpQuality     = new geChoice(x()+114, y()+177, 250, 20, "Resampling");
-                      new geBox(x(), rsmpQuality->y()+rsmpQuality->h()+8, w(), 92, "Restart Giada for the changes to take effect.");
+	busesOut        = new geChoice(x()+114, y()+205, 55,  20, "Output buses");
+	busesIn         = new geChoice(x()+309, y()+205, 55,  20, "Input buses");
+	recTriggerPreRoll = new geInput(x()+114, y()+233, 55,  20, "Rec pre-roll (ms)");
+	jackTimebaseMaster = new geCheck(x()+114, y()+261, 55, 20, "Jack timebase master");
+                      new geBox(x(), jackTimebaseMaster->y()+jackTimebaseMaster->h()+8, w(), 24, "Restart Giada for the changes to take effect.");
 	end();
 
 	labelsize(G_GUI_FONT_SIZE_BASE);
@@ -210,8 +216,23 @@ geTabAudio::geTabAudio(int X, int Y, int W, int H)
 	rsmpQuality->value(m::conf::conf.rsmpQuality);
 
 	recTriggerLevel->value(u::string::fToString(m::conf::conf.recTriggerLevel, 1).c_str());
+	recTriggerPreRoll->value(u::string::iToString(m::conf::conf.recTriggerPreRoll).c_str());
 
 	limitOutput->value(m::conf::conf.limitOutput);
+
+	/* Buses are consecutive stereo pairs, starting from the output (or input) 
+	channels selected above. */
+
+	for (int i=1; i<=G_MAX_IO_BUSES; i++) {
+		busesOut->add(u::string::iToString(i).c_str());
+		busesIn->add(u::string::iToString(i).c_str());
+	}
+	busesOut->value(std::max(1, std::min(m::conf::conf.busesOut, G_MAX_IO_BUSES)) - 1);
+	busesIn->value(std::max(1, std::min(m::conf::conf.busesIn, G_MAX_IO_BUSES)) - 1);
+
+	jackTimebaseMaster->value(m::conf::conf.jackTimebaseMaster);
+	if (m::conf::conf.soundSystem != G_SYS_API_JACK)
+		jackTimebaseMaster->deactivate();
 }
 
 
@@ -321,13 +342,17 @@ void geTabAudio::fetchInChans(int menuItem)
 	if (menuItem == 0) {
 		devInInfo->deactivate();
 		channelsIn->deactivate();
+		busesIn->deactivate();
 		recTriggerLevel->deactivate();
+		recTriggerPreRoll->deactivate();
 		return;
 	}
 
 	devInInfo->activate();
 	channelsIn->activate();
+	busesIn->activate();
 	recTriggerLevel->activate();
+	recTriggerPreRoll->activate();
 
 	channelsIn->clear();
 
@@ -509,8 +534,11 @@ void geTabAudio::save()
 	m::conf::conf.soundDeviceIn  = m::kernelAudio::getDeviceByName(sounddevIn->text(sounddevIn->value()));
 	m::conf::conf.channelsOut    = channelsOut->value();
 	m::conf::conf.channelsIn     = channelsIn->value();
+	m::conf::conf.busesOut       = busesOut->value() + 1;
+	m::conf::conf.busesIn        = busesIn->value() + 1;
 	m::conf::conf.limitOutput    = limitOutput->value();
 	m::conf::conf.rsmpQuality    = rsmpQuality->value();
+	m::conf::conf.jackTimebaseMaster = jackTimebaseMaster->value();
 
 	/* if sounddevOut is disabled (because of system change e.g. alsa ->
 	 * jack) its value is equal to -1. Change it! */
@@ -520,6 +548,8 @@ void geTabAudio::save()
 
 	m::conf::conf.buffersize = std::atoi(buffersize->text());
 	m::conf::conf.recTriggerLevel = std::atof(recTriggerLevel->value());
+	m::conf::conf.recTriggerPreRoll = u::math::bound(std::atoi(recTriggerPreRoll->value()), 
+		0, G_INPUT_REC_MAX_PRE_ROLL_MS);
 
 	const Fl_Menu_Item* i = nullptr;
 	i = samplerate->mvalue(); // mvalue() returns a pointer to the last menu item that was picked
@@ -60,7 +60,11 @@ public:
 	geButton* devInInfo;
 	geChoice* channelsIn;
 	geInput*  recTriggerLevel;
+	geInput*  recTriggerPreRoll;
 	geChoice* rsmpQuality;
+	geChoice* busesOut;
+	geChoice* busesIn;
+	geCheck*  jackTimebaseMaster;
 
 private:
 
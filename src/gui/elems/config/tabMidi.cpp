@@ -35,6 +35,7 @@
 #include "core/conf.h"
 #include "core/midiMapConf.h"
 #include "core/kernelMidi.h"
+#include "core/midiSync.h"
 #include "utils/gui.h"
 #include "gui/elems/basics/box.h"
 #include "gui/elems/basics/choice.h"
@@ -70,12 +71,18 @@ geTabMidi::geTabMidi(int X, int Y, int W, int H)
 	sync->add("(disabled)");
 	sync->add("MIDI Clock (master)");
 	sync->add("MTC (master)");
+	sync->add("MIDI Clock (slave)");
+	sync->add("MTC (slave)");
 	if      (m::conf::conf.midiSync == MIDI_SYNC_NONE)
 		sync->value(0);
 	else if (m::conf::conf.midiSync == MIDI_SYNC_CLOCK_M)
 		sync->value(1);
 	else if (m::conf::conf.midiSync == MIDI_SYNC_MTC_M)
 		sync->value(2);
+	else if (m::conf::conf.midiSync == MIDI_SYNC_CLOCK_S)
+		sync->value(3);
+	else if (m::conf::conf.midiSync == MIDI_SYNC_MTC_S)
+		sync->value(4);
 
 	systemInitValue = system->value();
 }
@@ -170,12 +177,18 @@ void geTabMidi::save()
 	m::conf::conf.midiPortIn  = portIn->value()-1;    // -1 because midiPortIn=-1 is '(disabled)'
 	m::conf::conf.midiMapPath = m::midimap::maps.size() == 0 ? "" : midiMap->text(midiMap->value());
 
+	/* The sync mode takes effect right away, no restart needed. */
+
 	if      (sync->value() == 0)
-		m::conf::conf.midiSync = MIDI_SYNC_NONE;
+		m::midiSync::setMode(MIDI_SYNC_NONE);
 	else if (sync->value() == 1)
-		m::conf::conf.midiSync = MIDI_SYNC_CLOCK_M;
+		m::midiSync::setMode(MIDI_SYNC_CLOCK_M);
 	else if (sync->value() == 2)
-		m::conf::conf.midiSync = MIDI_SYNC_MTC_M;
+		m::midiSync::setMode(MIDI_SYNC_MTC_M);
+	else if (sync->value() == 3)
+		m::midiSync::setMode(MIDI_SYNC_CLOCK_S);
+	else if (sync->value() == 4)
+		m::midiSync::setMode(MIDI_SYNC_MTC_S);
 }
 
 
@@ -27,7 +27,9 @@
 
 #include "core/const.h"
 #include "core/conf.h"
+#include "core/sampleIndex.h"
 #include "gui/elems/basics/choice.h"
+#include "gui/elems/basics/input.h"
 #include "tabMisc.h"
 
 
@@ -38,9 +40,13 @@ geTabMisc::geTabMisc(int X, int Y, int W, int H)
 : Fl_Group(X, Y, W, H, "Misc")
 {
 	begin();
-	debugMsg = new geChoice(x()+w()-230, y()+9, 230, 20, "Debug messages");
+	debugMsg          = new geChoice(x()+w()-230, y()+9, 230, 20, "Debug messages");
+	sampleLibraryPath = new geInput(x()+w()-230, debugMsg->y()+debugMsg->h()+8, 230, 20, "Sample library");
 	end();
 
+	sampleLibraryPath->value(m::conf::conf.sampleLibraryPath.c_str());
+	sampleLibraryPath->tooltip("Folders indexed for the search in the file browser, separated by ';'");
+
 	debugMsg->add("(disabled)");
 	debugMsg->add("To standard output");
 	debugMsg->add("To file");
@@ -78,5 +84,10 @@ void geTabMisc::save()
 			m::conf::conf.logMode = LOG_MODE_FILE;
 			break;
 	}
+
+	if (m::conf::conf.sampleLibraryPath != sampleLibraryPath->value()) {
+		m::conf::conf.sampleLibraryPath = sampleLibraryPath->value();
+		m::sampleIndex::start(m::conf::conf.sampleLibraryPath);
+	}
 }
 }} // giada::v::
\ No newline at end of file
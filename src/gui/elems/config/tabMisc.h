@@ -33,6 +33,7 @@
 
 
 class geChoice;
+class geInput;
 
 
 namespace giada {
@@ -47,6 +48,7 @@ public:
 	void save();
 
 	geChoice* debugMsg;
+	geInput*  sampleLibraryPath;
 };
 }} // giada::v::
 
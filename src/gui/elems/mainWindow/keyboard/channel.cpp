@@ -29,10 +29,12 @@
 #include <FL/fl_draw.H>
 #include "core/channels/channel.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/const.h"
 #include "core/graphics.h"
 #include "core/pluginHost.h"
 #include "utils/gui.h"
+#include "utils/string.h"
 #include "glue/channel.h"
 #include "gui/dialogs/mainWindow.h"
 #include "gui/dialogs/pluginList.h"
@@ -53,7 +55,8 @@ namespace v
 {
 geChannel::geChannel(int X, int Y, int W, int H, ID channelId)
 : Fl_Group (X, Y, W, H),
-  channelId(channelId)
+  channelId(channelId),
+  m_version(0)
 {
 }
 
@@ -63,6 +66,14 @@ geChannel::geChannel(int X, int Y, int W, int H, ID channelId)
 
 void geChannel::draw()
 {
+	/* Only some children changed: let them redraw themselves on top of the
+	background already there. */
+
+	if (damage() == FL_DAMAGE_CHILD) {
+		Fl_Group::draw();
+		return;
+	}
+
 	const int ny = y() + (h() / 2) - (G_GUI_UNIT / 2);
 
 	playButton->resize(playButton->x(), ny, G_GUI_UNIT, G_GUI_UNIT);
@@ -97,16 +108,48 @@ void geChannel::cb_openFxWindow(Fl_Widget* v, void* p) { ((geChannel*)p)->cb_ope
 
 void geChannel::refresh()
 {
+	const m::telemetry::Channel* c = m::telemetry::getChannel(channelId);
+	if (c == nullptr)
+		return;
+
+	if (mainButton->visible())
+		mainButton->refresh();
+	if (c->recStatus == ChannelStatus::WAIT || c->playStatus == ChannelStatus::WAIT)
+		blink();
+	playButton->setStatus(c->playStatus == ChannelStatus::PLAY || c->playStatus == ChannelStatus::ENDING);
+	mute->setStatus(c->mute);
+	solo->setStatus(c->solo);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannel::rebuild()
+{
+	m_version = m::model::getVersion(m::model::channels, channelId);
+
 	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 	{
-		if (mainButton->visible())
-			mainButton->refresh();
-		if (c.recStatus == ChannelStatus::WAIT || c.playStatus == ChannelStatus::WAIT)
-			blink();
-		playButton->setStatus(c.isPlaying());
-		mute->setStatus(c.mute);
-		solo->setStatus(c.solo);
+		arm->value(c.armed);
+		vol->value(c.volume);
+		mainButton->setKey(c.key);
+#ifdef WITH_VST
+		fx->setStatus(c.pluginIds.size() > 0);
+#endif
 	});
+
+	mainButton->rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannel::reconcile()
+{
+	if (m::model::getVersion(m::model::channels, channelId) != m_version)
+		rebuild();
 }
 
 
@@ -176,6 +219,7 @@ void geChannel::blink()
 		mainButton->setPlayMode();
 	else
 		mainButton->setDefaultMode();
+	mainButton->redrawIfChanged();
 }
 
 
@@ -237,4 +281,26 @@ bool geChannel::handleKey(int e)
 	
 	return false;
 }
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannel::addBusMenu(std::vector<Fl_Menu_Item>& menu, Fl_Callback* cb, 
+	int first, int count, int selected)
+{
+	static std::vector<std::string> labels;
+	if (labels.empty())
+		for (int i=0; i<G_MAX_IO_BUSES; i++)
+			labels.push_back("Bus " + u::string::iToString(i + 1));
+
+	for (int i=0; i<G_MAX_IO_BUSES; i++) {
+		int flags = FL_MENU_RADIO;
+		if (i == selected) flags |= FL_MENU_VALUE;
+		if (i >= count)    flags |= FL_MENU_INACTIVE;
+		menu.push_back({ labels[i].c_str(), 0, cb, (void*) (intptr_t) (first + i), flags });
+	}
+	menu.push_back({ 0 });
+}
+
 }} // giada::v::
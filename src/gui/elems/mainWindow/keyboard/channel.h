@@ -29,7 +29,10 @@
 #define GE_CHANNEL_H
 
 
+#include <cstdint>
+#include <vector>
 #include <FL/Fl_Group.H>
+#include <FL/Fl_Menu_Item.H>
 #include "core/types.h"
 
 
@@ -61,6 +64,18 @@ public:
 
 	virtual void refresh();
 
+	/* rebuild
+	Reads again from the model those attributes that are not updated by 
+	refresh(), e.g. arm, volume, key and label. */
+
+	virtual void rebuild();
+
+	/* reconcile
+	Rebuilds the channel only if it has changed in the model since the last 
+	rebuild. */
+
+	void reconcile();
+
 	/* getColumnId
 	Returns the ID of the column this channel resides in. */
 
@@ -127,6 +142,19 @@ protected:
 	Spread widgets across available space. */
 
 	void packWidgets();
+
+	/* addBusMenu
+	Appends the items of a bus submenu to 'menu', terminator included: one radio
+	item per bus, up to G_MAX_IO_BUSES. Item i carries 'first' + i as user data.
+	Buses beyond 'count', i.e. not opened on the audio device, are greyed out. */
+
+	static void addBusMenu(std::vector<Fl_Menu_Item>& menu, Fl_Callback* cb, 
+		int first, int count, int selected);
+
+	/* m_version
+	Version of the model channel at the time of the last rebuild. */
+
+	std::uint64_t m_version;
 };
 }} // giada::v::
 
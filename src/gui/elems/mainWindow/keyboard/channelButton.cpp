@@ -25,12 +25,15 @@
  * -------------------------------------------------------------------------- */
 
 
+#include <algorithm>
 #include <FL/fl_draw.H>
 #include "core/channels/channel.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/const.h"
 #include "core/recorder.h"
 #include "utils/string.h"
+#include "utils/math.h"
 #include "channelButton.h"
 
 
@@ -40,7 +43,12 @@ namespace v
 geChannelButton::geChannelButton(int x, int y, int w, int h, ID channelId)
 : geButton   (x, y, w, h), 
   m_channelId(channelId),
-  m_key      ("")
+  m_key      (""),
+  m_dbPeak   (-G_MIN_DB_SCALE),
+  m_dbRms    (-G_MIN_DB_SCALE),
+  m_clip     (false),
+  m_trimmedW (-1),
+  m_face     (0)
 {
 }
 
@@ -48,27 +56,75 @@ geChannelButton::geChannelButton(int x, int y, int w, int h, ID channelId)
 /* -------------------------------------------------------------------------- */
 
 
+geChannelButton::~geChannelButton()
+{
+	if (m_face != 0)
+		fl_delete_offscreen(m_face);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+bool geChannelButton::Look::hasSameFace(const Look& o) const
+{
+	return bgColor == o.bgColor && bdColor == o.bdColor && txtColor == o.txtColor &&
+	       label == o.label && key == o.key && w == o.w && h == o.h;
+}
+
+
+bool geChannelButton::Look::operator ==(const Look& o) const
+{
+	return hasSameFace(o) && pxRms == o.pxRms && pxPeak == o.pxPeak && clip == o.clip;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void geChannelButton::refresh()
 {
-	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
-	{
-		switch (c.playStatus) {
-			case ChannelStatus::OFF:
-			case ChannelStatus::EMPTY:
-				setDefaultMode(); break;
-			case ChannelStatus::PLAY:
-				setPlayMode(); break;
-			case ChannelStatus::ENDING:
-				setEndingMode(); break;
-			default: break;
-		}
+	const m::telemetry::Channel* c = m::telemetry::getChannel(m_channelId);
+	if (c == nullptr)
+		return;
 
-		switch (c.recStatus) {
-			case ChannelStatus::ENDING:
-				setEndingMode(); break;
-			default: break;
-		}
-	});
+	switch (c->playStatus) {
+		case ChannelStatus::OFF:
+		case ChannelStatus::EMPTY:
+			setDefaultMode(); break;
+		case ChannelStatus::PLAY:
+			setPlayMode(); break;
+		case ChannelStatus::ENDING:
+			setEndingMode(); break;
+		default: break;
+	}
+
+	switch (c->recStatus) {
+		case ChannelStatus::ENDING:
+			setEndingMode(); break;
+		default: break;
+	}
+
+	/* dBFS levels, with a decay of -2dB per frame on the peak as in the main
+	sound meters. */
+
+	float dbPeak = std::max(u::math::linearToDB(c->peak), -G_MIN_DB_SCALE);
+	if (dbPeak < m_dbPeak)
+		dbPeak = std::max(m_dbPeak - 2.0f, -G_MIN_DB_SCALE);
+
+	m_dbPeak = dbPeak;
+	m_dbRms  = std::max(u::math::linearToDB(c->rms), -G_MIN_DB_SCALE);
+	m_clip   = c->peak >= 1.0f || c->stackPeak >= 1.0f;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannelButton::redrawIfChanged()
+{
+	if (!(getLook() == m_drawn))
+		redraw();
 }
 
 
@@ -85,22 +141,116 @@ void geChannelButton::setKey(int k)
 /* -------------------------------------------------------------------------- */
 
 
+geChannelButton::Look geChannelButton::getLook()
+{
+	Look l;
+	l.bgColor  = active() && value() ? bgColor1 : bgColor0;
+	l.bdColor  = bdColor;
+	l.txtColor = active() ? txtColor : bdColor;
+	l.label    = getTrimmedLabel();
+	l.key      = m_key;
+	l.w        = w();
+	l.h        = h();
+	l.clip     = m_clip;
+
+	if (m_dbPeak > -G_MIN_DB_SCALE) {
+		int width = w() - 2;
+		l.pxRms   = (width / G_MIN_DB_SCALE) * (m_dbRms + G_MIN_DB_SCALE);
+		l.pxPeak  = std::min<int>((width / G_MIN_DB_SCALE) * (m_dbPeak + G_MIN_DB_SCALE), width - 1);
+	}
+	return l;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+const std::string& geChannelButton::getTrimmedLabel()
+{
+	const char* l = label() != nullptr ? label() : "";
+
+	if (w() == m_trimmedW && m_fullLabel == l)
+		return m_trimmedLabel;
+
+	m_fullLabel    = l;
+	m_trimmedW     = w();
+	m_trimmedLabel = "";
+
+	if (w() <= 20)
+		return m_trimmedLabel;
+
+	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
+
+	m_trimmedLabel = m_fullLabel;
+	int len = m_fullLabel.size();
+	while (len > 0 && fl_width(m_trimmedLabel.c_str(), m_trimmedLabel.size()) > w())
+		m_trimmedLabel = m_fullLabel.substr(0, --len) + "...";
+
+	return m_trimmedLabel;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void geChannelButton::draw()
 {
-	geButton::draw();
+	Look l = getLook();
+
+	if (m_face == 0 || !l.hasSameFace(m_drawn))
+		drawFace(l);
+	fl_copy_offscreen(x(), y(), w(), h(), m_face, 0, 0);
+
+	m_drawn = l;
+	drawLevels();
+}
 
-	if (m_key == "")
-		return;
 
-	/* draw background */
+/* -------------------------------------------------------------------------- */
+
 
-	fl_rectf(x()+1, y()+1, 18, h()-2, bgColor0);
+void geChannelButton::drawFace(const Look& l)
+{
+	if (m_face != 0 && (l.w != m_drawn.w || l.h != m_drawn.h)) {
+		fl_delete_offscreen(m_face);
+		m_face = 0;
+	}
+	if (m_face == 0)
+		m_face = fl_create_offscreen(l.w, l.h);
+
+	fl_begin_offscreen(m_face);
+
+	/* Coordinates are relative to the offscreen surface, not to the window. */
+
+	fl_rect(0, 0, l.w, l.h, l.bdColor);
+	fl_rectf(1, 1, l.w-2, l.h-2, l.bgColor);
+	fl_color(l.txtColor);
+	fl_font(FL_HELVETICA, G_GUI_FONT_SIZE_BASE);
+	fl_draw(l.label.c_str(), 2, 0, l.w-2, l.h, FL_ALIGN_CENTER);
+
+	if (l.key != "") {
+		fl_rectf(1, 1, 18, l.h-2, bgColor0);
+		fl_color(G_COLOR_LIGHT_2);
+		fl_font(FL_HELVETICA, 11);
+		fl_draw(l.key.c_str(), 0, 0, 18, l.h, FL_ALIGN_CENTER);
+	}
+
+	fl_end_offscreen();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannelButton::drawLevels()
+{
+	if (m_drawn.pxPeak == -1)
+		return;
 
-	/* draw m_key */
+	Fl_Color color = m_drawn.clip ? G_COLOR_RED_ALERT : G_COLOR_GREY_4;
 
-	fl_color(G_COLOR_LIGHT_2);
-	fl_font(FL_HELVETICA, 11);
-	fl_draw(m_key.c_str(), x(), y(), 18, h(), FL_ALIGN_CENTER);
+	fl_rectf(x()+1, y()+h()-3, m_drawn.pxRms, 2, color);
+	fl_rectf(x()+1 + m_drawn.pxPeak, y()+h()-3, 1, 2, color);
 }
 
 
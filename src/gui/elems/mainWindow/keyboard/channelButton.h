@@ -29,6 +29,9 @@
 #define GE_CHANNEL_BUTTON_H
 
 
+#include <string>
+#include <FL/Fl_Widget.H>
+#include <FL/x.H>
 #include "gui/elems/basics/button.h"
 
 
@@ -44,9 +47,25 @@ class geChannelButton : public geButton
 public:
 
 	geChannelButton(int x, int y, int w, int h, ID channelId);
+	~geChannelButton();
+
+	/* refresh
+	Updates status and levels from the telemetry. Doesn't redraw: call 
+	redrawIfChanged() when done. */
 
 	virtual void refresh();
 
+	/* redrawIfChanged
+	Schedules a redraw only if the button would look different from the last 
+	time it was drawn. */
+
+	void redrawIfChanged();
+
+	/* rebuild
+	Updates the label from the model. */
+
+	virtual void rebuild() {};
+
 	void draw() override;
   
 	void setKey(int k);
@@ -58,8 +77,62 @@ public:
 
 protected:
 
+	/* drawLevels
+	Paints a thin level meter along the bottom edge: RMS as a bar, peak as a 
+	marker. Turns red if the channel or its plug-in stack clip. */
+
+	void drawLevels();
+
 	ID          m_channelId;
 	std::string m_key;
+
+private:
+
+	/* Look
+	What the button shows. Face is the static part (colors, label, key) cached
+	in the offscreen surface, levels are painted on top of it. */
+
+	struct Look
+	{
+		Fl_Color    bgColor  = 0;
+		Fl_Color    bdColor  = 0;
+		Fl_Color    txtColor = 0;
+		std::string label;
+		std::string key;
+		int         w        = -1;
+		int         h        = -1;
+		int         pxRms    = -1;
+		int         pxPeak   = -1;
+		bool        clip     = false;
+
+		bool hasSameFace(const Look& o) const;
+		bool operator ==(const Look& o) const;
+	};
+
+	Look getLook();
+
+	/* getTrimmedLabel
+	Returns the label shortened to fit the button. Measuring text is expensive:
+	the result is cached and computed again only when the label changes (i.e. 
+	on rebuild) or the button is resized. */
+
+	const std::string& getTrimmedLabel();
+
+	/* drawFace
+	Paints the static part of the button into the offscreen surface m_face. */
+
+	void drawFace(const Look& l);
+
+	float m_dbPeak;
+	float m_dbRms;
+	bool  m_clip;
+
+	std::string m_fullLabel;
+	std::string m_trimmedLabel;
+	int         m_trimmedW;
+
+	Fl_Offscreen m_face;
+	Look         m_drawn;
 };
 }} // giada::v::
 
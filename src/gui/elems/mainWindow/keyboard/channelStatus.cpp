@@ -26,11 +26,7 @@
 
 
 #include <FL/fl_draw.H>
-#include "core/channels/sampleChannel.h"
-#include "core/model/model.h"
-#include "core/mixer.h"
-#include "core/clock.h"
-#include "core/recorder.h"
+#include "core/telemetry.h"
 #include "core/recManager.h"
 #include "core/const.h"
 #include "channelStatus.h"
@@ -48,43 +44,71 @@ geChannelStatus::geChannelStatus(int x, int y, int w, int h, ID channelId)
 /* -------------------------------------------------------------------------- */
 
 
-void geChannelStatus::draw()
+bool geChannelStatus::Look::operator ==(const Look& o) const
+{
+	return border == o.border && fill == o.fill && pos == o.pos;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+geChannelStatus::Look geChannelStatus::getLook() const
 {
-	fl_rect(x(), y(), w(), h(), G_COLOR_GREY_4);              // reset border
-	fl_rectf(x()+1, y()+1, w()-2, h()-2, G_COLOR_GREY_2);     // reset background
+	Look l;
+	l.border = G_COLOR_GREY_4;
+	l.fill   = G_COLOR_GREY_2;
+	l.pos    = 0;
 
-	m::model::ChannelsLock l(m::model::channels);
-	const m::SampleChannel& ch = static_cast<m::SampleChannel&>(m::model::get(m::model::channels, channelId));
+	const m::telemetry::Channel* ch = m::telemetry::getChannel(channelId);
+	if (ch == nullptr)
+		return l;
 	
-	if (ch.playStatus == ChannelStatus::WAIT    || 
-	    ch.playStatus == ChannelStatus::ENDING  ||
-	    ch.recStatus == ChannelStatus::WAIT || 
-	    ch.recStatus == ChannelStatus::ENDING)
+	if (ch->playStatus == ChannelStatus::WAIT    || 
+	    ch->playStatus == ChannelStatus::ENDING  ||
+	    ch->playStatus == ChannelStatus::PLAY    ||
+	    ch->recStatus == ChannelStatus::WAIT || 
+	    ch->recStatus == ChannelStatus::ENDING)
 	{
-		fl_rect(x(), y(), w(), h(), G_COLOR_LIGHT_1);
+		l.border = G_COLOR_LIGHT_1;
 	}
-	else
-	if (ch.playStatus == ChannelStatus::PLAY)
-		fl_rect(x(), y(), w(), h(), G_COLOR_LIGHT_1);
-	else
-		fl_rectf(x()+1, y()+1, w()-2, h()-2, G_COLOR_GREY_2);  // status empty
 
-
-	if (m::recManager::isRecordingInput() && ch.armed)
-		fl_rectf(x()+1, y()+1, w()-2, h()-2, G_COLOR_RED);     // take in progress
+	if (m::recManager::isRecordingInput() && ch->armed)
+		l.fill = G_COLOR_RED;     // take in progress
 	else
 	if (m::recManager::isRecordingAction())
-		fl_rectf(x()+1, y()+1, w()-2, h()-2, G_COLOR_BLUE);    // action recording
+		l.fill = G_COLOR_BLUE;    // action recording
 
 	/* Equation for the progress bar: 
 	((chanTracker - chanStart) * w()) / (chanEnd - chanStart). */
 
-	int pos = ch.getPosition();
-	if (pos == -1)
-		pos = 0;
-	else
-		pos = (pos * (w()-1)) / ((ch.getEnd() - ch.getBegin()));
-	fl_rectf(x()+1, y()+1, pos, h()-2, G_COLOR_LIGHT_1);
+	if (ch->position != -1 && ch->length != 0)
+		l.pos = (ch->position * (w()-1)) / ch->length;
+
+	return l;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannelStatus::refresh()
+{
+	if (!(getLook() == m_drawn))
+		redraw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geChannelStatus::draw()
+{
+	m_drawn = getLook();
+
+	fl_rect(x(), y(), w(), h(), m_drawn.border);
+	fl_rectf(x()+1, y()+1, w()-2, h()-2, m_drawn.fill);
+	fl_rectf(x()+1, y()+1, m_drawn.pos, h()-2, G_COLOR_LIGHT_1);
 }
 
 }} // giada::v::
@@ -49,7 +49,30 @@ public:
 
 	void draw() override;
 
+	/* refresh
+	Redraws the widget only if the telemetry changed what it shows. */
+
+	void refresh();
+
 	ID channelId;
+
+private:
+
+	/* Look
+	What the widget shows: border and fill colors, progress bar width. */
+
+	struct Look
+	{
+		Fl_Color border = 0;
+		Fl_Color fill   = 0;
+		int      pos    = -1;
+
+		bool operator ==(const Look& o) const;
+	};
+
+	Look getLook() const;
+
+	Look m_drawn;
 };
 }} // giada::v::
 
@@ -102,6 +102,8 @@ void geKeyboard::rebuild()
 	for (ColumnLayout c : layout)
 		addColumn(c.width, c.id);
 
+	m_channelLayout = getChannelLayout();
+
 	/* Parse the model and assign each channel to its column. */
 
 	m::model::ChannelsLock lock(m::model::channels);
@@ -117,6 +119,19 @@ void geKeyboard::rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void geKeyboard::reconcile()
+{
+	if (getChannelLayout() != m_channelLayout) {
+		rebuild();
+		return;
+	}
+	forEachChannel([](geChannel& c) { c.reconcile(); });
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void geKeyboard::deleteColumn(ID id)
 {
 	u::vector::removeIf(layout, [=](const ColumnLayout& c) { return c.id == id; });
@@ -196,6 +211,11 @@ void geKeyboard::draw()
 {
 	Fl_Scroll::draw();
 
+	/* Column backgrounds don't change when only channels have been redrawn. */
+
+	if (damage() == FL_DAMAGE_CHILD)
+		return;
+
 	/* Paint columns background. Use a clip to draw only what's visible. */
 
 	fl_color(G_COLOR_GREY_1_5);
@@ -307,13 +327,20 @@ geColumn* geKeyboard::getColumnAtCursor(Pixel px)
 
 
 geChannel* geKeyboard::getChannel(ID channelId)
+{
+	geChannel* c = findChannel(channelId);
+	assert(c != nullptr);
+	return c;
+}
+
+
+geChannel* geKeyboard::findChannel(ID channelId)
 {
 	for (geColumn* column : m_columns) {
 		geChannel* c = column->getChannel(channelId);
 		if (c != nullptr) 
 			return c;
 	}
-	assert(false);
 	return nullptr;
 }
 
@@ -333,6 +360,22 @@ std::vector<std::string> geKeyboard::getDroppedFilePaths() const
 /* -------------------------------------------------------------------------- */
 
 
+std::vector<std::pair<ID, ID>> geKeyboard::getChannelLayout() const
+{
+	std::vector<std::pair<ID, ID>> out;
+
+	m::model::ChannelsLock lock(m::model::channels);
+
+	for (const m::Channel* ch : m::model::channels)
+		if (!ch->isInternal())
+			out.push_back({ ch->id, ch->columnId });
+	return out;
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void geKeyboard::storeLayout()
 {
 	layout.clear();
@@ -30,6 +30,7 @@
 
 
 #include <vector>
+#include <utility>
 #include <FL/Fl_Scroll.H>
 #include "core/channels/channel.h"
 #include "core/idManager.h"
@@ -67,6 +68,13 @@ public:
 
 	void rebuild();
 
+	/* reconcile
+	Updates this widget after a model change. Columns are built again only if 
+	channels have been added, removed or moved to another column; otherwise only
+	the channels that have actually changed are updated. */
+
+	void reconcile();
+
 	/* refresh
 	Refreshes each column's channel, called on each GUI cycle. */
 
@@ -87,6 +95,12 @@ public:
 
 	geChannel* getChannel(ID channelId);
 
+	/* findChannel
+	Like getChannel(), but returns nullptr if the UI channel doesn't exist 
+	(yet). */
+
+	geChannel* findChannel(ID channelId);
+
 	/* init
 	Builds the default setup of empty columns. */
 
@@ -125,6 +139,11 @@ private:
 
 	geColumn* getColumnAtCursor(Pixel x);
 
+	/* getChannelLayout
+	Returns the (channel ID, column ID) pairs of the model, in order. */
+
+	std::vector<std::pair<ID, ID>> getChannelLayout() const;
+
 	/* storeLayout
 	Stores the current column layout into the layout vector. */
 	
@@ -133,6 +152,11 @@ private:
 	m::IdManager m_columnId;
 	std::vector<geColumn*> m_columns;
 
+	/* m_channelLayout
+	Channel layout the keyboard was last built with. */
+
+	std::vector<std::pair<ID, ID>> m_channelLayout;
+
 	geButton* m_addColumnBtn;
 };
 }} // giada::v::
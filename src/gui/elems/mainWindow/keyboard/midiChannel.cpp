@@ -26,12 +26,14 @@
 
 
 #include <cassert>
+#include <vector>
 #include <FL/Fl_Menu_Button.H>
 #include "core/const.h"
 #include "core/graphics.h"
 #include "core/channels/midiChannel.h"
 #include "core/model/model.h"
 #include "core/recorder.h"
+#include "core/kernelAudio.h"
 #include "utils/gui.h"
 #include "utils/string.h"
 #include "glue/channel.h"
@@ -72,6 +74,9 @@ enum class Menu
 	SETUP_KEYBOARD_INPUT,
 	SETUP_MIDI_INPUT,
 	SETUP_MIDI_OUTPUT,
+	OUTPUT_BUS,
+	OUTPUT_BUS_1,
+	__END_OUTPUT_BUS_SUBMENU__ = OUTPUT_BUS_1 + G_MAX_IO_BUSES,
 	RENAME_CHANNEL,
 	CLONE_CHANNEL,
 	DELETE_CHANNEL
@@ -87,6 +92,11 @@ void menuCallback(Fl_Widget* w, void* v)
 
 	Menu selectedItem = (Menu) (intptr_t) v;
 
+	if (selectedItem >= Menu::OUTPUT_BUS_1 && selectedItem < Menu::__END_OUTPUT_BUS_SUBMENU__) {
+		c::channel::setOutBus(gch->channelId, (int) selectedItem - (int) Menu::OUTPUT_BUS_1);
+		return;
+	}
+
 	switch (selectedItem)
 	{
 		case Menu::CLEAR_ACTIONS:
@@ -116,6 +126,8 @@ void menuCallback(Fl_Widget* w, void* v)
 		case Menu::DELETE_CHANNEL:
 			c::channel::deleteChannel(gch->channelId);
 			break;
+		default: // Buses and submenu headers
+			break;
 	}
 }
 } // {anonymous}
@@ -149,18 +161,10 @@ geMidiChannel::geMidiChannel(int X, int Y, int W, int H, ID channelId)
 
 	resizable(mainButton);
 
-	m::model::ChannelsLock l(m::model::channels);
-	const m::Channel& ch = m::model::get(m::model::channels, channelId);
-
-#ifdef WITH_VST
-	fx->setStatus(ch.pluginIds.size() > 0);
-#endif
-
 	playButton->callback(cb_playButton, (void*)this);
 	playButton->when(FL_WHEN_CHANGED);   // On keypress && on keyrelease
 
 	arm->type(FL_TOGGLE_BUTTON);
-	arm->value(ch.armed);
 	arm->callback(cb_arm, (void*)this);
 
 #ifdef WITH_VST
@@ -173,12 +177,12 @@ geMidiChannel::geMidiChannel(int X, int Y, int W, int H, ID channelId)
 	solo->type(FL_TOGGLE_BUTTON);
 	solo->callback(cb_solo, (void*)this);
 
-	mainButton->setKey(ch.key);
 	mainButton->callback(cb_openMenu, (void*)this);
 
-	vol->value(ch.volume);
 	vol->callback(cb_changeVol, (void*)this);
 
+	rebuild();
+
 	size(w(), h()); // Force responsiveness
 }
 
@@ -204,7 +208,15 @@ void geMidiChannel::cb_playButton()
 
 void geMidiChannel::cb_openMenu()
 {
-	Fl_Menu_Item rclick_menu[] = {
+	bool hasActions;
+	int  outBus;
+	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
+	{
+		hasActions = c.hasActions;
+		outBus     = c.outBus;
+	});
+
+	std::vector<Fl_Menu_Item> rclick_menu = {
 		{"Edit actions...", 0, menuCallback, (void*) Menu::EDIT_ACTIONS},
 		{"Clear actions",   0, menuCallback, (void*) Menu::CLEAR_ACTIONS, FL_SUBMENU},
 			{"All",           0, menuCallback, (void*) Menu::CLEAR_ACTIONS_ALL},
@@ -212,19 +224,21 @@ void geMidiChannel::cb_openMenu()
 		{"Setup keyboard input...", 0, menuCallback, (void*) Menu::SETUP_KEYBOARD_INPUT},
 		{"Setup MIDI input...",     0, menuCallback, (void*) Menu::SETUP_MIDI_INPUT},
 		{"Setup MIDI output...",    0, menuCallback, (void*) Menu::SETUP_MIDI_OUTPUT},
+		{"Output bus",              0, menuCallback, (void*) Menu::OUTPUT_BUS, FL_SUBMENU}
+	};
+	addBusMenu(rclick_menu, menuCallback, (int) Menu::OUTPUT_BUS_1, 
+		m::kernelAudio::countBusesOut(), outBus);
+	rclick_menu.insert(rclick_menu.end(), {
 		{"Rename", 0, menuCallback, (void*) Menu::RENAME_CHANNEL},
 		{"Clone",  0, menuCallback, (void*) Menu::CLONE_CHANNEL},
 		{"Delete", 0, menuCallback, (void*) Menu::DELETE_CHANNEL},
 		{0}
-	};
+	});
 
 	/* No 'clear actions' if there are no actions. */
 
-	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
-	{
-		if (!c.hasActions)
-			rclick_menu[(int)Menu::CLEAR_ACTIONS].deactivate();
-	});
+	if (!hasActions)
+		rclick_menu[(int)Menu::CLEAR_ACTIONS].deactivate();
 
 	Fl_Menu_Button b(0, 0, 100, 50);
 	b.box(G_CUSTOM_BORDER_BOX);
@@ -232,7 +246,7 @@ void geMidiChannel::cb_openMenu()
 	b.textcolor(G_COLOR_LIGHT_2);
 	b.color(G_COLOR_GREY_2);
 
-	const Fl_Menu_Item* m = rclick_menu->popup(Fl::event_x(), Fl::event_y(), 0, 0, &b);
+	const Fl_Menu_Item* m = rclick_menu.data()->popup(Fl::event_x(), Fl::event_y(), 0, 0, &b);
 	if (m != nullptr)
 		m->do_callback(this, m->user_data());
 	return;
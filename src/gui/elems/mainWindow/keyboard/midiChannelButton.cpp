@@ -28,6 +28,7 @@
 #include "utils/string.h"
 #include "core/channels/midiChannel.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/recManager.h"
 #include "midiChannelButton.h"
 
@@ -37,6 +38,15 @@ namespace v
 {
 geMidiChannelButton::geMidiChannelButton(int x, int y, int w, int h, ID channelId)
 : geChannelButton(x, y, w, h, channelId)
+{
+	rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geMidiChannelButton::rebuild()
 {
     std::string l; 
 	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
@@ -51,7 +61,7 @@ geMidiChannelButton::geMidiChannelButton(int x, int y, int w, int h, ID channelI
 			l += " (ch " + u::string::iToString(mc.midiOutChan + 1) + " out)";
 	});
 
-    label(l.c_str());
+    copy_label(l.c_str());
 }
 
 
@@ -62,12 +72,10 @@ void geMidiChannelButton::refresh()
 {
 	geChannelButton::refresh();
 
-	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
-	{
-		if (m::recManager::isRecordingAction() && c.armed)
-			setActionRecordMode();
-	});
+	const m::telemetry::Channel* c = m::telemetry::getChannel(m_channelId);
+	if (c != nullptr && m::recManager::isRecordingAction() && c->armed)
+		setActionRecordMode();
 	
-	redraw();
+	redrawIfChanged();
 }
 }} // giada::v::
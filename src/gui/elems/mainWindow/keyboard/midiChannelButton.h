@@ -46,6 +46,7 @@ public:
 	geMidiChannelButton(int x, int y, int w, int h, ID channelId);
 	
 	void refresh() override;
+	void rebuild() override;
 };
 }} // giada::v::
 
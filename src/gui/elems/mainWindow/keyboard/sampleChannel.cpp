@@ -26,10 +26,13 @@
 
 
 #include <cassert>
+#include <vector>
 #include "core/channels/sampleChannel.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/mixer.h"
 #include "core/conf.h"
+#include "core/kernelAudio.h"
 #include "core/clock.h"
 #include "core/graphics.h"
 #include "core/wave.h"
@@ -74,6 +77,12 @@ namespace
 enum class Menu
 {
 	INPUT_MONITOR = 0,
+	INPUT_BUS,
+	INPUT_BUS_1,
+	__END_INPUT_BUS_SUBMENU__ = INPUT_BUS_1 + G_MAX_IO_BUSES,
+	OUTPUT_BUS,
+	OUTPUT_BUS_1,
+	__END_OUTPUT_BUS_SUBMENU__ = OUTPUT_BUS_1 + G_MAX_IO_BUSES,
 	LOAD_SAMPLE,
 	EXPORT_SAMPLE,
 	SETUP_KEYBOARD_INPUT,
@@ -110,6 +119,15 @@ void menuCallback(Fl_Widget* w, void* v)
 
 	Menu selectedItem = (Menu) (intptr_t) v;
 
+	if (selectedItem >= Menu::INPUT_BUS_1 && selectedItem < Menu::__END_INPUT_BUS_SUBMENU__) {
+		c::channel::setInBus(gch->channelId, (int) selectedItem - (int) Menu::INPUT_BUS_1);
+		return;
+	}
+	if (selectedItem >= Menu::OUTPUT_BUS_1 && selectedItem < Menu::__END_OUTPUT_BUS_SUBMENU__) {
+		c::channel::setOutBus(gch->channelId, (int) selectedItem - (int) Menu::OUTPUT_BUS_1);
+		return;
+	}
+
 	switch (selectedItem) {
 		case Menu::INPUT_MONITOR: {
 			c::channel::setInputMonitor(gch->channelId, !inputMonitor);
@@ -117,7 +135,8 @@ void menuCallback(Fl_Widget* w, void* v)
 		}
 		case Menu::LOAD_SAMPLE: {
 			gdWindow* w = new gdBrowserLoad("Browse sample", 
-				m::conf::conf.samplePath.c_str(), c::storage::loadSample, gch->channelId);
+				m::conf::conf.samplePath.c_str(), c::storage::loadSample, gch->channelId, 
+				/*samples=*/true);
 			u::gui::openSubWindow(G_MainWin, w, WID_FILE_BROWSER);
 			break;
 		}
@@ -184,6 +203,8 @@ void menuCallback(Fl_Widget* w, void* v)
 			c::channel::deleteChannel(gch->channelId);
 			break;
 		}
+		default: // Buses and submenu headers
+			break;
 	}
 }
 } // {anonymous}
@@ -222,21 +243,10 @@ geSampleChannel::geSampleChannel(int X, int Y, int W, int H, ID channelId)
 
 	resizable(mainButton);
 
-	m::model::ChannelsLock l(m::model::channels);
-	const m::SampleChannel& ch = static_cast<m::SampleChannel&>(m::model::get(m::model::channels, channelId));
-
-	modeBox->value(static_cast<int>(ch.mode));
-	modeBox->redraw();
-
-#ifdef WITH_VST
-	fx->setStatus(ch.pluginIds.size() > 0);
-#endif
-
 	playButton->callback(cb_playButton, (void*)this);
 	playButton->when(FL_WHEN_CHANGED);   // On keypress && on keyrelease
 
 	arm->type(FL_TOGGLE_BUTTON);
-	arm->value(ch.armed);
 	arm->callback(cb_arm, (void*)this);
 
 #ifdef WITH_VST
@@ -249,15 +259,14 @@ geSampleChannel::geSampleChannel(int X, int Y, int W, int H, ID channelId)
 	solo->type(FL_TOGGLE_BUTTON);
 	solo->callback(cb_solo, (void*)this);
 
-	mainButton->setKey(ch.key);
 	mainButton->callback(cb_openMenu, (void*)this);
 
-	readActions->setStatus(ch.readActions);
 	readActions->callback(cb_readActions, (void*)this);
 
-	vol->value(ch.volume);
 	vol->callback(cb_changeVol, (void*)this);
 
+	rebuild();
+
 	size(w(), h()); // Force responsiveness
 }
 
@@ -288,10 +297,14 @@ void geSampleChannel::cb_openMenu()
 	bool isEmptyOrMissing;
 	bool hasActions;
 	bool isAnyLoopMode;
+	int  inBus;
+	int  outBus;
 	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 	{
 		const m::SampleChannel& sc = static_cast<m::SampleChannel&>(c);
 		inputMonitor     = sc.inputMonitor;
+		inBus            = sc.inBus;
+		outBus           = sc.outBus;
 		isEmptyOrMissing = sc.playStatus == ChannelStatus::EMPTY || sc.playStatus == ChannelStatus::MISSING;
 		hasActions       = sc.hasActions;
 		isAnyLoopMode    = sc.isAnyLoopMode();
@@ -303,9 +316,18 @@ void geSampleChannel::cb_openMenu()
 	if (m::recManager::isRecording())
 		return;
 
-	Fl_Menu_Item rclick_menu[] = {
+	std::vector<Fl_Menu_Item> rclick_menu = {
 		{"Input monitor",            0, menuCallback, (void*) Menu::INPUT_MONITOR,
-			FL_MENU_TOGGLE | FL_MENU_DIVIDER | (inputMonitor ? FL_MENU_VALUE : 0)},
+			FL_MENU_TOGGLE | (inputMonitor ? FL_MENU_VALUE : 0)},
+		{"Input bus",  0, menuCallback, (void*) Menu::INPUT_BUS, FL_SUBMENU}
+	};
+	addBusMenu(rclick_menu, menuCallback, (int) Menu::INPUT_BUS_1, 
+		m::kernelAudio::countBusesIn(), inBus);
+	rclick_menu.push_back(
+		{"Output bus", 0, menuCallback, (void*) Menu::OUTPUT_BUS, FL_SUBMENU | FL_MENU_DIVIDER});
+	addBusMenu(rclick_menu, menuCallback, (int) Menu::OUTPUT_BUS_1, 
+		m::kernelAudio::countBusesOut(), outBus);
+	rclick_menu.insert(rclick_menu.end(), {
 		{"Load new sample...",       0, menuCallback, (void*) Menu::LOAD_SAMPLE},
 		{"Export sample to file...", 0, menuCallback, (void*) Menu::EXPORT_SAMPLE},
 		{"Setup keyboard input...",  0, menuCallback, (void*) Menu::SETUP_KEYBOARD_INPUT},
@@ -323,7 +345,7 @@ void geSampleChannel::cb_openMenu()
 		{"Free",   0, menuCallback, (void*) Menu::FREE_CHANNEL},
 		{"Delete", 0, menuCallback, (void*) Menu::DELETE_CHANNEL},
 		{0}
-	};
+	});
 
 	if (isEmptyOrMissing) {
 		rclick_menu[(int) Menu::EXPORT_SAMPLE].deactivate();
@@ -335,6 +357,9 @@ void geSampleChannel::cb_openMenu()
 	if (!hasActions)
 		rclick_menu[(int) Menu::CLEAR_ACTIONS].deactivate();
 
+	if (m::kernelAudio::countBusesIn() == 0)
+		rclick_menu[(int) Menu::INPUT_BUS].deactivate();
+
 
 	/* No 'clear start/stop actions' for those channels in loop mode: they cannot
 	have start/stop actions. */
@@ -348,7 +373,7 @@ void geSampleChannel::cb_openMenu()
 	b.textcolor(G_COLOR_LIGHT_2);
 	b.color(G_COLOR_GREY_2);
 
-	const Fl_Menu_Item* m = rclick_menu->popup(Fl::event_x(), Fl::event_y(), 0, 0, &b);
+	const Fl_Menu_Item* m = rclick_menu.data()->popup(Fl::event_x(), Fl::event_y(), 0, 0, &b);
 	if (m != nullptr)
 		m->do_callback(this, m->user_data());
 	return;
@@ -371,16 +396,34 @@ void geSampleChannel::refresh()
 {
 	geChannel::refresh();
 
+	const m::telemetry::Channel* c = m::telemetry::getChannel(channelId);
+	if (c == nullptr)
+		return;
+
+	if (c->hasData) 
+		status->refresh();
+	if (c->hasActions) {
+		readActions->activate();
+		readActions->setStatus(c->readActions);
+	}
+	else
+		readActions->deactivate();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geSampleChannel::rebuild()
+{
+	geChannel::rebuild();
+
 	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 	{
-		if (c.hasData()) 
-			status->redraw();
-		if (c.hasActions) {
-			readActions->activate();
-			readActions->setStatus(c.readActions);
-		}
-		else
-			readActions->deactivate();
+		const m::SampleChannel& sc = static_cast<m::SampleChannel&>(c);
+		modeBox->value(static_cast<int>(sc.mode));
+		modeBox->redraw();
+		readActions->setStatus(sc.readActions);
 	});
 }
 
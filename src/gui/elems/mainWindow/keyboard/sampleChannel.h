@@ -54,6 +54,7 @@ public:
 	void draw() override;
 
 	void refresh() override;
+	void rebuild() override;
 
 	geChannelMode*  modeBox;
 	geStatusButton* readActions;
@@ -29,6 +29,7 @@
 #include "core/channels/sampleChannel.h"
 #include "core/const.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/wave.h"
 #include "core/mixer.h"
 #include "core/recorder.h"
@@ -50,6 +51,15 @@ namespace v
 {
 geSampleChannelButton::geSampleChannelButton(int x, int y, int w, int h, ID channelId)
 : geChannelButton(x, y, w, h, channelId)
+{
+	rebuild();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geSampleChannelButton::rebuild()
 {
 	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
 	{
@@ -67,11 +77,11 @@ geSampleChannelButton::geSampleChannelButton(int x, int y, int w, int h, ID chan
 				if (sc.name.empty()) {
 					m::model::onGet(m::model::waves, sc.waveId, [&](m::Wave& w)
 					{
-						label(w.getBasename(false).c_str());
+						copy_label(w.getBasename(false).c_str());
 					});
 				}
 				else
-					label(sc.name.c_str());
+					copy_label(sc.name.c_str());
 				break;
 		}
 	});
@@ -85,16 +95,16 @@ void geSampleChannelButton::refresh()
 {
 	geChannelButton::refresh();
 	
-	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
-	{
-		if (m::recManager::isRecordingInput() && c.armed)
+	const m::telemetry::Channel* c = m::telemetry::getChannel(m_channelId);
+	if (c != nullptr) {
+		if (m::recManager::isRecordingInput() && c->armed)
 			setInputRecordMode();
 		else
-		if (m::recManager::isRecordingAction() && c.hasData())
+		if (m::recManager::isRecordingAction() && c->hasData)
 			setActionRecordMode();
-	});
+	}
 
-	redraw();
+	redrawIfChanged();
 }
 
 
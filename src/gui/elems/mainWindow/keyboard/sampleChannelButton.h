@@ -48,6 +48,7 @@ public:
     int handle(int e) override;
 
     void refresh() override;
+    void rebuild() override;
 };
 }} // giada::v::
 
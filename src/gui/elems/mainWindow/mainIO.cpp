@@ -27,6 +27,7 @@
 
 #include "core/const.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/graphics.h"
 #include "core/mixer.h"
 #include "core/mixerHandler.h"
@@ -189,8 +190,8 @@ void geMainIO::setMasterFxInFull(bool v)
 
 void geMainIO::refresh()
 {
-	outMeter->mixerPeak = m::mixer::peakOut.load();
-	inMeter->mixerPeak  = m::mixer::peakIn.load();
+	outMeter->mixerPeak = m::telemetry::get().peakOut;
+	inMeter->mixerPeak  = m::telemetry::get().peakIn;
 	outMeter->redraw();
 	inMeter->redraw();
 }
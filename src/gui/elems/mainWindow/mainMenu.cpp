@@ -81,7 +81,7 @@ geMainMenu::geMainMenu(int x, int y)
 		u::gui::openSubWindow(G_MainWin, new gdAbout(), WID_ABOUT);
 	});
 	config->callback([](Fl_Widget* w, void* v) { 
-		u::gui::openSubWindow(G_MainWin, new gdConfig(400, 370), WID_CONFIG);
+		u::gui::openSubWindow(G_MainWin, new gdConfig(400, 400), WID_CONFIG);
 	});
 }
 
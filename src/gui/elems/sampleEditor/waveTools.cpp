@@ -152,6 +152,8 @@ void geWaveTools::rebuild()
 
 void geWaveTools::refresh()
 {
+	waveform->refresh();
+
 	m::model::onGet(m::model::channels, channelId, [&](m::Channel& c)
 	{
 		if (c.isPreview())
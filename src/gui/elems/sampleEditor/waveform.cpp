@@ -27,11 +27,14 @@
 
 #include <cassert>
 #include <cmath>
+#include <algorithm>
 #include <FL/fl_draw.H>
 #include <FL/Fl_Menu_Button.H>
 #include "core/channels/sampleChannel.h"
 #include "core/model/model.h"
+#include "core/telemetry.h"
 #include "core/wave.h"
+#include "core/wavePeaks.h"
 #include "core/conf.h"
 #include "core/const.h"
 #include "core/mixer.h"
@@ -61,7 +64,8 @@ geWaveform::geWaveform(ID channelId, ID waveId, int x, int y, int w, int h)
   m_dragged     (false),
   m_resizedA    (false),
   m_resizedB    (false),
-  m_ratio       (0.0f)
+  m_ratio       (0.0f),
+  m_peaksVersion(0)
 {
 	m_data.size = w;
 
@@ -114,13 +118,22 @@ int geWaveform::alloc(int datasize, bool force)
 	int offset = h() / 2;
 	int zero   = y() + offset; // center, zero amplitude (-inf dB)
 
-	/* Frid frequency: store a grid point every 'gridFreq' frame (if grid is
+	/* Grid frequency: store a grid point every 'gridFreq' frame (if grid is
 	enabled). TODO - this will cause round off errors, since gridFreq is integer. */
 
 	int gridFreq = m_grid.level != 0 ? wave.getSize() / m_grid.level : 0;
 
-	/* Resampling the waveform, hardcore way. Many thanks to 
-	http://fourier.eng.hmc.edu/e161/lectures/resize/node3.html */
+	if (gridFreq != 0)
+		for (int k = gridFreq; k < wave.getSize(); k += gridFreq)
+			m_grid.points.push_back(k);
+
+	/* Read peaks from the multi-resolution cache, built in background: the 
+	waveform will be redrawn by refresh() when it's ready. Only when zoomed in 
+	past the finest level frames are scanned directly. */
+
+	m::WavePeaks& peaks = *wave.peaks;
+	peaks.request(wave.getSize());
+	m_peaksVersion = peaks.getVersion();
 
 	for (int i = 0; i < m_data.size; i++) {
 		
@@ -129,35 +142,27 @@ int geWaveform::alloc(int datasize, bool force)
 		int pc = i     * m_ratio;  // current point TODO - int until we switch to uint32_t for Wave size...
 		int pn = (i+1) * m_ratio;  // next point    TODO - int until we switch to uint32_t for Wave size...
 
-		float peaksup = 0.0f;
-		float peakinf = 0.0f;
-
-		for (int k = pc; k < pn; k++) { // TODO - int until we switch to uint32_t for Wave size...
-
-			if (k >= wave.getSize())
-				continue;
-
-			/* Compute average of stereo signal. */
-
-			float avg = 0.0f;
-			float* frame = wave.getFrame(k);
-			for (int j = 0; j < wave.getChannels(); j++)
-				avg += frame[j];
-			avg /= wave.getChannels();
-			
-			/* Find peaks (greater and lower). */
+		m::WavePeaks::Peak peak;
 
-			if      (avg > peaksup)  peaksup = avg;
-			else if (avg <= peakinf) peakinf = avg;
+		if (!peaks.get(pc, pn, peak)) {
+			peak = { 0.0f, 0.0f };
+			for (int k = pc; k < pn && k < wave.getSize(); k++) { // TODO - int until we switch to uint32_t for Wave size...
 
-			/* Fill up grid vector. */
+				/* Compute average of stereo signal. */
 
-			if (gridFreq != 0 && (int) k % gridFreq == 0 && k != 0)
-				m_grid.points.push_back(k);
+				float avg = 0.0f;
+				float* frame = wave.getFrame(k);
+				for (int j = 0; j < wave.getChannels(); j++)
+					avg += frame[j];
+				avg /= wave.getChannels();
+				
+				peak.min = std::min(peak.min, avg);
+				peak.max = std::max(peak.max, avg);
+			}
 		}
 
-		m_data.sup[i] = zero - (peaksup * offset);
-		m_data.inf[i] = zero - (peakinf * offset);
+		m_data.sup[i] = zero - (peak.max * offset);
+		m_data.inf[i] = zero - (peak.min * offset);
 
 		// avoid window overflow
 
@@ -286,11 +291,11 @@ void geWaveform::drawStartEndPoints()
 
 void geWaveform::drawPlayHead()
 {
-	float tp;	
-	m::model::onGet(m::model::channels, m_channelId, [&](m::Channel& c)
-	{
-		tp = static_cast<m::SampleChannel&>(c).trackerPreview;
-	});
+	const m::telemetry::Channel* c = m::telemetry::getChannel(m_channelId);
+	if (c == nullptr)
+		return;
+
+	float tp = c->trackerPreview;
 
 	int p = frameToPixel(tp) + x();
 	fl_color(G_COLOR_LIGHT_2);
@@ -679,6 +684,26 @@ void geWaveform::rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void geWaveform::refresh()
+{
+	std::uint64_t version;
+	{
+		m::model::WavesLock lock(m::model::waves);
+		const m::Wave* wave = m::model::find(m::model::waves, m_waveId);
+		if (wave == nullptr)
+			return;
+		version = wave->peaks->getVersion();
+	}
+	if (version == m_peaksVersion)
+		return;
+	alloc(m_data.size, /*force=*/true);
+	redraw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool geWaveform::smaller() const
 {
 	return w() < parent()->w();
@@ -30,6 +30,7 @@
 
 
 #include <vector>
+#include <cstdint>
 #include <FL/Fl_Widget.H>
 #include "core/const.h"
 
@@ -84,6 +85,12 @@ public:
 
 	void rebuild();
 
+	/* refresh
+	Redraws the waveform if the peak cache has been updated by the background
+	worker since the last alloc(). */
+
+	void refresh();
+
 	/* setGridLevel
 	Sets a new frequency level for the grid. 0 means disabled. */
 
@@ -202,6 +209,11 @@ private:
 	float m_ratio;
 	int   m_mouseX;
 	int   m_mouseY;
+
+	/* m_peaksVersion
+	Version of the peak cache used by the last alloc(). */
+
+	std::uint64_t m_peaksVersion;
 };
 }} // giada::v::
 
@@ -0,0 +1,100 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include <algorithm>
+#include <FL/fl_draw.H>
+#include "core/const.h"
+#include "core/peakCache.h"
+#include "wavePreview.h"
+
+
+namespace giada {
+namespace v
+{
+geWavePreview::geWavePreview(int x, int y, int w, int h)
+: Fl_Box  (x, y, w, h),
+  m_frames(0)
+{
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geWavePreview::load(const std::string& path)
+{
+	if (!m::peakCache::read(path, m_levels, m_frames))
+		m_frames = 0;
+	redraw();
+}
+
+
+void geWavePreview::clear()
+{
+	m_frames = 0;
+	redraw();
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
+void geWavePreview::draw()
+{
+	using m::WavePeaks;
+
+	fl_rectf(x(), y(), w(), h(), G_COLOR_GREY_2);
+	fl_rect(x(), y(), w(), h(), G_COLOR_GREY_4);
+
+	const int width = w() - 2;
+	if (m_frames == 0 || width <= 0)
+		return;
+
+	/* Pick the coarsest level that still has at least one block per pixel. */
+
+	size_t level = 0;
+	for (size_t l = 1; l < WavePeaks::LEVELS.size(); l++)
+		if (WavePeaks::LEVELS[l] * width <= m_frames)
+			level = l;
+
+	const std::vector<WavePeaks::Peak>& blocks = m_levels[level];
+	const int zero = y() + h() / 2;
+	const int half = (h() - 2) / 2;
+
+	fl_color(G_COLOR_LIGHT_1);
+	for (int px = 0; px < width; px++) {
+		size_t a = (static_cast<size_t>(px) * blocks.size()) / width;
+		size_t b = std::max(a + 1, (static_cast<size_t>(px + 1) * blocks.size()) / width);
+		WavePeaks::Peak p = { 0.0f, 0.0f };
+		for (size_t i = a; i < b && i < blocks.size(); i++) {
+			p.min = std::min(p.min, blocks[i].min);
+			p.max = std::max(p.max, blocks[i].max);
+		}
+		fl_line(x() + 1 + px, zero - p.max * half, x() + 1 + px, zero - p.min * half);
+	}
+}
+}} // giada::v::
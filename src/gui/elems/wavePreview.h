@@ -0,0 +1,70 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2020 Giovanni A. Zuliani | Monocasual
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef GE_WAVE_PREVIEW_H
+#define GE_WAVE_PREVIEW_H
+
+
+#include <string>
+#include <FL/Fl_Box.H>
+#include "core/types.h"
+#include "core/wavePeaks.h"
+
+
+namespace giada {
+namespace v
+{
+/* geWavePreview
+Small waveform of an audio file on disk, drawn from its peak file in the 
+on-disk cache: the audio is never decoded. Shows nothing if the file has never
+been opened in the sample editor before. */
+
+class geWavePreview : public Fl_Box
+{
+public:
+
+	geWavePreview(int x, int y, int w, int h);
+
+	void draw() override;
+
+	/* load
+	Reads peaks of audio file 'path' from the cache. Clears the preview if not
+	available. */
+
+	void load(const std::string& path);
+
+	void clear();
+
+private:
+
+	m::WavePeaks::Levels m_levels;
+	Frame                m_frames;
+};
+}} // giada::v::
+
+
+#endif
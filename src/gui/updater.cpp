@@ -28,6 +28,9 @@
 #include <FL/Fl.H>
 #include "core/const.h"
 #include "core/model/model.h"
+#include "core/mixer.h"
+#include "core/recManager.h"
+#include "core/telemetry.h"
 #include "utils/gui.h"
 #include "updater.h"
 
@@ -38,11 +41,23 @@ namespace updater
 {
 void update(void* p)
 {
+	/* Signal-triggered recordings are started by the audio thread: make them
+	official before looking at the engine state. */
+
+	m::recManager::refresh();
+
+	/* Grab the latest engine state once: every widget refreshed below reads 
+	from this snapshot. Without a running stream the main thread publishes it 
+	on its own, so that widgets always find their channel. */
+
+	m::mixer::publishIdleTelemetry();
+	m::telemetry::fetch();
+
 	if (m::model::waves.changed.load()    == true ||
 		m::model::actions.changed.load()  == true ||
 		m::model::channels.changed.load() == true)
 	{
-		u::gui::rebuild();
+		u::gui::reconcile();
 		m::model::waves.changed.store(false);
 		m::model::actions.changed.store(false);
 		m::model::channels.changed.store(false);
@@ -26,8 +26,13 @@
 
 
 #include <atomic>
+#include <string>
 #include <FL/Fl.H>
+#include "core/const.h"
 #include "core/init.h"
+#ifdef WITH_VST
+#include "core/pluginManager.h"
+#endif
 
 
 class gdMainWindow* G_MainWin = nullptr;
@@ -37,6 +42,14 @@ int main(int argc, char** argv)
 {
 	using namespace giada;
 
+#ifdef WITH_VST
+	/* Plug-in scanner mode: Giada is spawned by pluginManager::scanDirs to scan
+	a single binary in a separate process. */
+
+	if (argc == 4 && std::string(argv[1]) == G_PLUGIN_SCAN_ARG)
+		return m::pluginManager::scanFile(argv[2], argv[3]);
+#endif
+
 	m::init::startup(argc, argv);
 
 	int ret = Fl::run();
@@ -34,6 +34,8 @@
 	#include <X11/xpm.h>
 #endif
 #include "core/channels/channel.h"
+#include "core/model/model.h"
+#include "core/automation.h"
 #include "core/mixer.h"
 #include "core/mixerHandler.h"
 #include "core/clock.h"
@@ -45,13 +47,19 @@
 #include "gui/dialogs/actionEditor/baseActionEditor.h"
 #include "gui/dialogs/window.h"
 #include "gui/dialogs/sampleEditor.h"
+#ifdef WITH_VST
+#include "gui/dialogs/pluginWindow.h"
+#endif
 #include "gui/elems/mainWindow/mainIO.h"
 #include "gui/elems/mainWindow/mainTimer.h"
 #include "gui/elems/mainWindow/mainTransport.h"
 #include "gui/elems/mainWindow/beatMeter.h"
 #include "gui/elems/mainWindow/keyboard/keyboard.h"
 #include "gui/elems/mainWindow/keyboard/channel.h"
+#include "gui/elems/basics/dial.h"
 #include "gui/elems/sampleEditor/waveTools.h"
+#include "gui/elems/sampleEditor/volumeTool.h"
+#include "gui/elems/sampleEditor/pitchTool.h"
 #include "log.h"
 #include "string.h"
 #include "gui.h"
@@ -67,6 +75,86 @@ namespace gui
 namespace
 {
 int blinker_ = 0;
+
+
+/* -------------------------------------------------------------------------- */
+
+
+#ifdef WITH_VST
+
+void refreshPluginParameter_(ID pluginId, int index)
+{
+	/* Plug-ins with their own editor refresh themselves. */
+
+	bool hasEditor = true;
+	m::model::onGet(m::model::plugins, pluginId, [&](m::Plugin& p)
+	{
+		hasEditor = p.hasEditor();
+	});
+	if (hasEditor)
+		return;
+
+	v::gdWindow* parent = getSubwindow(G_MainWin, WID_FX_LIST);
+	if (parent == nullptr)
+		return;
+	v::gdPluginWindow* child = static_cast<v::gdPluginWindow*>(getSubwindow(parent, pluginId + 1));
+	if (child != nullptr)
+		child->updateParameter(index, /*changeSlider=*/true);
+}
+
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+
+/* refreshAutomation_
+Brings widgets in line with the parameters changed via MIDI since the last 
+refresh. Any number of MIDI messages results in one update per widget. */
+
+void refreshAutomation_()
+{
+	namespace ma = m::automation;
+
+	bool volume = false;
+	bool pitch  = false;
+
+	ma::fetch([&](ma::Param p, ID id, int index, float value)
+	{
+		switch (p) {
+			case ma::Param::VOLUME:
+				if (id == m::mixer::MASTER_OUT_CHANNEL_ID)
+					G_MainWin->mainIO->setOutVol(value);
+				else
+				if (id == m::mixer::MASTER_IN_CHANNEL_ID)
+					G_MainWin->mainIO->setInVol(value);
+				else {
+					v::geChannel* ch = G_MainWin->keyboard->findChannel(id);
+					if (ch != nullptr)
+						ch->vol->value(value);
+				}
+				volume = true;
+				break;
+			case ma::Param::PITCH:
+				pitch = true;
+				break;
+			case ma::Param::PLUGIN:
+#ifdef WITH_VST
+				refreshPluginParameter_(id, index);
+#endif
+				break;
+		}
+	});
+
+	if (!volume && !pitch)
+		return;
+
+	v::gdSampleEditor* editor = static_cast<v::gdSampleEditor*>(getSubwindow(G_MainWin, WID_SAMPLE_EDITOR));
+	if (editor == nullptr) 
+		return;
+	if (volume) editor->volumeTool->rebuild();
+	if (pitch)  editor->pitchTool->rebuild();
+}
 } // {anonymous}
 
 
@@ -97,12 +185,24 @@ void refreshSubWindow(int wid)
 /* -------------------------------------------------------------------------- */
 
 
+void reconcileSubWindow(int wid)
+{
+	v::gdWindow* w = getSubwindow(G_MainWin, wid);
+	if(w != nullptr)  // If its open
+		w->reconcile();		
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 void refresh()
 {
 	/* Update dynamic elements inside main window: in and out meters, beat meter
 	and each channel. */
 
 	G_MainWin->refresh();
+	refreshAutomation_();
 
 	/* Compute timer for blinker. */
 
@@ -129,6 +229,18 @@ void rebuild()
 /* -------------------------------------------------------------------------- */
 
 
+void reconcile()
+{
+	G_MainWin->reconcile();
+	reconcileSubWindow(WID_FX_LIST);
+	reconcileSubWindow(WID_SAMPLE_EDITOR);
+	reconcileSubWindow(WID_ACTION_EDITOR);
+}
+
+
+/* -------------------------------------------------------------------------- */
+
+
 bool shouldBlink()
 {
 	return blinker_ > 6;
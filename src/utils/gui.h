@@ -47,15 +47,23 @@ Repaints some dynamic GUI elements. */
 void refresh();
 
 /* rebuild
-Rebuilds the UI from scratch. Used when the model has changed. */
+Rebuilds the UI from scratch. */
 
 void rebuild();
 
-/* [rebuild|refresh]SubWindow 
-Rebuilds or refreshes subwindow with ID 'wid' if it exists. i.e. if its open. */
+/* reconcile
+Updates only the UI elements whose model data has changed since the last call.
+Used when the model has changed. */
+
+void reconcile();
+
+/* [rebuild|refresh|reconcile]SubWindow 
+Rebuilds, refreshes or reconciles subwindow with ID 'wid' if it exists. i.e. if 
+its open. */
 
 void rebuildSubWindow(int wid);
 void refreshSubWindow(int wid);
+void reconcileSubWindow(int wid);
 
 /* shouldBlink
 Return whether is time to blink something or not. This is used to make widgets 
@@ -58,4 +58,27 @@ float dBtoLinear(float f)
 	return std::pow(10, f/20.0f); 
 }
 
+
+/* -------------------------------------------------------------------------- */
+
+
+int gridFrame(int k, int length, int divisions)
+{
+	return (static_cast<long long>(k) * length) / divisions;
+}
+
+
+int gridIndex(int x, int length, int divisions)
+{
+	if (length <= 0)
+		return 0;
+	return ((static_cast<long long>(x) + 1) * divisions - 1) / length;
+}
+
+
+bool isOnGrid(int x, int length, int divisions)
+{
+	return length > 0 && gridFrame(gridIndex(x, length, divisions), length, divisions) == x;
+}
+
 }}}  // giada::u::math::
\ No newline at end of file
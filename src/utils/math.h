@@ -37,6 +37,16 @@ float linearToDB(float f);
 float dBtoLinear(float f);
 int quantize(int x, int step);
 
+/* gridFrame, gridIndex, isOnGrid
+Exact positions over a span of 'length' frames split into 'divisions' equal 
+parts, e.g. the beats of a loop. Part 'k' starts on frame 
+floor(k * length / divisions), so no rounding error piles up from one part to
+the next. gridIndex() returns the part frame 'x' belongs to. */
+
+int  gridFrame(int k, int length, int divisions);
+int  gridIndex(int x, int length, int divisions);
+bool isOnGrid(int x, int length, int divisions);
+
 
 /* -------------------------------------------------------------------------- */
 
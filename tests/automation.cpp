@@ -0,0 +1,102 @@
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/model/model.h"
+#include "../src/core/automation.h"
+#include "../src/core/const.h"
+#include <catch.hpp>
+
+
+TEST_CASE("automation")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int BUFFER_SIZE = 1024;
+	const int SAMPLE_RATE = 44100;
+
+	/* Slots are never released: use IDs no other test binds to. */
+
+	const ID CHANNEL_ID = 1001;
+	const ID MISSING_ID = 1002;
+
+	auto getVolume = [](ID id)
+	{
+		model::ChannelsLock l(model::channels);
+		return model::get(model::channels, id).volume;
+	};
+
+	model::channels.clear();
+	model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, CHANNEL_ID));
+	model::onSwap(model::channels, CHANNEL_ID, [](Channel& c) { c.volume = 1.0f; });
+
+	SECTION("slot reuse")
+	{
+		int slot = automation::bind(automation::Param::VOLUME, CHANNEL_ID);
+
+		REQUIRE(slot != -1);
+		REQUIRE(automation::bind(automation::Param::VOLUME, CHANNEL_ID) == slot);
+		REQUIRE(automation::bind(automation::Param::PITCH, CHANNEL_ID) != slot);
+		REQUIRE(automation::bind(automation::Param::PLUGIN, CHANNEL_ID, 1) != 
+		        automation::bind(automation::Param::PLUGIN, CHANNEL_ID, 2));
+	}
+
+	SECTION("smoothing convergence")
+	{
+		int slot = automation::bind(automation::Param::VOLUME, CHANNEL_ID);
+		automation::write(slot, 0.5f);
+
+		/* First block: on the way, not there yet. */
+
+		automation::process(SAMPLE_RATE, BUFFER_SIZE);
+		float v = getVolume(CHANNEL_ID);
+		REQUIRE(v < 1.0f);
+		REQUIRE(v > 0.5f);
+
+		for (int i = 0; i < 100; i++)
+			automation::process(SAMPLE_RATE, BUFFER_SIZE);
+		REQUIRE(getVolume(CHANNEL_ID) == 0.5f);
+
+		/* One notification per target, with the latest value. */
+
+		int calls = 0;
+		automation::fetch([&](automation::Param p, ID id, int, float value)
+		{
+			if (id != CHANNEL_ID)
+				return;
+			REQUIRE(p == automation::Param::VOLUME);
+			REQUIRE(value == 0.5f);
+			calls++;
+		});
+		REQUIRE(calls == 1);
+	}
+
+	SECTION("missing target")
+	{
+		int missing = automation::bind(automation::Param::VOLUME, MISSING_ID);
+		automation::write(missing, 0.2f);
+		automation::process(SAMPLE_RATE, BUFFER_SIZE);
+
+		bool notified = false;
+		automation::fetch([&](automation::Param, ID id, int, float) 
+		{ 
+			if (id == MISSING_ID) notified = true; 
+		});
+		REQUIRE(notified == false);
+
+		/* A target removed while moving deactivates its slot: a channel coming 
+		back with the same ID is left alone until a new value is written. */
+
+		int slot = automation::bind(automation::Param::VOLUME, CHANNEL_ID);
+		automation::write(slot, 0.0f);
+		automation::process(SAMPLE_RATE, BUFFER_SIZE);
+
+		model::channels.pop(model::getIndex(model::channels, CHANNEL_ID));
+		automation::process(SAMPLE_RATE, BUFFER_SIZE);
+
+		model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, CHANNEL_ID));
+		model::onSwap(model::channels, CHANNEL_ID, [](Channel& c) { c.volume = 1.0f; });
+		automation::fetch([](automation::Param, ID, int, float) {});
+		automation::process(SAMPLE_RATE, BUFFER_SIZE);
+
+		REQUIRE(getVolume(CHANNEL_ID) == 1.0f);
+	}
+}
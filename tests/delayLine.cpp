@@ -0,0 +1,64 @@
+#include "../src/core/audioBuffer.h"
+#include "../src/core/delayLine.h"
+#include <catch.hpp>
+
+
+TEST_CASE("DelayLine")
+{
+	using namespace giada::m;
+
+	static const int BUFFER_SIZE = 64;
+	static const int CHANNELS    = 2;
+
+	AudioBuffer buffer;
+	buffer.alloc(BUFFER_SIZE, CHANNELS);
+
+	auto fill = [&](int block)
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			for (int j=0; j<CHANNELS; j++)
+				buffer[i][j] = static_cast<float>(block * BUFFER_SIZE + i + 1);
+	};
+
+	SECTION("test zero delay")
+	{
+		DelayLine d(0, CHANNELS);
+		fill(0);
+		d.process(buffer);
+
+		REQUIRE(d.getDelay() == 0);
+		for (int i=0; i<BUFFER_SIZE; i++)
+			REQUIRE(buffer[i][0] == static_cast<float>(i + 1));
+	}
+
+	SECTION("test delay shorter than buffer")
+	{
+		const int DELAY = 10;
+		DelayLine d(DELAY, CHANNELS);
+		fill(0);
+		d.process(buffer);
+
+		for (int i=0; i<DELAY; i++)
+			for (int j=0; j<CHANNELS; j++)
+				REQUIRE(buffer[i][j] == 0.0f);
+		for (int i=DELAY; i<BUFFER_SIZE; i++)
+			for (int j=0; j<CHANNELS; j++)
+				REQUIRE(buffer[i][j] == static_cast<float>(i - DELAY + 1));
+	}
+
+	SECTION("test delay longer than buffer")
+	{
+		const int DELAY = BUFFER_SIZE * 2 + 5;
+		DelayLine d(DELAY, CHANNELS);
+
+		for (int block=0; block<4; block++) {
+			fill(block);
+			d.process(buffer);
+			for (int i=0; i<BUFFER_SIZE; i++) {
+				int   frame    = block * BUFFER_SIZE + i;
+				float expected = frame < DELAY ? 0.0f : static_cast<float>(frame - DELAY + 1);
+				REQUIRE(buffer[i][1] == expected);
+			}
+		}
+	}
+}
@@ -0,0 +1,35 @@
+#include "../src/core/dll.h"
+#include <catch.hpp>
+
+
+TEST_CASE("Dll")
+{
+	using namespace giada::m;
+
+	/* MIDI clock at 120 bpm: 24 ticks per beat, one beat every 0.5 s. */
+
+	const double PERIOD = 0.5 / 24;
+
+	Dll dll(1.0);
+	dll.reset(0.0, PERIOD * 1.1);
+
+	SECTION("test period tracking")
+	{
+		for (int i=1; i<=24 * 20; i++)
+			dll.update(i * PERIOD);
+
+		REQUIRE(dll.getPeriod() == Approx(PERIOD).epsilon(0.001));
+		REQUIRE(dll.getTime() == Approx(24 * 20 * PERIOD).margin(0.0001));
+	}
+
+	SECTION("test jitter filtering")
+	{
+		/* +/- 1 ms of jitter on every tick. */
+
+		for (int i=1; i<=24 * 20; i++)
+			dll.update(i * PERIOD + (i % 2 == 0 ? 0.001 : -0.001));
+
+		REQUIRE(dll.getPeriod() == Approx(PERIOD).epsilon(0.01));
+		REQUIRE(std::abs(dll.getTime() - 24 * 20 * PERIOD) < 0.0005);
+	}
+}
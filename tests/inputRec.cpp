@@ -0,0 +1,142 @@
+#include "../src/core/const.h"
+#include "../src/core/audioBuffer.h"
+#include "../src/core/inputRec.h"
+#include <catch.hpp>
+
+
+TEST_CASE("inputRec")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int   SAMPLE_RATE    = 44100;
+	static const int   BUFFER_SIZE    = 256;
+	static const Frame FRAMES_IN_LOOP = 1000;
+
+	inputRec::init("tests/resources/take-spool.wav", SAMPLE_RATE, G_MAX_IO_CHANS);
+
+	AudioBuffer in;
+	in.alloc(BUFFER_SIZE, G_MAX_IO_CHANS);
+
+	SECTION("test take longer than the loop")
+	{
+		/* Ramp on the left channel, starting on loop frame 100. */
+
+		float v = 1.0f;
+		inputRec::start(100);
+		for (int b=0; b<40; b++) {
+			for (int i=0; i<BUFFER_SIZE; i++, v++) {
+				in[i][0] = v;
+				in[i][1] = -v;
+			}
+			inputRec::write(in, (100 + b * BUFFER_SIZE) % FRAMES_IN_LOOP, FRAMES_IN_LOOP, 1.0f);
+		}
+
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == true);
+		REQUIRE(take.countFrames() == 11000);  // 100 + 40 * 256 rounded up 
+		REQUIRE(take[99][0] == 0.0f);
+		REQUIRE(take[100][0] == 1.0f);
+		REQUIRE(take[100][1] == -1.0f);
+		REQUIRE(take[100 + 10239][0] == 10240.0f);
+		REQUIRE(take[100 + 10240][0] == 0.0f);
+	}
+
+	SECTION("test punch in/out")
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			in[i][0] = in[i][1] = 1.0f;
+
+		inputRec::setPunch(200, 300);
+		inputRec::start(0);
+		for (int b=0; b<3; b++)
+			inputRec::write(in, b * BUFFER_SIZE, FRAMES_IN_LOOP, 0.5f);
+
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == true);
+		REQUIRE(take.countFrames() == FRAMES_IN_LOOP);
+		REQUIRE(take[199][0] == 0.0f);
+		REQUIRE(take[200][0] == 0.5f);
+		REQUIRE(take[299][0] == 0.5f);
+		REQUIRE(take[300][0] == 0.0f);
+
+		inputRec::clearPunch();
+	}
+
+	SECTION("test trigger with pre-roll")
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			in[i][0] = in[i][1] = 1.0f;
+		inputRec::listen(in);
+
+		for (int i=0; i<BUFFER_SIZE; i++)
+			in[i][0] = in[i][1] = 2.0f;
+		inputRec::trigger(in, /*from=*/50, /*preRoll=*/100, FRAMES_IN_LOOP, 1.0f);
+		inputRec::listen(in);
+
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == true);
+		REQUIRE(take[0][0] == 1.0f);
+		REQUIRE(take[49][0] == 1.0f);
+		REQUIRE(take[50][0] == 2.0f);
+		REQUIRE(take[50 + BUFFER_SIZE - 1][0] == 2.0f);
+		REQUIRE(take[50 + BUFFER_SIZE][0] == 0.0f);
+	}
+
+	SECTION("test trigger without enough history")
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			in[i][0] = in[i][1] = 1.0f;
+		inputRec::trigger(in, /*from=*/10, /*preRoll=*/100, FRAMES_IN_LOOP, 1.0f);
+
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == true);
+		REQUIRE(take[89][0] == 0.0f);
+		REQUIRE(take[90][0] == 1.0f);
+	}
+
+	SECTION("test stop without take")
+	{
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == false);
+	}
+
+	inputRec::close();
+}
+
+
+TEST_CASE("inputRec with multiple buses")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int   SAMPLE_RATE    = 44100;
+	static const int   BUFFER_SIZE    = 256;
+	static const int   CHANNELS       = G_MAX_IO_CHANS * 2;
+	static const Frame FRAMES_IN_LOOP = 1000;
+
+	inputRec::init("tests/resources/take-spool.wav", SAMPLE_RATE, CHANNELS);
+
+	AudioBuffer in;
+	in.alloc(BUFFER_SIZE, CHANNELS);
+
+	SECTION("test take keeps every input channel")
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			for (int j=0; j<CHANNELS; j++)
+				in[i][j] = j + 1.0f;
+
+		inputRec::start(0);
+		inputRec::write(in, 0, FRAMES_IN_LOOP, 1.0f);
+
+		AudioBuffer take;
+		REQUIRE(inputRec::stop(take, FRAMES_IN_LOOP) == true);
+		REQUIRE(take.countChannels() == CHANNELS);
+		REQUIRE(take[0][0] == 1.0f);
+		REQUIRE(take[0][2] == 3.0f);
+		REQUIRE(take[BUFFER_SIZE - 1][3] == 4.0f);
+		REQUIRE(take[BUFFER_SIZE][3] == 0.0f);
+	}
+
+	inputRec::close();
+}
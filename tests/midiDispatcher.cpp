@@ -0,0 +1,136 @@
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/channels/midiChannel.h"
+#include "../src/core/model/model.h"
+#include "../src/core/midiDispatcher.h"
+#include "../src/core/const.h"
+#include <catch.hpp>
+
+
+TEST_CASE("midiDispatcher")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int      BUFFER_SIZE = 1024;
+	const uint32_t NOTE_ON     = 0x903C0000;  // Note 60, MIDI channel 0
+	const uint32_t CC_7        = 0xB0070000;  // CC 7, MIDI channel 0
+
+	auto getRoutes = [](uint32_t pure)
+	{
+		model::MidiRoutesLock l(model::midiRoutes);
+		const auto& map = model::midiRoutes.get()->map;
+		const auto  it  = map.find(pure);
+		return it == map.end() ? std::vector<model::MidiRoute>() : it->second;
+	};
+
+	model::onSwap(model::midiIn, [](model::MidiIn& m) { m = model::MidiIn(); });
+
+	model::channels.clear();
+	model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, 1));
+	model::channels.push(std::make_unique<SampleChannel>(false, BUFFER_SIZE, 1, 2));
+	model::channels.push(std::make_unique<MidiChannel>(BUFFER_SIZE, 1, 3));
+
+	SECTION("first match")
+	{
+		/* Same message learned twice on the same channel: the first parameter
+		wins, as in the old linear lookup. Another channel gets it too. */
+
+		model::onSwap(model::channels, 1, [&](Channel& c)
+		{
+			c.midiIn         = true;
+			c.midiInKeyPress = NOTE_ON;
+			c.midiInMute     = NOTE_ON;
+		});
+		model::onSwap(model::channels, 2, [&](Channel& c)
+		{
+			c.midiIn     = true;
+			c.midiInSolo = NOTE_ON;
+		});
+		model::onSwap(model::midiIn, [&](model::MidiIn& m)
+		{
+			m.startStop = NOTE_ON;
+			m.metronome = NOTE_ON;
+		});
+
+		midiDispatcher::rebuild();
+
+		std::vector<model::MidiRoute> routes = getRoutes(NOTE_ON);
+
+		REQUIRE(routes.size() == 3);
+		REQUIRE(routes[0].param == G_MIDI_IN_START_STOP);
+		REQUIRE(routes[1].param == G_MIDI_IN_KEYPRESS);
+		REQUIRE(routes[1].channelId == 1);
+		REQUIRE(routes[2].param == G_MIDI_IN_SOLO);
+		REQUIRE(routes[2].channelId == 2);
+	}
+
+	SECTION("disabled channels")
+	{
+		model::onSwap(model::channels, 1, [&](Channel& c)
+		{
+			c.midiIn         = false;
+			c.midiInKeyPress = NOTE_ON;
+		});
+
+		midiDispatcher::rebuild();
+
+		REQUIRE(getRoutes(NOTE_ON).empty());
+	}
+
+	SECTION("filter")
+	{
+		model::onSwap(model::channels, 2, [&](Channel& c)
+		{
+			c.midiIn       = true;
+			c.midiInFilter = 3;
+			c.midiInKill   = CC_7;
+		});
+
+		midiDispatcher::rebuild();
+
+		std::vector<model::MidiRoute> routes = getRoutes(CC_7);
+
+		REQUIRE(routes.size() == 1);
+		REQUIRE(routes[0].accepts(3) == true);
+		REQUIRE(routes[0].accepts(0) == false);
+	}
+
+	SECTION("continuous parameters")
+	{
+		model::onSwap(model::channels, 1, [&](Channel& c)
+		{
+			c.midiIn       = true;
+			c.midiInVolume = CC_7;
+		});
+
+		midiDispatcher::rebuild();
+
+		std::vector<model::MidiRoute> routes = getRoutes(CC_7);
+
+		REQUIRE(routes.size() == 1);
+		REQUIRE(routes[0].slot != -1);
+	}
+
+	SECTION("receivers and membership")
+	{
+		model::onSwap(model::channels, 3, [&](Channel& c) { c.midiIn = true; });
+		model::onSwap(model::channels, 1, [&](Channel& c)
+		{
+			c.midiIn         = true;
+			c.midiInKeyPress = NOTE_ON;
+		});
+
+		midiDispatcher::rebuild();
+
+		{
+			model::MidiRoutesLock l(model::midiRoutes);
+			REQUIRE(model::midiRoutes.get()->receivers.size() == 1);
+			REQUIRE(model::midiRoutes.get()->receivers[0].channelId == 3);
+		}
+
+		model::channels.pop(model::getIndex(model::channels, 1));
+		midiDispatcher::rebuild();
+
+		REQUIRE(getRoutes(NOTE_ON).empty());
+	}
+}
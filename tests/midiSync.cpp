@@ -0,0 +1,89 @@
+#include "../src/core/midiSync.h"
+#include "../src/core/const.h"
+#include <catch.hpp>
+
+
+TEST_CASE("midiSync")
+{
+	using namespace giada::m;
+
+	SECTION("test song position pointer")
+	{
+		/* 0x110 MIDI beats: LSB first, 7 bits each. */
+
+		REQUIRE(midiSync::decodePosition({ MIDI_POSITION_PTR, 0x10, 0x02 }) == 0x110);
+		REQUIRE(midiSync::decodePosition({ MIDI_POSITION_PTR, 0x00, 0x00 }) == 0);
+		REQUIRE(midiSync::decodePosition({ MIDI_POSITION_PTR, 0x7F, 0x7F }) == 0x3FFF);
+		REQUIRE(midiSync::decodePosition({ MIDI_POSITION_PTR, 0x10 }) == -1);
+		REQUIRE(midiSync::decodePosition({ MIDI_CLOCK, 0x10, 0x02 }) == -1);
+	}
+
+	SECTION("test quarter frames")
+	{
+		/* 01:02:03:04 at 25 fps, sent as eight nibbles: frames, seconds, 
+		minutes and hours, low nibble first. The last piece carries the rate. */
+
+		const std::vector<unsigned char> pieces = {
+			0x04, 0x10, 0x23, 0x30, 0x42, 0x50, 0x61, (1 << 1) | 0x70
+		};
+
+		std::array<int, 8> state = {};
+		midiSync::Timecode tc;
+
+		for (int i=0; i<7; i++)
+			REQUIRE(midiSync::decodeQuarterFrame(pieces[i], state, tc) == false);
+		REQUIRE(midiSync::decodeQuarterFrame(pieces[7], state, tc) == true);
+
+		REQUIRE(tc.rate == 1);
+		REQUIRE(tc.hours == 1);
+		REQUIRE(tc.minutes == 2);
+		REQUIRE(tc.seconds == 3);
+		REQUIRE(tc.frames == 4);
+		REQUIRE(midiSync::toQuarterFrames(tc) == ((3600 + 120 + 3) * 25 + 4) * 4);
+
+		/* High nibbles: 17:59:59:29 at 30 fps. */
+
+		const std::vector<unsigned char> high = {
+			0x0D, 0x11, 0x2B, 0x33, 0x4B, 0x53, 0x61, (3 << 1) | 0x71
+		};
+
+		for (unsigned char data : high)
+			midiSync::decodeQuarterFrame(data, state, tc);
+
+		REQUIRE(tc.rate == 3);
+		REQUIRE(tc.hours == 17);
+		REQUIRE(tc.minutes == 59);
+		REQUIRE(tc.seconds == 59);
+		REQUIRE(tc.frames == 29);
+	}
+
+	SECTION("test full frames")
+	{
+		midiSync::Timecode tc;
+
+		/* 10:20:30:12 at 24 fps, broadcast to all devices. */
+
+		REQUIRE(midiSync::decodeFullFrame({ MIDI_SYSEX, 0x7F, 0x7F, 0x01, 0x01, 
+			(0 << 5) | 10, 20, 30, 12, 0xF7 }, tc) == true);
+		REQUIRE(tc.rate == 0);
+		REQUIRE(tc.hours == 10);
+		REQUIRE(tc.minutes == 20);
+		REQUIRE(tc.seconds == 30);
+		REQUIRE(tc.frames == 12);
+		REQUIRE(midiSync::toQuarterFrames(tc) == (((10 * 60 + 20) * 60 + 30) * 24 + 12) * 4);
+
+		/* 29.97 fps drop frame counts 30 frames per second. */
+
+		REQUIRE(midiSync::decodeFullFrame({ MIDI_SYSEX, 0x7F, 0x00, 0x01, 0x01, 
+			(2 << 5) | 0, 0, 1, 0, 0xF7 }, tc) == true);
+		REQUIRE(tc.rate == 2);
+		REQUIRE(midiSync::toQuarterFrames(tc) == 30 * 4);
+
+		/* Not a full frame: MTC user bits, truncated message. */
+
+		REQUIRE(midiSync::decodeFullFrame({ MIDI_SYSEX, 0x7F, 0x7F, 0x01, 0x02, 
+			0, 0, 0, 0, 0xF7 }, tc) == false);
+		REQUIRE(midiSync::decodeFullFrame({ MIDI_SYSEX, 0x7F, 0x7F, 0x01, 0x01, 
+			0, 0 }, tc) == false);
+	}
+}
@@ -0,0 +1,65 @@
+#include "../src/core/channels/sampleChannel.h"
+#include "../src/core/mixer.h"
+#include "../src/core/audioBuffer.h"
+#include "../src/core/const.h"
+#include <catch.hpp>
+
+
+TEST_CASE("mixer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const int BUFFER_SIZE = 1024;
+
+	SampleChannel ch(false, BUFFER_SIZE, 1, 1);
+
+	SECTION("test bus routing")
+	{
+		mixer::init(BUFFER_SIZE, 4, 2);
+
+		ch.outBus = 0;
+		AudioBuffer& main = mixer::getOutBus(&ch);
+
+		ch.outBus = 3;
+		REQUIRE(&mixer::getOutBus(&ch) != &main);
+		REQUIRE(mixer::getOutBus(&ch).countFrames() == BUFFER_SIZE);
+
+		ch.inBus = 0;
+		const AudioBuffer& first = mixer::getInBus(&ch);
+		REQUIRE(first.isAllocd());
+
+		ch.inBus = 1;
+		REQUIRE(&mixer::getInBus(&ch) != &first);
+		REQUIRE(mixer::getInBus(&ch).isAllocd());
+	}
+
+	SECTION("test bus fallback")
+	{
+		mixer::init(BUFFER_SIZE, 2, 1);
+
+		ch.outBus = 0;
+		AudioBuffer& main = mixer::getOutBus(&ch);
+
+		/* Buses not opened on the device: output goes to the main mix, input 
+		is silent. */
+
+		ch.outBus = 2;
+		REQUIRE(&mixer::getOutBus(&ch) == &main);
+		ch.outBus = -1;
+		REQUIRE(&mixer::getOutBus(&ch) == &main);
+
+		ch.inBus = 1;
+		REQUIRE(!mixer::getInBus(&ch).isAllocd());
+		ch.inBus = -1;
+		REQUIRE(!mixer::getInBus(&ch).isAllocd());
+	}
+
+	SECTION("test no input device")
+	{
+		mixer::init(BUFFER_SIZE, 1, 0);
+
+		ch.inBus = 0;
+		REQUIRE(!mixer::getInBus(&ch).isAllocd());
+	}
+}
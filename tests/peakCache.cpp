@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <dirent.h>
+#include "../src/core/wave.h"
+#include "../src/core/wavePeaks.h"
+#include "../src/core/peakCache.h"
+#include <catch.hpp>
+
+
+TEST_CASE("peakCache")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	static const int   SAMPLE_RATE = 44100;
+	static const int   BUFFER_SIZE = 20000;
+	static const int   CHANNELS    = 2;
+	static const int   BIT_DEPTH   = 32;
+	static const char* AUDIO_PATH  = "tests/resources/peak-cache-test.wav";
+	static const char* CACHE_PATH  = "tests/resources/peak-cache";
+
+	/* Start each section with an empty cache. */
+
+	auto clearCache = []()
+	{
+		DIR* d = opendir(CACHE_PATH);
+		if (d == nullptr)
+			return;
+		while (dirent* e = readdir(d))
+			if (e->d_name[0] != '.')
+				std::remove((std::string(CACHE_PATH) + "/" + e->d_name).c_str());
+		closedir(d);
+	};
+
+	/* Peak files only look at the audio file on disk: any content will do. */
+
+	{
+		std::ifstream src("tests/resources/test.wav", std::ios::binary);
+		std::ofstream dst(AUDIO_PATH, std::ios::binary);
+		dst << src.rdbuf();
+	}
+
+	peakCache::init(CACHE_PATH);
+	clearCache();
+
+	Wave wave(1);
+	wave.alloc(BUFFER_SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, AUDIO_PATH);
+
+	WavePeaks::Levels levels;
+	for (size_t l = 0; l < levels.size(); l++) {
+		levels[l].resize((BUFFER_SIZE + WavePeaks::LEVELS[l] - 1) / WavePeaks::LEVELS[l]);
+		for (size_t i = 0; i < levels[l].size(); i++)
+			levels[l][i] = { -static_cast<float>(i) / levels[l].size(), static_cast<float>(l) / levels.size() };
+	}
+
+	SECTION("test round trip")
+	{
+		peakCache::write(wave, levels);
+
+		WavePeaks::Levels out;
+		Frame             frames;
+		REQUIRE(peakCache::read(AUDIO_PATH, out, frames) == true);
+		REQUIRE(frames == BUFFER_SIZE);
+		for (size_t l = 0; l < levels.size(); l++) {
+			REQUIRE(out[l].size() == levels[l].size());
+			for (size_t i = 0; i < levels[l].size(); i++) {
+				REQUIRE(out[l][i].min == levels[l][i].min);
+				REQUIRE(out[l][i].max == levels[l][i].max);
+			}
+		}
+	}
+
+	SECTION("test audio file changed")
+	{
+		peakCache::write(wave, levels);
+		{
+			std::ofstream f(AUDIO_PATH, std::ios::binary | std::ios::app);
+			f << "more data";
+		}
+
+		WavePeaks::Levels out;
+		Frame             frames;
+		REQUIRE(peakCache::read(AUDIO_PATH, out, frames) == false);
+	}
+
+	SECTION("test edited and logical waves are not stored")
+	{
+		WavePeaks::Levels out;
+		Frame             frames;
+
+		wave.setEdited(true);
+		peakCache::write(wave, levels);
+		REQUIRE(peakCache::read(AUDIO_PATH, out, frames) == false);
+
+		wave.setEdited(false);
+		wave.setLogical(true);
+		peakCache::write(wave, levels);
+		REQUIRE(peakCache::read(AUDIO_PATH, out, frames) == false);
+	}
+
+	clearCache();
+	std::remove(CACHE_PATH);
+	std::remove(AUDIO_PATH);
+}
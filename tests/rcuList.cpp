@@ -90,4 +90,51 @@ TEST_CASE("RCUList")
 		
 		REQUIRE(list.get(0)->id == 16);
 	}
+
+	SECTION("test batch swap")
+	{
+		list.push(std::make_unique<Object>(1));
+		list.push(std::make_unique<Object>(2));
+		list.push(std::make_unique<Object>(3));
+
+		std::vector<std::pair<size_t, std::unique_ptr<Object>>> batch;
+		batch.emplace_back(0, std::make_unique<Object>(10));
+		batch.emplace_back(2, std::make_unique<Object>(30));
+		list.swap(std::move(batch));
+
+		REQUIRE(list.size() == 3);
+		REQUIRE(list.changed == true);
+
+		RCUList<Object>::Lock l(list);
+
+		REQUIRE(list.get(0)->id == 10);
+		REQUIRE(list.get(1)->id == 2);
+		REQUIRE(list.get(2)->id == 30);
+		REQUIRE(list.back()->id == 30);
+	}
+
+	SECTION("test versions")
+	{
+		list.push(std::make_unique<Object>(1));
+		list.push(std::make_unique<Object>(2));
+
+		REQUIRE(list.getVersion() == 2);
+
+		list.swap(std::make_unique<Object>(3), 1);
+
+		REQUIRE(list.getVersion() == 3);
+
+		{
+			RCUList<Object>::Lock l(list);
+
+			auto it = list.begin();
+			REQUIRE(it.getVersion() == 1); // Untouched node keeps its version
+			++it;
+			REQUIRE(it.getVersion() == 3);
+		}
+
+		list.pop(0);
+
+		REQUIRE(list.getVersion() == 4);
+	}
 }
@@ -65,4 +65,51 @@ TEST_CASE("recorder")
 			REQUIRE(recorder::hasActions(/*channel=*/0) == false);
 		}
 	}
+
+	SECTION("Test range queries")
+	{
+		const int       ch = 0;
+		const MidiEvent on  = MidiEvent(MidiEvent::NOTE_ON, 0x00, 0x00);
+		const MidiEvent off = MidiEvent(MidiEvent::NOTE_OFF, 0x00, 0x00);
+
+		recorder::rec(ch, 10, on);
+		recorder::rec(ch, 20, off);
+		recorder::rec(ch, 30, on);
+		recorder::rec(ch, 40, off);
+		recorder::rec(/*ch=*/1, 25, on);
+
+		REQUIRE(recorder::countActions(ch) == 4);
+		REQUIRE(recorder::countActions(ch, MidiEvent::NOTE_ON) == 2);
+		REQUIRE(recorder::countActions(/*ch=*/1) == 1);
+		REQUIRE(recorder::countActions(/*ch=*/2) == 0);
+		REQUIRE(recorder::hasActions(ch, MidiEvent::ENVELOPE) == false);
+
+		std::vector<Action> range = recorder::getActionsInRange(ch, 20, 40);
+		REQUIRE(range.size() == 2);
+		REQUIRE(range[0].frame == 20);
+		REQUIRE(range[1].frame == 30);
+
+		REQUIRE(recorder::getActionsInRange(ch, 41, 100).size() == 0);
+
+		range = recorder::getActionsInRange(ch, 0, 100, MidiEvent::NOTE_OFF);
+		REQUIRE(range.size() == 2);
+		REQUIRE(range[0].frame == 20);
+		REQUIRE(range[1].frame == 40);
+		REQUIRE(recorder::getActionsInRange(ch, 0, 100, MidiEvent::ENVELOPE).size() == 0);
+
+		REQUIRE(recorder::getClosestActionBefore(ch, 29, MidiEvent::NOTE_ON).frame == 10);
+		REQUIRE(recorder::getClosestActionBefore(ch, 30, MidiEvent::NOTE_ON).frame == 30);
+		REQUIRE(recorder::getClosestActionBefore(ch, 5, MidiEvent::NOTE_ON).isValid() == false);
+		REQUIRE(recorder::getClosestActionAfter(ch, 10, MidiEvent::NOTE_ON).frame == 30);
+		REQUIRE(recorder::getClosestActionAfter(ch, 30, MidiEvent::NOTE_ON).isValid() == false);
+
+		SECTION("Test index follows deletions")
+		{
+			recorder::clearActions(ch, MidiEvent::NOTE_OFF);
+
+			REQUIRE(recorder::countActions(ch) == 2);
+			REQUIRE(recorder::countActions(ch, MidiEvent::NOTE_OFF) == 0);
+			REQUIRE(recorder::getActionsInRange(ch, 0, 100).size() == 2);
+		}
+	}
 }
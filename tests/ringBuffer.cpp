@@ -0,0 +1,76 @@
+#include <thread>
+#include "../src/core/ringBuffer.h"
+#include <catch.hpp>
+
+
+TEST_CASE("RingBuffer")
+{
+	using namespace giada::m;
+
+	RingBuffer<int> ring(8);
+
+	SECTION("test empty")
+	{
+		int data[4];
+		REQUIRE(ring.countReadable() == 0);
+		REQUIRE(ring.countWritable() == 8);
+		REQUIRE(ring.read(data, 4) == 0);
+	}
+
+	SECTION("test write and read")
+	{
+		int in[]  = { 1, 2, 3, 4, 5 };
+		int out[5];
+
+		REQUIRE(ring.write(in, 5) == 5);
+		REQUIRE(ring.countReadable() == 5);
+		REQUIRE(ring.read(out, 5) == 5);
+		for (int i = 0; i < 5; i++)
+			REQUIRE(out[i] == in[i]);
+	}
+
+	SECTION("test overflow")
+	{
+		int in[10] = { 0 };
+		REQUIRE(ring.write(in, 10) == 8);
+		REQUIRE(ring.countWritable() == 0);
+		REQUIRE(ring.write(in, 1) == 0);
+	}
+
+	SECTION("test wrap around")
+	{
+		int in[]  = { 1, 2, 3, 4, 5, 6 };
+		int out[6];
+
+		ring.write(in, 6);
+		ring.read(out, 6);
+		REQUIRE(ring.write(in, 6) == 6); // Crosses the end of the storage
+		REQUIRE(ring.read(out, 6) == 6);
+		for (int i = 0; i < 6; i++)
+			REQUIRE(out[i] == in[i]);
+	}
+
+	SECTION("test producer and consumer threads")
+	{
+		constexpr int COUNT = 100000;
+
+		std::thread producer([&ring]()
+		{
+			int i = 0;
+			while (i < COUNT)
+				if (ring.write(&i, 1) == 1)
+					i++;
+		});
+
+		bool sorted = true;
+		int  next   = 0;
+		while (next < COUNT) {
+			int v;
+			if (ring.read(&v, 1) == 1)
+				sorted = sorted && v == next++;
+		}
+		producer.join();
+
+		REQUIRE(sorted);
+	}
+}
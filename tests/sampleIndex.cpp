@@ -0,0 +1,56 @@
+#include "../src/core/sampleIndex.h"
+#include <catch.hpp>
+
+
+TEST_CASE("sampleIndex")
+{
+	using namespace giada::m;
+
+	SECTION("test tags from file name")
+	{
+		sampleIndex::Entry e;
+		sampleIndex::parseTags("drum_loop_120bpm_C#m.wav", e);
+		REQUIRE(e.bpm == 120.0f);
+		REQUIRE(e.key == "C#m");
+
+		sampleIndex::Entry e2;
+		sampleIndex::parseTags("Amen Break 136 BPM key E.wav", e2);
+		REQUIRE(e2.bpm == 136.0f);
+		REQUIRE(e2.key == "E");
+
+		sampleIndex::Entry e3;
+		sampleIndex::parseTags("Bass A.wav", e3);  // Single note: too ambiguous
+		REQUIRE(e3.bpm == 0.0f);
+		REQUIRE(e3.key == "");
+	}
+
+	SECTION("test query")
+	{
+		sampleIndex::Query q = sampleIndex::parseQuery("Kick  bpm:120 key:am ch:2 dur<2");
+		REQUIRE(q.words.size() == 1);
+		REQUIRE(q.words[0] == "kick");
+		REQUIRE(q.bpm == 120.0f);
+		REQUIRE(q.key == "Am");
+		REQUIRE(q.channels == 2);
+		REQUIRE(q.maxDuration == 2.0f);
+
+		sampleIndex::Entry e;
+		e.path     = "/samples/Big_Kick_Am.wav";
+		e.frames   = 44100;
+		e.rate     = 44100;
+		e.channels = 2;
+		e.bpm      = 120.0f;
+		e.key      = "Am";
+		REQUIRE(sampleIndex::matches(e, q));
+
+		e.channels = 1;
+		REQUIRE(!sampleIndex::matches(e, q));
+
+		e.channels = 2;
+		e.frames   = 44100 * 3;
+		REQUIRE(!sampleIndex::matches(e, q));
+
+		REQUIRE(!sampleIndex::matches(e, sampleIndex::parseQuery("snare")));
+		REQUIRE(sampleIndex::matches(e, sampleIndex::parseQuery("")));
+	}
+}
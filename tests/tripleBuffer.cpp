@@ -0,0 +1,50 @@
+#include "../src/core/tripleBuffer.h"
+#include <catch.hpp>
+
+
+TEST_CASE("TripleBuffer")
+{
+	using namespace giada::m;
+
+	TripleBuffer<int> buffer;
+
+	SECTION("test nothing published")
+	{
+		REQUIRE(buffer.fetch() == false);
+	}
+
+	SECTION("test publish and fetch")
+	{
+		buffer.getWriteBuffer() = 42;
+		buffer.publish();
+
+		REQUIRE(buffer.fetch() == true);
+		REQUIRE(buffer.get() == 42);
+		REQUIRE(buffer.fetch() == false); // Nothing new
+		REQUIRE(buffer.get() == 42);
+	}
+
+	SECTION("test latest value wins")
+	{
+		for (int i = 0; i < 5; i++) {
+			buffer.getWriteBuffer() = i;
+			buffer.publish();
+		}
+
+		REQUIRE(buffer.fetch() == true);
+		REQUIRE(buffer.get() == 4);
+	}
+
+	SECTION("test read buffer is never written")
+	{
+		buffer.getWriteBuffer() = 1;
+		buffer.publish();
+		buffer.fetch();
+
+		buffer.getWriteBuffer() = 2;
+		buffer.publish();
+		buffer.getWriteBuffer() = 3;
+
+		REQUIRE(buffer.get() == 1);
+	}
+}
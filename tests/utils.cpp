@@ -60,4 +60,18 @@ TEST_CASE("::math")
 	REQUIRE(map( 0.0f, 0.0f, 30.0f, 0.0f, 1.0f) == 0.0f);
 	REQUIRE(map(30.0f, 0.0f, 30.0f, 0.0f, 1.0f) == 1.0f);
 	REQUIRE(map(15.0f, 0.0f, 30.0f, 0.0f, 1.0f) == Approx(0.5f));
+
+	/* 10 frames in 4 parts: 0, 2, 5, 7. */
+
+	REQUIRE(gridFrame(1, 10, 4) == 2);
+	REQUIRE(gridFrame(4, 10, 4) == 10);
+	REQUIRE(gridIndex(4, 10, 4) == 1);
+	REQUIRE(gridIndex(5, 10, 4) == 2);
+	REQUIRE(isOnGrid(7, 10, 4) == true);
+	REQUIRE(isOnGrid(8, 10, 4) == false);
+
+	/* No drift: the last part ends exactly on the span length. */
+
+	REQUIRE(gridFrame(4 * 24, 88199, 4 * 24) == 88199);
+	REQUIRE(isOnGrid(88199, 88199, 4 * 24) == true);
 }
@@ -1,6 +1,11 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
 #include <memory>
+#include <dirent.h>
 #include "../src/core/waveManager.h"
 #include "../src/core/wave.h"
+#include "../src/core/audioBuffer.h"
 #include "../src/core/const.h"
 #include <catch.hpp>
 
@@ -19,6 +24,20 @@ TEST_CASE("waveManager")
 	/* Each SECTION the TEST_CASE is executed from the start. Any code between 
 	this comment and the first SECTION macro is exectuted before each SECTION. */
 
+	/* A synthetic Wave, long enough to be split into several chunks. */
+
+	const int SIZE = 100000;
+
+	auto makeWave = [&]()
+	{
+		std::unique_ptr<Wave> w = waveManager::createEmpty(SIZE, G_CHANNELS, 
+			G_SAMPLE_RATE, "test.wav");
+		for (int i=0; i<SIZE; i++)
+			for (int j=0; j<G_CHANNELS; j++)
+				(*w)[i][j] = std::sin(i * (j + 1) * 0.01f) * 0.5f;
+		return w;
+	};
+
 	SECTION("test creation")
 	{
 		waveManager::Result res = waveManager::createFromFile("tests/resources/test.wav");
@@ -42,6 +61,27 @@ TEST_CASE("waveManager")
 		REQUIRE(wave->isEdited() == false);
 	}
 
+	SECTION("test recording from buffer")
+	{
+		AudioBuffer take;
+		take.alloc(G_BUFFER_SIZE, G_MAX_IO_CHANS);
+		take.clear();
+		take[16][0] = 0.5f;
+
+		float* data = take[0];
+
+		std::unique_ptr<Wave> wave = waveManager::createFromBuffer(take, 
+			G_SAMPLE_RATE, "test.wav");
+
+		REQUIRE(take.isAllocd() == false);
+		REQUIRE(wave->getFrame(0) == data);  // Moved, not copied
+		REQUIRE((*wave)[16][0] == 0.5f);
+		REQUIRE(wave->getRate() == G_SAMPLE_RATE);
+		REQUIRE(wave->getSize() == G_BUFFER_SIZE);
+		REQUIRE(wave->getChannels() == G_CHANNELS);
+		REQUIRE(wave->isLogical() == true);
+	}
+
 	SECTION("test resampling")
 	{
 		waveManager::Result res = waveManager::createFromFile("tests/resources/test.wav");
@@ -55,4 +95,82 @@ TEST_CASE("waveManager")
 		REQUIRE(res.wave->isLogical() == false);
 		REQUIRE(res.wave->isEdited() == false);
 	}
+	SECTION("test chunked resampling")
+	{
+		/* Chunks converted in parallel must give the same result as a single 
+		pass over the whole Wave. */
+
+		for (int rate : { 48000, 22050, 96000 }) {
+			std::unique_ptr<Wave> single  = makeWave();
+			std::unique_ptr<Wave> chunked = makeWave();
+
+			REQUIRE(waveManager::resample(*single, 2, rate, SIZE) == G_RES_OK);
+			REQUIRE(waveManager::resample(*chunked, 2, rate, 4096) == G_RES_OK);
+			REQUIRE(single->getSize() == chunked->getSize());
+
+			float maxDiff = 0.0f;
+			for (int i=0; i<single->getSize(); i++)
+				for (int j=0; j<G_CHANNELS; j++)
+					maxDiff = std::max(maxDiff, std::fabs((*chunked)[i][j] - (*single)[i][j]));
+			REQUIRE(maxDiff < 0.0001f);
+		}
+	}
+
+	SECTION("test resampling cache")
+	{
+		const char* CACHE_PATH = "tests/resources/resample-cache";
+
+		auto listCache = [&]()
+		{
+			std::vector<string> files;
+			DIR* d = opendir(CACHE_PATH);
+			if (d == nullptr)
+				return files;
+			while (dirent* e = readdir(d))
+				if (e->d_name[0] != '.')
+					files.push_back(string(CACHE_PATH) + "/" + e->d_name);
+			closedir(d);
+			return files;
+		};
+
+		auto clearCache = [&]()
+		{
+			for (const string& f : listCache())
+				std::remove(f.c_str());
+		};
+
+		/* Each entry is about 1.6 MB: a 2 MB cache holds one at most. */
+
+		waveManager::setResampleCachePath(CACHE_PATH, 2);
+		clearCache();
+
+		auto resample = [&](int rate)
+		{
+			std::unique_ptr<Wave> w = makeWave();
+			REQUIRE(waveManager::resample(*w, 4, rate) == G_RES_OK);
+			return w;
+		};
+
+		std::unique_ptr<Wave> first = resample(G_SAMPLE_RATE * 2);
+		REQUIRE(listCache().size() == 1);
+
+		/* Cache hit: same data, no new entries. */
+
+		std::unique_ptr<Wave> hit = resample(G_SAMPLE_RATE * 2);
+		REQUIRE(listCache().size() == 1);
+		REQUIRE(hit->getSize() == first->getSize());
+		REQUIRE((*hit)[hit->getSize() / 2][0] == (*first)[first->getSize() / 2][0]);
+
+		/* New entries evict the old ones once the limit is reached. */
+
+		resample(G_SAMPLE_RATE * 2 + 100);
+		resample(G_SAMPLE_RATE * 2 + 200);
+		std::vector<string> files = listCache();
+		REQUIRE(files.size() == 1);
+		REQUIRE(files[0].find(std::to_string(G_SAMPLE_RATE * 2 + 200)) != string::npos);
+
+		clearCache();
+		std::remove(CACHE_PATH);
+		waveManager::setResampleCachePath("");
+	}
 }
@@ -0,0 +1,74 @@
+#include "../src/core/wave.h"
+#include "../src/core/wavePeaks.h"
+#include <catch.hpp>
+
+
+TEST_CASE("WavePeaks")
+{
+	using namespace giada::m;
+
+	static const int SAMPLE_RATE = 44100;
+	static const int BUFFER_SIZE = 20000;
+	static const int CHANNELS    = 2;
+	static const int BIT_DEPTH   = 32;
+
+	/* Each frame holds a triangle ramp in [-1.0, 1.0], with the same value on 
+	both channels so that the channel average is the value itself. */
+
+	Wave wave(1);
+	wave.alloc(BUFFER_SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/sample.wav");
+	for (int i=0; i<BUFFER_SIZE; i++)
+		for (int j=0; j<CHANNELS; j++)
+			wave[i][j] = ((i % 1000) / 500.0f) - 1.0f;
+
+	/* Build levels directly: no background worker involved. */
+
+	WavePeaks::Levels levels;
+	WavePeaks::resize(levels, BUFFER_SIZE);
+	WavePeaks::build(wave, 0, BUFFER_SIZE, levels);
+
+	SECTION("test range below finest level")
+	{
+		WavePeaks::Peak p;
+		REQUIRE(WavePeaks::find(levels, 0, WavePeaks::LEVELS[0] - 1, p) == false);
+	}
+
+	SECTION("test peaks match a direct scan")
+	{
+		for (int size : { 64, 100, 300, 1000, 5000, 20000 }) {
+			for (int a=0; a + size <= BUFFER_SIZE; a += size) {
+				WavePeaks::Peak p;
+				REQUIRE(WavePeaks::find(levels, a, a + size, p) == true);
+
+				/* Blocks may exceed the range at the edges: peaks found must 
+				include the real ones. */
+
+				float min = 0.0f;
+				float max = 0.0f;
+				for (int i=a; i<a+size; i++) {
+					min = std::min(min, wave[i][0]);
+					max = std::max(max, wave[i][0]);
+				}
+				REQUIRE(p.min <= min);
+				REQUIRE(p.max >= max);
+			}
+		}
+	}
+
+	SECTION("test partial rebuild")
+	{
+		for (int i=0; i<BUFFER_SIZE; i++)
+			for (int j=0; j<CHANNELS; j++)
+				wave[i][j] = 0.0f;
+
+		WavePeaks::build(wave, 5000, 6000, levels);
+
+		WavePeaks::Peak p;
+		WavePeaks::find(levels, 0, BUFFER_SIZE, p);
+		REQUIRE(p.min == -1.0f);  // Untouched ranges keep their peaks
+
+		WavePeaks::find(levels, 5000, 6000, p);  // Recomputed
+		REQUIRE(p.min == 0.0f);
+		REQUIRE(p.max == 0.0f);
+	}
+}